@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFAlphaMask.h"
+
+#if WITH_CEF3
+
+#include "CEF/ChromiumCEFDirtyRegion.h"
+
+FChromiumCEFAlphaMask::FChromiumCEFAlphaMask()
+	: bEnabled(false)
+	, bValid(false)
+	, Width(0)
+	, Height(0)
+	, BlocksX(0)
+	, BlocksY(0)
+{
+}
+
+void FChromiumCEFAlphaMask::SetEnabled(bool bInEnabled)
+{
+	if (bEnabled == bInEnabled)
+	{
+		return;
+	}
+
+	bEnabled = bInEnabled;
+	bValid = false;
+	Width = Height = 0;
+	BlocksX = BlocksY = 0;
+	Blocks.Empty();
+}
+
+void FChromiumCEFAlphaMask::Update(const FChromiumCEFDirtyRegion& DirtyRegion, int32 InWidth, int32 InHeight, const void* Buffer)
+{
+	if (!bEnabled || Buffer == nullptr || InWidth <= 0 || InHeight <= 0)
+	{
+		return;
+	}
+
+	const uint8* Pixels = static_cast<const uint8*>(Buffer);
+
+	// A resize (or the first paint after enabling) invalidates every block, regardless of what CEF reports as dirty.
+	if (!bValid || InWidth != Width || InHeight != Height)
+	{
+		Width = InWidth;
+		Height = InHeight;
+		BlocksX = FMath::DivideAndRoundUp(Width, BlockSize);
+		BlocksY = FMath::DivideAndRoundUp(Height, BlockSize);
+		Blocks.SetNumUninitialized(BlocksX * BlocksY, false);
+		UpdateBlocks(FIntRect(0, 0, Width, Height), Pixels);
+		bValid = true;
+		return;
+	}
+
+	if (DirtyRegion.IsFullFrame())
+	{
+		UpdateBlocks(FIntRect(0, 0, Width, Height), Pixels);
+	}
+	else
+	{
+		for (const FIntRect& Rect : DirtyRegion.GetRects())
+		{
+			UpdateBlocks(Rect, Pixels);
+		}
+	}
+}
+
+bool FChromiumCEFAlphaMask::GetAlpha(int32 X, int32 Y, uint8& OutAlpha) const
+{
+	if (!bEnabled || !bValid)
+	{
+		return false;
+	}
+
+	if (X < 0 || X >= Width || Y < 0 || Y >= Height)
+	{
+		OutAlpha = 0;
+		return true;
+	}
+
+	OutAlpha = Blocks[(Y / BlockSize) * BlocksX + (X / BlockSize)];
+	return true;
+}
+
+void FChromiumCEFAlphaMask::UpdateBlocks(const FIntRect& Rect, const uint8* Pixels)
+{
+	// Widen the rect to whole blocks, as a partially dirty block still needs all of its pixels to find its maximum.
+	const int32 MinBlockX = FMath::Max(Rect.Min.X, 0) / BlockSize;
+	const int32 MinBlockY = FMath::Max(Rect.Min.Y, 0) / BlockSize;
+	const int32 MaxBlockX = FMath::Min(FMath::DivideAndRoundUp(Rect.Max.X, BlockSize), BlocksX);
+	const int32 MaxBlockY = FMath::Min(FMath::DivideAndRoundUp(Rect.Max.Y, BlockSize), BlocksY);
+	const int32 Pitch = Width * 4;
+
+	for (int32 BlockY = MinBlockY; BlockY < MaxBlockY; ++BlockY)
+	{
+		uint8* BlockRow = Blocks.GetData() + BlockY * BlocksX;
+		for (int32 BlockX = MinBlockX; BlockX < MaxBlockX; ++BlockX)
+		{
+			BlockRow[BlockX] = 0;
+		}
+
+		const int32 EndY = FMath::Min((BlockY + 1) * BlockSize, Height);
+		const int32 EndX = FMath::Min(MaxBlockX * BlockSize, Width);
+		for (int32 Y = BlockY * BlockSize; Y < EndY; ++Y)
+		{
+			// BGRA, so alpha is the fourth byte of every pixel
+			const uint8* Alpha = Pixels + Y * Pitch + MinBlockX * BlockSize * 4 + 3;
+			for (int32 X = MinBlockX * BlockSize; X < EndX; ++X, Alpha += 4)
+			{
+				uint8& BlockAlpha = BlockRow[X / BlockSize];
+				BlockAlpha = FMath::Max(BlockAlpha, *Alpha);
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+class FChromiumCEFDirtyRegion;
+
+/**
+ * A downsampled copy of the alpha channel of a browser's software paints, used for hit testing transparent pages
+ * without reading the texture back from the GPU.
+ * Each entry stores the highest alpha value of a BlockSize x BlockSize block of pixels, and only the blocks touched by the
+ * dirty region of a paint are recomputed.
+ */
+class FChromiumCEFAlphaMask
+{
+public:
+	/** Width and height, in pixels, of the block covered by a single mask entry. */
+	static const int32 BlockSize = 4;
+
+	FChromiumCEFAlphaMask();
+
+	/** Enables or disables the mask. Disabling releases its memory, enabling starts from a full rebuild on the next paint. */
+	void SetEnabled(bool bInEnabled);
+
+	/** @return true if the mask is kept up to date on paint. */
+	bool IsEnabled() const { return bEnabled; }
+
+	/**
+	 * Updates the blocks covered by the dirty region of a paint.
+	 *
+	 * @param DirtyRegion The merged dirty rectangles of the paint.
+	 * @param Width Width of the painted buffer.
+	 * @param Height Height of the painted buffer.
+	 * @param Buffer The BGRA pixel data of the painted buffer.
+	 */
+	void Update(const FChromiumCEFDirtyRegion& DirtyRegion, int32 Width, int32 Height, const void* Buffer);
+
+	/**
+	 * Looks up the alpha around a pixel.
+	 *
+	 * @param X Horizontal pixel position in the painted buffer.
+	 * @param Y Vertical pixel position in the painted buffer.
+	 * @param OutAlpha The highest alpha of the block containing the pixel.
+	 * @return false if the mask has not been built yet.
+	 */
+	bool GetAlpha(int32 X, int32 Y, uint8& OutAlpha) const;
+
+private:
+	/** Recomputes the mask entries for the blocks overlapping a rectangle of the painted buffer. */
+	void UpdateBlocks(const FIntRect& Rect, const uint8* Pixels);
+
+	/** Whether the mask is kept up to date. */
+	bool bEnabled;
+
+	/** Whether the mask covers a complete paint. */
+	bool bValid;
+
+	/** Size of the painted buffer the mask was built for. */
+	int32 Width;
+	int32 Height;
+
+	/** Size of the mask in blocks. */
+	int32 BlocksX;
+	int32 BlocksY;
+
+	/** Highest alpha per block, row major. */
+	TArray<uint8> Blocks;
+};
+
+#endif
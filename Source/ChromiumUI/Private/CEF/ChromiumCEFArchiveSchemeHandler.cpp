@@ -0,0 +1,367 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFArchiveSchemeHandler.h"
+
+#if WITH_CEF3
+
+#include "Async/MappedFileHandle.h"
+#include "ChromiumWebBrowserLog.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/LargeMemoryReader.h"
+
+namespace
+{
+	const uint32 ArchiveMagic = 0x41495543; // "CUIA"
+	const uint32 ArchiveVersion = 1;
+	const int64 ArchiveHeaderSize = sizeof(uint32) * 2 + sizeof(int64) * 2;
+	const int64 ArchiveAlignment = 16;
+
+	const TCHAR* GetMimeTypeForExtension(const FString& Extension)
+	{
+		static const TMap<FString, const TCHAR*> MimeTypes =
+		{
+			{ TEXT("html"), TEXT("text/html") },
+			{ TEXT("htm"), TEXT("text/html") },
+			{ TEXT("js"), TEXT("text/javascript") },
+			{ TEXT("mjs"), TEXT("text/javascript") },
+			{ TEXT("css"), TEXT("text/css") },
+			{ TEXT("json"), TEXT("application/json") },
+			{ TEXT("map"), TEXT("application/json") },
+			{ TEXT("txt"), TEXT("text/plain") },
+			{ TEXT("xml"), TEXT("text/xml") },
+			{ TEXT("svg"), TEXT("image/svg+xml") },
+			{ TEXT("png"), TEXT("image/png") },
+			{ TEXT("jpg"), TEXT("image/jpeg") },
+			{ TEXT("jpeg"), TEXT("image/jpeg") },
+			{ TEXT("gif"), TEXT("image/gif") },
+			{ TEXT("webp"), TEXT("image/webp") },
+			{ TEXT("ico"), TEXT("image/x-icon") },
+			{ TEXT("woff"), TEXT("font/woff") },
+			{ TEXT("woff2"), TEXT("font/woff2") },
+			{ TEXT("ttf"), TEXT("font/ttf") },
+			{ TEXT("otf"), TEXT("font/otf") },
+			{ TEXT("wasm"), TEXT("application/wasm") },
+			{ TEXT("mp3"), TEXT("audio/mpeg") },
+			{ TEXT("ogg"), TEXT("audio/ogg") },
+			{ TEXT("wav"), TEXT("audio/wav") },
+			{ TEXT("mp4"), TEXT("video/mp4") },
+			{ TEXT("webm"), TEXT("video/webm") },
+		};
+
+		const TCHAR* const* MimeType = MimeTypes.Find(Extension);
+		return MimeType ? *MimeType : TEXT("application/octet-stream");
+	}
+
+	/** @return The path within the archive a URL asks for. */
+	FString GetArchivePath(const FString& Url)
+	{
+		FString Path;
+		const int32 SchemeEnd = Url.Find(TEXT("://"));
+		const int32 PathStart = SchemeEnd == INDEX_NONE ? INDEX_NONE : Url.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, SchemeEnd + 3);
+		if (PathStart != INDEX_NONE)
+		{
+			Path = Url.Mid(PathStart + 1);
+			int32 PathEnd = INDEX_NONE;
+			if (Path.FindChar(TEXT('?'), PathEnd) || Path.FindChar(TEXT('#'), PathEnd))
+			{
+				Path.LeftInline(PathEnd, false);
+			}
+			Path = FGenericPlatformHttp::UrlDecode(Path);
+		}
+
+		if (Path.IsEmpty() || Path.EndsWith(TEXT("/")))
+		{
+			Path += TEXT("index.html");
+		}
+		return Path;
+	}
+
+	FAutoConsoleCommand PackArchiveCommand(
+		TEXT("ChromiumUI.PackArchive"),
+		TEXT("Packs a directory of web UI files into an archive browsers can serve without loading the files. Arguments: SourceDirectory ArchiveFilename"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() != 2)
+			{
+				UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Usage: ChromiumUI.PackArchive SourceDirectory ArchiveFilename"));
+				return;
+			}
+			FChromiumCEFArchive::Pack(Args[0], Args[1]);
+		}));
+}
+
+/** Serves one request from an archive, straight out of its mapping. */
+class FChromiumCEFArchiveResourceHandler
+	: public CefResourceHandler
+{
+public:
+	explicit FChromiumCEFArchiveResourceHandler(const TSharedRef<FChromiumCEFArchive, ESPMode::ThreadSafe>& InArchive)
+		: Archive(InArchive)
+	{
+	}
+
+	// Begin CefResourceHandler interface.
+	virtual bool Open(CefRefPtr<CefRequest> Request, bool& bHandleRequest, CefRefPtr<CefCallback> Callback) override
+	{
+		Entry = Archive->Find(GetArchivePath(WCHAR_TO_TCHAR(Request->GetURL().ToWString().c_str())));
+		Position = 0;
+		bHandleRequest = true;
+		return true;
+	}
+
+	virtual void GetResponseHeaders(CefRefPtr<CefResponse> Response, int64& ResponseLength, CefString& RedirectUrl) override
+	{
+		if (Entry == nullptr)
+		{
+			Response->SetStatus(404);
+			Response->SetStatusText("Not Found");
+			ResponseLength = 0;
+			return;
+		}
+
+		// CEF answers Range requests itself, by calling Skip and reading no further than the range
+		Response->SetStatus(200);
+		Response->SetStatusText("OK");
+		Response->SetMimeType(Archive->GetMimeType(*Entry));
+		Response->SetHeaderByName("Accept-Ranges", "bytes", true);
+		ResponseLength = Entry->Size;
+	}
+
+	virtual bool Skip(int64 BytesToSkip, int64& BytesSkipped, CefRefPtr<CefResourceSkipCallback> Callback) override
+	{
+		const int64 Remaining = Entry ? Entry->Size - Position : 0;
+		if (BytesToSkip > Remaining)
+		{
+			BytesSkipped = ERR_REQUEST_RANGE_NOT_SATISFIABLE;
+			return false;
+		}
+		Position += BytesToSkip;
+		BytesSkipped = BytesToSkip;
+		return true;
+	}
+
+	virtual bool Read(void* DataOut, int BytesToRead, int& BytesRead, CefRefPtr<CefResourceReadCallback> Callback) override
+	{
+		const int64 Remaining = Entry ? Entry->Size - Position : 0;
+		if (Remaining <= 0)
+		{
+			BytesRead = 0;
+			return false;
+		}
+
+		BytesRead = (int)FMath::Min<int64>(BytesToRead, Remaining);
+		FMemory::Memcpy(DataOut, Archive->GetData(*Entry) + Position, BytesRead);
+		Position += BytesRead;
+		return true;
+	}
+
+	virtual void Cancel() override
+	{
+		Entry = nullptr;
+	}
+	// End CefResourceHandler interface.
+
+private:
+	TSharedRef<FChromiumCEFArchive, ESPMode::ThreadSafe> Archive;
+	const FChromiumCEFArchive::FEntry* Entry = nullptr;
+	int64 Position = 0;
+
+	// Include CEF ref counting.
+	IMPLEMENT_REFCOUNTING(FChromiumCEFArchiveResourceHandler);
+};
+
+class FChromiumCEFArchiveSchemeHandlerFactory
+	: public CefSchemeHandlerFactory
+{
+public:
+	explicit FChromiumCEFArchiveSchemeHandlerFactory(const TSharedRef<FChromiumCEFArchive, ESPMode::ThreadSafe>& InArchive)
+		: Archive(InArchive)
+	{
+	}
+
+	// Begin CefSchemeHandlerFactory interface.
+	virtual CefRefPtr<CefResourceHandler> Create(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, const CefString& Scheme, CefRefPtr<CefRequest> Request) override
+	{
+		return new FChromiumCEFArchiveResourceHandler(Archive);
+	}
+	// End CefSchemeHandlerFactory interface.
+
+private:
+	TSharedRef<FChromiumCEFArchive, ESPMode::ThreadSafe> Archive;
+
+	// Include CEF ref counting.
+	IMPLEMENT_REFCOUNTING(FChromiumCEFArchiveSchemeHandlerFactory);
+};
+
+FChromiumCEFArchive::~FChromiumCEFArchive()
+{
+	// The region has to be unmapped before the file it maps is closed
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TSharedPtr<FChromiumCEFArchive, ESPMode::ThreadSafe> FChromiumCEFArchive::Open(const FString& Filename)
+{
+	TSharedRef<FChromiumCEFArchive, ESPMode::ThreadSafe> Archive = MakeShareable(new FChromiumCEFArchive());
+
+	Archive->MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (Archive->MappedFile.IsValid())
+	{
+		Archive->MappedRegion.Reset(Archive->MappedFile->MapRegion());
+	}
+	if (Archive->MappedRegion.IsValid())
+	{
+		Archive->Data = Archive->MappedRegion->GetMappedPtr();
+		Archive->DataSize = Archive->MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		Archive->MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(Archive->LoadedFile, *Filename))
+		{
+			UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Could not open web UI archive %s."), *Filename);
+			return nullptr;
+		}
+		Archive->Data = Archive->LoadedFile.GetData();
+		Archive->DataSize = Archive->LoadedFile.Num();
+	}
+
+	if (!Archive->ReadIndex(Filename))
+	{
+		return nullptr;
+	}
+
+	UE_LOG(ChromiumLogWebBrowser, Log, TEXT("Opened web UI archive %s, %d files in %.1f MB%s."),
+		*Filename, Archive->Entries.Num(), Archive->DataSize / (1024.0 * 1024.0), Archive->MappedRegion.IsValid() ? TEXT(", memory mapped") : TEXT(""));
+	return Archive;
+}
+
+bool FChromiumCEFArchive::ReadIndex(const FString& Filename)
+{
+	if (DataSize < ArchiveHeaderSize)
+	{
+		UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("%s is not a web UI archive."), *Filename);
+		return false;
+	}
+
+	FLargeMemoryReader HeaderReader(Data, ArchiveHeaderSize);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int64 IndexOffset = 0;
+	int64 IndexSize = 0;
+	HeaderReader << Magic << Version << IndexOffset << IndexSize;
+	if (Magic != ArchiveMagic || Version != ArchiveVersion || IndexOffset < ArchiveHeaderSize || IndexSize < 0 || IndexOffset + IndexSize > DataSize)
+	{
+		UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("%s is not a web UI archive of version %u."), *Filename, ArchiveVersion);
+		return false;
+	}
+
+	FLargeMemoryReader IndexReader(Data + IndexOffset, IndexSize);
+	TArray<FString> MimeTypeNames;
+	int32 EntryCount = 0;
+	IndexReader << MimeTypeNames << EntryCount;
+
+	MimeTypes.Reserve(MimeTypeNames.Num());
+	for (const FString& MimeType : MimeTypeNames)
+	{
+		MimeTypes.Add(TCHAR_TO_WCHAR(*MimeType));
+	}
+
+	Entries.Reserve(FMath::Max(EntryCount, 0));
+	for (int32 Index = 0; Index < EntryCount && !IndexReader.IsError(); ++Index)
+	{
+		FString Path;
+		FEntry Entry;
+		IndexReader << Path << Entry.MimeType << Entry.Offset << Entry.Size;
+		if (!MimeTypes.IsValidIndex(Entry.MimeType) || Entry.Offset < ArchiveHeaderSize || Entry.Size < 0 || Entry.Offset + Entry.Size > IndexOffset)
+		{
+			IndexReader.SetError();
+			break;
+		}
+		Entries.Add(MoveTemp(Path), Entry);
+	}
+
+	if (IndexReader.IsError())
+	{
+		UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("The index of web UI archive %s is damaged."), *Filename);
+		return false;
+	}
+	return true;
+}
+
+bool FChromiumCEFArchive::Pack(const FString& SourceDirectory, const FString& Filename)
+{
+	const FString Root = FPaths::ConvertRelativePathToFull(SourceDirectory) / TEXT("");
+	TArray<FString> Files;
+	IFileManager::Get().FindFilesRecursive(Files, *Root, TEXT("*"), true, false);
+	Files.Sort();
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Could not create web UI archive %s."), *Filename);
+		return false;
+	}
+
+	uint32 Magic = ArchiveMagic;
+	uint32 Version = ArchiveVersion;
+	int64 IndexOffset = 0;
+	int64 IndexSize = 0;
+	*Writer << Magic << Version << IndexOffset << IndexSize;
+
+	TArray<FString> MimeTypeNames;
+	TArray<TPair<FString, FEntry>> PackedEntries;
+	TArray<uint8> Contents;
+	for (const FString& File : Files)
+	{
+		if (!FFileHelper::LoadFileToArray(Contents, *File))
+		{
+			UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Could not read %s, it is left out of web UI archive %s."), *File, *Filename);
+			continue;
+		}
+
+		// Padding keeps every file aligned in the mapping
+		const int64 Padding = Align(Writer->Tell(), ArchiveAlignment) - Writer->Tell();
+		uint8 Zeros[ArchiveAlignment] = {};
+		Writer->Serialize(Zeros, Padding);
+
+		FEntry Entry;
+		Entry.Offset = Writer->Tell();
+		Entry.Size = Contents.Num();
+		Entry.MimeType = MimeTypeNames.AddUnique(GetMimeTypeForExtension(FPaths::GetExtension(File).ToLower()));
+		Writer->Serialize(Contents.GetData(), Contents.Num());
+
+		FString Path = File;
+		Path.RemoveFromStart(Root);
+		PackedEntries.Emplace(MoveTemp(Path), Entry);
+	}
+
+	IndexOffset = Writer->Tell();
+	int32 EntryCount = PackedEntries.Num();
+	*Writer << MimeTypeNames << EntryCount;
+	for (TPair<FString, FEntry>& PackedEntry : PackedEntries)
+	{
+		*Writer << PackedEntry.Key << PackedEntry.Value.MimeType << PackedEntry.Value.Offset << PackedEntry.Value.Size;
+	}
+	IndexSize = Writer->Tell() - IndexOffset;
+
+	Writer->Seek(0);
+	*Writer << Magic << Version << IndexOffset << IndexSize;
+
+	const bool bSuccess = Writer->Close() && !Writer->IsError();
+	UE_LOG(ChromiumLogWebBrowser, Log, TEXT("Packed %d files of %s into web UI archive %s%s."),
+		PackedEntries.Num(), *Root, *Filename, bSuccess ? TEXT("") : TEXT(", but writing it failed"));
+	return bSuccess;
+}
+
+CefRefPtr<CefSchemeHandlerFactory> FChromiumCEFArchive::CreateSchemeHandlerFactory(const TSharedRef<FChromiumCEFArchive, ESPMode::ThreadSafe>& Archive)
+{
+	return new FChromiumCEFArchiveSchemeHandlerFactory(Archive);
+}
+
+#endif
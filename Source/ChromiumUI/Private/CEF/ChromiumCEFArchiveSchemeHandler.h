@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+#include "CEF/ChromiumCEFSchemeHandler.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * A packed archive of web UI files, memory mapped once and served by FChromiumCEFArchive::CreateSchemeHandlerFactory.
+ *
+ * Responses are read straight out of the mapping into the buffers CEF hands to CefResourceHandler::Read, there are no
+ * per request file reads or copies in between. Byte ranges are served by moving the read position, so Range requests cost
+ * nothing more than the bytes they ask for.
+ *
+ * The archive starts with a header pointing at the index, which is written after the file data:
+ *   uint32 Magic, uint32 Version, int64 IndexOffset, int64 IndexSize
+ *   file data, each file 16 byte aligned
+ *   TArray<FString> MimeTypes, then int32 EntryCount and per entry FString Path, int32 MimeType, int64 Offset, int64 Size
+ * MIME types are worked out when packing, so serving a file never looks at its extension.
+ */
+class FChromiumCEFArchive
+{
+public:
+	struct FEntry
+	{
+		int64 Offset;
+		int64 Size;
+		int32 MimeType;
+	};
+
+	~FChromiumCEFArchive();
+
+	/**
+	 * Maps an archive and reads its index.
+	 *
+	 * @param Filename The archive, as written by Pack.
+	 * @return The archive, or null if it could not be opened or is not an archive.
+	 */
+	static TSharedPtr<FChromiumCEFArchive, ESPMode::ThreadSafe> Open(const FString& Filename);
+
+	/**
+	 * Packs every file below a directory into an archive, with paths relative to the directory.
+	 *
+	 * @return false if the archive could not be written.
+	 */
+	static bool Pack(const FString& SourceDirectory, const FString& Filename);
+
+	/** @return The file at a path within the archive, null if there is none. */
+	const FEntry* Find(const FString& Path) const
+	{
+		return Entries.Find(Path);
+	}
+
+	/** @return The contents of a file, valid as long as the archive is. */
+	const uint8* GetData(const FEntry& Entry) const
+	{
+		return Data + Entry.Offset;
+	}
+
+	const CefString& GetMimeType(const FEntry& Entry) const
+	{
+		return MimeTypes[Entry.MimeType];
+	}
+
+	/**
+	 * Creates a CEF scheme handler factory serving the files of an archive. The URL path, without its query, is the path within
+	 * the archive, and paths ending in / serve their index.html.
+	 */
+	static CefRefPtr<CefSchemeHandlerFactory> CreateSchemeHandlerFactory(const TSharedRef<FChromiumCEFArchive, ESPMode::ThreadSafe>& Archive);
+
+private:
+	FChromiumCEFArchive() = default;
+
+	bool ReadIndex(const FString& Filename);
+
+	/** Either the mapping, or the file loaded into memory on platforms that can not map files. */
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> LoadedFile;
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+
+	TMap<FString, FEntry> Entries;
+	TArray<CefString> MimeTypes;
+};
+
+#endif
@@ -15,8 +15,8 @@ static FAutoConsoleVariableRef CVarCEFGPUAcceleration(
 	ECVF_Default);
 
 FChromiumCEFBrowserApp::FChromiumCEFBrowserApp()
-	: MessagePumpCountdown(0)
 {
+	MessagePump.LoadConfig();
 }
 
 void FChromiumCEFBrowserApp::OnBeforeChildProcessLaunch(CefRefPtr<CefCommandLine> CommandLine)
@@ -43,6 +43,37 @@ void FChromiumCEFBrowserApp::OnBeforeCommandLineProcessing(const CefString& Proc
 #if PLATFORM_MAC
 	CommandLine->AppendSwitch("use-mock-keychain"); // Disable the toolchain prompt on macOS.
 #endif
+
+	// Child processes get the process model from the browser process
+	if (ProcessType.empty())
+	{
+		if (ProcessModel.bProcessPerSite)
+		{
+			CommandLine->AppendSwitch("process-per-site");
+		}
+		if (ProcessModel.RendererProcessLimit > 0)
+		{
+			CommandLine->AppendSwitchWithValue("renderer-process-limit", TCHAR_TO_WCHAR(*FString::FromInt(ProcessModel.RendererProcessLimit)));
+		}
+		switch (ProcessModel.SiteIsolation)
+		{
+		case EChromiumSiteIsolation::Disabled:
+			CommandLine->AppendSwitch("disable-site-isolation-trials");
+			break;
+		case EChromiumSiteIsolation::SitePerProcess:
+			CommandLine->AppendSwitch("site-per-process");
+			break;
+		default:
+			break;
+		}
+		if (ProcessModel.IsolatedOrigins.Num() > 0)
+		{
+			CommandLine->AppendSwitchWithValue("isolate-origins", TCHAR_TO_WCHAR(*FString::Join(ProcessModel.IsolatedOrigins, TEXT(","))));
+		}
+
+		UE_LOG(ChromiumLogCEFBrowser, Log, TEXT("CEF process model: process per site %s, renderer process limit %d, site isolation %d, %d isolated origins"),
+			ProcessModel.bProcessPerSite ? TEXT("on") : TEXT("off"), ProcessModel.RendererProcessLimit, (int32)ProcessModel.SiteIsolation, ProcessModel.IsolatedOrigins.Num());
+	}
 }
 
 void FChromiumCEFBrowserApp::OnRenderProcessThreadCreated(CefRefPtr<CefListValue> ExtraInfo)
@@ -52,46 +83,7 @@ void FChromiumCEFBrowserApp::OnRenderProcessThreadCreated(CefRefPtr<CefListValue
 
 void FChromiumCEFBrowserApp::OnScheduleMessagePumpWork(int64 delay_ms)
 {
-	FScopeLock Lock(&MessagePumpCountdownCS);
-
-	// As per CEF documentation, if delay_ms is <= 0, then the call to CefDoMessageLoopWork should happen reasonably soon.  If delay_ms is > 0, then the call
-	//  to CefDoMessageLoopWork should be scheduled to happen after the specified delay and any currently pending scheduled call should be canceled.
-	if(delay_ms < 0)
-	{
-		delay_ms = 0;
-	}
-	MessagePumpCountdown = delay_ms;
-}
-
-bool FChromiumCEFBrowserApp::TickMessagePump(float DeltaTime, bool bForce)
-{
-	bool bPump = false;
-	{
-		FScopeLock Lock(&MessagePumpCountdownCS);
-		
-		// count down in order to call message pump
-		if (MessagePumpCountdown >= 0)
-		{
-			MessagePumpCountdown -= (DeltaTime * 1000);
-			if (MessagePumpCountdown <= 0)
-			{
-				bPump = true;
-			}
-			
-			if (bPump || bForce)
-			{
-				// -1 indicates that no countdown is currently happening
-				MessagePumpCountdown = -1;
-			}
-		}
-	}
-	
-	if (bPump || bForce)
-	{
-		CefDoMessageLoopWork();
-		return true;
-	}
-	return false;
+	MessagePump.ScheduleWork(delay_ms);
 }
 
 #endif
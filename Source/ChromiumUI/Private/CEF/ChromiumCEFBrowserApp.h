@@ -4,10 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "Misc/ScopeLock.h"
+#include "ChromiumWebBrowserModule.h"
 
 #if WITH_CEF3
 
 #include "ChromiumCEFLibCefIncludes.h"
+#include "ChromiumCEFMessagePumpScheduler.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(ChromiumLogCEFBrowser, Log, All);
 
@@ -24,6 +26,12 @@ public:
 	 */
 	FChromiumCEFBrowserApp();
 
+	/** Selects how pages are assigned to render processes. Must be set before CefInitialize. */
+	void SetProcessModel(const FChromiumBrowserProcessModelSettings& InProcessModel)
+	{
+		ProcessModel = InProcessModel;
+	}
+
 	/** A delegate this is invoked when an existing browser requests creation of a new browser window. */
 	DECLARE_DELEGATE_OneParam(FOnRenderProcessThreadCreated, CefRefPtr<CefListValue> /*ExtraInfo*/);
 	virtual FOnRenderProcessThreadCreated& OnRenderProcessThreadCreated()
@@ -31,8 +39,11 @@ public:
 		return RenderProcessThreadCreatedDelegate;
 	}
 
-	/** Used to pump the CEF message loop whenever OnScheduleMessagePumpWork is triggered */
-	bool TickMessagePump(float DeltaTime, bool bForce);
+	/** The scheduler that pumps the CEF message loop whenever OnScheduleMessagePumpWork asks for it */
+	FChromiumCEFMessagePumpScheduler& GetMessagePump()
+	{
+		return MessagePump;
+	}
 
 private:
 	// CefApp methods.
@@ -45,12 +56,12 @@ private:
 
 	FOnRenderProcessThreadCreated RenderProcessThreadCreatedDelegate;
 
+	/** Process model switches added to the browser process command line. */
+	FChromiumBrowserProcessModelSettings ProcessModel;
+
 	// Include the default reference counting implementation.
 	IMPLEMENT_REFCOUNTING(FChromiumCEFBrowserApp);
 
-	// Lock for access MessagePumpCountdown
-	FCriticalSection MessagePumpCountdownCS;
-	// Countdown in milliseconds until CefDoMessageLoopWork is called.  Updated by OnScheduleMessagePumpWork
-	int64 MessagePumpCountdown;
+	FChromiumCEFMessagePumpScheduler MessagePump;
 };
 #endif
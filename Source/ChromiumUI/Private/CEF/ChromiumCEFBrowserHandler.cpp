@@ -9,11 +9,15 @@
 
 #include "ChromiumWebBrowserModule.h"
 #include "ChromiumCEFBrowserClosureTask.h"
+#include "ChromiumCEFGameThreadQueue.h"
 #include "IChromiumWebBrowserSingleton.h"
 #include "ChromiumWebBrowserSingleton.h"
 #include "ChromiumCEFBrowserPopupFeatures.h"
 #include "ChromiumCEFWebBrowserWindow.h"
+#include "ChromiumCEFWebBrowserWindowRHIHelper.h"
+#include "ChromiumCEFTextureUploader.h"
 #include "ChromiumCEFBrowserByteResource.h"
+#include "ChromiumCEFRequestRules.h"
 #include "Framework/Application/SlateApplication.h"
 #include "HAL/ThreadingBase.h"
 #include "PlatformHttp.h"
@@ -36,6 +40,12 @@ AltRetryDomains(InAltRetryDomains)
 
 void FChromiumCEFBrowserHandler::OnTitleChange(CefRefPtr<CefBrowser> Browser, const CefString& Title)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, Title]() { OnTitleChange(Browser, Title); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 
 	if (BrowserWindow.IsValid())
@@ -46,6 +56,12 @@ void FChromiumCEFBrowserHandler::OnTitleChange(CefRefPtr<CefBrowser> Browser, co
 
 void FChromiumCEFBrowserHandler::OnAddressChange(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, const CefString& Url)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, Frame, Url]() { OnAddressChange(Browser, Frame, Url); });
+		return;
+	}
+
 	if (Frame->IsMain())
 	{
 		TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
@@ -59,6 +75,13 @@ void FChromiumCEFBrowserHandler::OnAddressChange(CefRefPtr<CefBrowser> Browser,
 
 bool FChromiumCEFBrowserHandler::OnTooltip(CefRefPtr<CefBrowser> Browser, CefString& Text)
 {
+	if (!IsInGameThread())
+	{
+		CefString TextCopy = Text;
+		RunOnGameThread([this, Browser, TextCopy]() mutable { OnTooltip(Browser, TextCopy); });
+		return false;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
 	{
@@ -70,6 +93,12 @@ bool FChromiumCEFBrowserHandler::OnTooltip(CefRefPtr<CefBrowser> Browser, CefStr
 
 bool FChromiumCEFBrowserHandler::OnConsoleMessage(CefRefPtr<CefBrowser> Browser, cef_log_severity_t level, const CefString& Message, const CefString& Source, int Line)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, level, Message, Source, Line]() { OnConsoleMessage(Browser, level, Message, Source, Line); });
+		return false;
+	}
+
 	ConsoleMessageDelegate.ExecuteIfBound(Browser, level, Message, Source, Line);
 	// Return false to let it output to console.
 	return false;
@@ -77,6 +106,12 @@ bool FChromiumCEFBrowserHandler::OnConsoleMessage(CefRefPtr<CefBrowser> Browser,
 
 void FChromiumCEFBrowserHandler::OnAfterCreated(CefRefPtr<CefBrowser> Browser)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser]() { OnAfterCreated(Browser); });
+		return;
+	}
+
 	if(Browser->IsPopup())
 	{
 		TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindowParent = ParentHandler.get() ? ParentHandler->BrowserWindowPtr.Pin() : nullptr;
@@ -110,15 +145,22 @@ void FChromiumCEFBrowserHandler::OnAfterCreated(CefRefPtr<CefBrowser> Browser)
 			Browser->GetHost()->CloseBrowser(true);
 		}
 	}
+	else
+	{
+		BrowserCreatedDelegate.ExecuteIfBound(Browser);
+	}
 }
 
 bool FChromiumCEFBrowserHandler::DoClose(CefRefPtr<CefBrowser> Browser)
 {
-	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
-	if(BrowserWindow.IsValid())
+	RunOnGameThread([this, Browser]()
 	{
-		BrowserWindow->OnBrowserClosing();
-	}
+		TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
+		if(BrowserWindow.IsValid() && BrowserWindow->IsCurrentCefBrowser(Browser))
+		{
+			BrowserWindow->OnBrowserClosing();
+		}
+	});
 #if PLATFORM_WINDOWS
 	// If we have a window handle, we're rendering directly to the screen and not off-screen
 	HWND NativeWindowHandle = Browser->GetHost()->GetWindowHandle();
@@ -144,8 +186,15 @@ bool FChromiumCEFBrowserHandler::DoClose(CefRefPtr<CefBrowser> Browser)
 
 void FChromiumCEFBrowserHandler::OnBeforeClose(CefRefPtr<CefBrowser> Browser)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser]() { OnBeforeClose(Browser); });
+		return;
+	}
+
+	// A browser discarded by its window closes after the window moved on, possibly to a new browser
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
-	if (BrowserWindow.IsValid())
+	if (BrowserWindow.IsValid() && BrowserWindow->IsCurrentCefBrowser(Browser))
 	{
 		BrowserWindow->OnBrowserClosed();
 	}
@@ -162,6 +211,16 @@ bool FChromiumCEFBrowserHandler::OnBeforePopup( CefRefPtr<CefBrowser> Browser,
 	CefBrowserSettings& OutSettings,
 	bool* OutNoJavascriptAccess )
 {
+	if (!IsInGameThread())
+	{
+		bool bSuppressPopup = true;
+		FChromiumCEFGameThreadQueue::RunAndWait([&]()
+		{
+			bSuppressPopup = OnBeforePopup(Browser, Frame, TargetUrl, TargetFrameName, PopupFeatures, OutWindowInfo, OutClient, OutSettings, OutNoJavascriptAccess);
+		});
+		return bSuppressPopup;
+	}
+
 	FString URL = WCHAR_TO_TCHAR(TargetUrl.ToWString().c_str());
 	FString FrameName = WCHAR_TO_TCHAR(TargetFrameName.ToWString().c_str());
 
@@ -188,6 +247,8 @@ bool FChromiumCEFBrowserHandler::OnBeforePopup( CefRefPtr<CefBrowser> Browser,
 		CefRefPtr<FChromiumCEFBrowserHandler> NewHandler(new FChromiumCEFBrowserHandler(shouldUseTransparency));
 		NewHandler->ParentHandler = this;
 		NewHandler->SetPopupFeatures(NewBrowserPopupFeatures);
+		NewHandler->SetContextRequestRules(GetContextRequestRules());
+		NewHandler->SetRequestFilter(GetRequestFilter());
 		OutClient = NewHandler;
 
 		// Always use off screen rendering so we can integrate with our windows
@@ -198,6 +259,10 @@ bool FChromiumCEFBrowserHandler::OnBeforePopup( CefRefPtr<CefBrowser> Browser,
 		OutWindowInfo.SetAsWindowless(kNullWindowHandle);
 #endif
 
+		// Popups are rendered the same way as the browser that opened them
+		TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
+		OutWindowInfo.external_begin_frame_enabled = (BrowserWindow.IsValid() && BrowserWindow->UsingExternalBeginFrame()) ? 1 : 0;
+
 		// We need to rely on CEF to create our window so we set the WindowInfo, BrowserSettings, Client, and then return false
 		return false;
 	}
@@ -221,6 +286,11 @@ void FChromiumCEFBrowserHandler::OnLoadError(CefRefPtr<CefBrowser> Browser,
 	const CefString& ErrorText,
 	const CefString& FailedUrl)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, Frame, InErrorCode, ErrorText, FailedUrl]() { OnLoadError(Browser, Frame, InErrorCode, ErrorText, FailedUrl); });
+		return;
+	}
 
 	// notify browser window
 	if (Frame->IsMain())
@@ -252,6 +322,12 @@ void FChromiumCEFBrowserHandler::OnLoadStart(CefRefPtr<CefBrowser> Browser, CefR
 
 void FChromiumCEFBrowserHandler::OnLoadingStateChange(CefRefPtr<CefBrowser> Browser, bool bIsLoading, bool bCanGoBack, bool bCanGoForward)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, bIsLoading, bCanGoBack, bCanGoForward]() { OnLoadingStateChange(Browser, bIsLoading, bCanGoBack, bCanGoForward); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 
 	if (BrowserWindow.IsValid())
@@ -262,6 +338,18 @@ void FChromiumCEFBrowserHandler::OnLoadingStateChange(CefRefPtr<CefBrowser> Brow
 
 bool FChromiumCEFBrowserHandler::GetRootScreenRect(CefRefPtr<CefBrowser> Browser, CefRect& Rect)
 {
+	if (!IsInGameThread())
+	{
+		// Answered from what the game thread published, CEF's UI thread does not wait on it
+		TSharedPtr<const FViewState, ESPMode::ThreadSafe> State = GetViewState();
+		if (!State.IsValid())
+		{
+			return false;
+		}
+		Rect = State->RootScreenRect;
+		return true;
+	}
+
 	FDisplayMetrics DisplayMetrics;
 	FSlateApplication::Get().GetDisplayMetrics(DisplayMetrics);
 	Rect.width = DisplayMetrics.PrimaryDisplayWidth;
@@ -271,6 +359,22 @@ bool FChromiumCEFBrowserHandler::GetRootScreenRect(CefRefPtr<CefBrowser> Browser
 
 void FChromiumCEFBrowserHandler::GetViewRect(CefRefPtr<CefBrowser> Browser, CefRect& Rect)
 {
+	if (!IsInGameThread())
+	{
+		TSharedPtr<const FViewState, ESPMode::ThreadSafe> State = GetViewState();
+		if (State.IsValid())
+		{
+			Rect = State->ViewRect;
+		}
+		else
+		{
+			// CEF requires at least a 1x1 area for painting
+			Rect.x = Rect.y = 0;
+			Rect.width = Rect.height = 1;
+		}
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 
 	if (BrowserWindow.IsValid())
@@ -291,6 +395,66 @@ void FChromiumCEFBrowserHandler::OnPaint(CefRefPtr<CefBrowser> Browser,
 	const void* Buffer,
 	int Width, int Height)
 {
+	if (!IsInGameThread())
+	{
+		// The buffer is only valid for the duration of this call, so the frame is copied. Paints the game thread has not taken
+		// yet are replaced, keeping a single frame per element type however long the game thread is held up.
+		bool bScheduleDrain = false;
+		{
+			FScopeLock Lock(&PendingPaintsLock);
+			FPendingPaint& Pending = PendingPaints[Type == PET_POPUP ? 1 : 0];
+			const bool bResized = Pending.Width != Width || Pending.Height != Height;
+			if (!Pending.bPending || bResized)
+			{
+				Pending.DirtyRects.clear();
+			}
+			if (bResized)
+			{
+				Pending.DirtyRects.push_back(CefRect(0, 0, Width, Height));
+			}
+			else if (Pending.DirtyRects.size() + DirtyRects.size() > 32)
+			{
+				// The window merges these into a bounded set anyway, the bounds are enough once there are this many
+				CefRect Bounds = DirtyRects.empty() ? Pending.DirtyRects.front() : DirtyRects.front();
+				for (const RectList* List : { &Pending.DirtyRects, &DirtyRects })
+				{
+					for (const CefRect& Rect : *List)
+					{
+						const int32 Right = FMath::Max(Bounds.x + Bounds.width, Rect.x + Rect.width);
+						const int32 Bottom = FMath::Max(Bounds.y + Bounds.height, Rect.y + Rect.height);
+						Bounds.x = FMath::Min(Bounds.x, Rect.x);
+						Bounds.y = FMath::Min(Bounds.y, Rect.y);
+						Bounds.width = Right - Bounds.x;
+						Bounds.height = Bottom - Bounds.y;
+					}
+				}
+				Pending.DirtyRects.clear();
+				Pending.DirtyRects.push_back(Bounds);
+			}
+			else
+			{
+				Pending.DirtyRects.insert(Pending.DirtyRects.end(), DirtyRects.begin(), DirtyRects.end());
+			}
+
+			Pending.Browser = Browser;
+			Pending.Width = Width;
+			Pending.Height = Height;
+			Pending.Pixels.SetNumUninitialized(Width * Height * FChromiumCEFTextureUploader::BytesPerPixel, false);
+			FMemory::Memcpy(Pending.Pixels.GetData(), Buffer, Pending.Pixels.Num());
+			Pending.bPending = true;
+
+			bScheduleDrain = !bPaintDrainScheduled;
+			bPaintDrainScheduled = true;
+		}
+
+		if (bScheduleDrain)
+		{
+			CefRefPtr<FChromiumCEFBrowserHandler> Self(this);
+			RunOnGameThread([Self]() { Self->DrainPendingPaints(); });
+		}
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 
 	if (BrowserWindow.IsValid())
@@ -299,11 +463,56 @@ void FChromiumCEFBrowserHandler::OnPaint(CefRefPtr<CefBrowser> Browser,
 	}
 }
 
+void FChromiumCEFBrowserHandler::DrainPendingPaints()
+{
+	check(IsInGameThread());
+	{
+		// Paints arriving from here on need another drain
+		FScopeLock Lock(&PendingPaintsLock);
+		bPaintDrainScheduled = false;
+	}
+
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(PendingPaints); ++Index)
+	{
+		CefRefPtr<CefBrowser> Browser;
+		RectList DirtyRects;
+		int32 Width;
+		int32 Height;
+		{
+			FScopeLock Lock(&PendingPaintsLock);
+			FPendingPaint& Pending = PendingPaints[Index];
+			if (!Pending.bPending)
+			{
+				continue;
+			}
+			Browser = Pending.Browser;
+			Pending.Browser = nullptr;
+			DirtyRects.swap(Pending.DirtyRects);
+			Swap(DrainedPaintPixels, Pending.Pixels);
+			Width = Pending.Width;
+			Height = Pending.Height;
+			Pending.bPending = false;
+		}
+
+		// The window copies what it keeps into the uploader's staging buffers, so the pixels are free again once it returns
+		OnPaint(Browser, Index == 1 ? PET_POPUP : PET_VIEW, DirtyRects, DrainedPaintPixels.GetData(), Width, Height);
+	}
+}
+
 void FChromiumCEFBrowserHandler::OnAcceleratedPaint(CefRefPtr<CefBrowser> Browser,
 	PaintElementType Type,
 	const RectList& DirtyRects,
 	void* SharedHandle)
 {
+	if (!IsInGameThread())
+	{
+		// The handle is only guaranteed to stay valid until we return, a reference to its texture keeps it so until the game thread
+		// has queued the copy. The copy is made under the texture's keyed mutex, so it may pick up a later frame but never a partial one.
+		TSharedPtr<void, ESPMode::ThreadSafe> SharedTexture = FChromiumCEFWebBrowserWindowRHIHelper::RetainSharedHandle(SharedHandle);
+		RunOnGameThread([this, Browser, Type, DirtyRects, SharedHandle, SharedTexture]() { OnAcceleratedPaint(Browser, Type, DirtyRects, SharedHandle); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 
 	if (BrowserWindow.IsValid())
@@ -314,6 +523,23 @@ void FChromiumCEFBrowserHandler::OnAcceleratedPaint(CefRefPtr<CefBrowser> Browse
 
 void FChromiumCEFBrowserHandler::OnCursorChange(CefRefPtr<CefBrowser> Browser, CefCursorHandle Cursor, CefRenderHandler::CursorType Type, const CefCursorInfo& CustomCursorInfo)
 {
+	if (!IsInGameThread())
+	{
+		// CEF may destroy a custom cursor once we return, so the game thread gets a copy of its own. The window does not use
+		// CustomCursorInfo, which points at image data owned by the caller, so it is not passed on.
+		TSharedPtr<void, ESPMode::ThreadSafe> CursorOwner = FChromiumCEFWebBrowserWindow::CopyCursor(Cursor, Type);
+		const CefCursorHandle QueuedCursor = CursorOwner.IsValid() ? (CefCursorHandle)CursorOwner.Get() : Cursor;
+		RunOnGameThread([this, QueuedCursor, Type, CursorOwner]()
+		{
+			TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
+			if (BrowserWindow.IsValid())
+			{
+				BrowserWindow->OnCursorChange(QueuedCursor, Type, CefCursorInfo(), CursorOwner);
+			}
+		});
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 
 	if (BrowserWindow.IsValid())
@@ -325,6 +551,12 @@ void FChromiumCEFBrowserHandler::OnCursorChange(CefRefPtr<CefBrowser> Browser, C
 
 void FChromiumCEFBrowserHandler::OnPopupShow(CefRefPtr<CefBrowser> Browser, bool bShow)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, bShow]() { OnPopupShow(Browser, bShow); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 
 	if (BrowserWindow.IsValid())
@@ -336,6 +568,12 @@ void FChromiumCEFBrowserHandler::OnPopupShow(CefRefPtr<CefBrowser> Browser, bool
 
 void FChromiumCEFBrowserHandler::OnPopupSize(CefRefPtr<CefBrowser> Browser, const CefRect& Rect)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, Rect]() { OnPopupSize(Browser, Rect); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 
 	if (BrowserWindow.IsValid())
@@ -346,18 +584,31 @@ void FChromiumCEFBrowserHandler::OnPopupSize(CefRefPtr<CefBrowser> Browser, cons
 
 bool FChromiumCEFBrowserHandler::GetScreenInfo(CefRefPtr<CefBrowser> Browser, CefScreenInfo& ScreenInfo)
 {
+	if (!IsInGameThread())
+	{
+		TSharedPtr<const FViewState, ESPMode::ThreadSafe> State = GetViewState();
+		ScreenInfo.depth = 24;
+		ScreenInfo.device_scale_factor = State.IsValid() ? State->DeviceScaleFactor : 1.0f;
+		return true;
+	}
+
 	TSharedPtr<FChromiumWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	ScreenInfo.depth = 24;
 
 	if (BrowserWindow.IsValid() && BrowserWindow->GetParentWindow().IsValid())
 	{
-		ScreenInfo.device_scale_factor = BrowserWindow->GetParentWindow()->GetNativeWindow()->GetDPIScaleFactor();
+		// Rendering at a lower scale factor keeps the page layout, and so all view coordinates, unchanged while shrinking the texture
+		ScreenInfo.device_scale_factor = BrowserWindow->GetParentWindow()->GetNativeWindow()->GetDPIScaleFactor() * BrowserWindow->GetRenderScale();
 	}
 	else
 	{
 		FDisplayMetrics DisplayMetrics;
 		FDisplayMetrics::RebuildDisplayMetrics(DisplayMetrics);
 		ScreenInfo.device_scale_factor = FPlatformApplicationMisc::GetDPIScaleFactorAtPoint(DisplayMetrics.PrimaryDisplayWorkAreaRect.Left, DisplayMetrics.PrimaryDisplayWorkAreaRect.Top);
+		if (BrowserWindow.IsValid())
+		{
+			ScreenInfo.device_scale_factor *= BrowserWindow->GetRenderScale();
+		}
 	}
 	return true;
 }
@@ -369,6 +620,12 @@ void FChromiumCEFBrowserHandler::OnImeCompositionRangeChanged(
 	const CefRange& SelectionRange,
 	const CefRenderHandler::RectList& CharacterBounds)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, SelectionRange, CharacterBounds]() { OnImeCompositionRangeChanged(Browser, SelectionRange, CharacterBounds); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
 	{
@@ -380,22 +637,29 @@ void FChromiumCEFBrowserHandler::OnImeCompositionRangeChanged(
 
 CefResourceRequestHandler::ReturnValue FChromiumCEFBrowserHandler::OnBeforeResourceLoad(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, CefRefPtr<CefRequestCallback> Callback)
 {
-	// Current thread is IO thread. We need to invoke BrowserWindow->GetResourceContent on the UI (aka Game) thread:
-	CefPostTask(TID_UI, new FChromiumCEFBrowserClosureTask(this, [=]()
+	// Restarted and redirected requests come through here again, they are counted once by their identifier
+	{
+		FScopeLock Lock(&ResourceRequestsLock);
+		ResourceRequestIds.Add(Request->GetIdentifier());
+		ResourceRequestsInFlight = ResourceRequestIds.Num();
+	}
+
+	// Current thread is IO thread. Header rules are applied here, the game thread is only waited for when a delegate or content override needs it
+	const bool bDelegatesWanted = FChromiumCEFRequestRules::ApplyToRequest(Request, GetContextRequestRules());
+	const bool bRunDelegates = bDelegatesWanted && bBeforeResourceLoadBound;
+	if (!bRunDelegates && !bResourceContentPending)
 	{
-		const FString LanguageHeaderText(TEXT("Accept-Language"));
-		const FString LocaleCode = FChromiumWebBrowserSingleton::GetCurrentLocaleCode();
+		FChromiumCEFRequestRules::CountFastPath();
+		return RV_CONTINUE;
+	}
+
+	// We need to invoke BrowserWindow->GetResourceContent on the UI (aka Game) thread:
+	const double PostTime = FPlatformTime::Seconds();
+	FChromiumCEFGameThreadQueue::Post(this, [=]()
+	{
+		const double HopSeconds = FChromiumCEFRequestRules::CountHop(PostTime);
 		CefRequest::HeaderMap HeaderMap;
 		Request->GetHeaderMap(HeaderMap);
-		auto LanguageHeader = HeaderMap.find(TCHAR_TO_WCHAR(*LanguageHeaderText));
-		if (LanguageHeader != HeaderMap.end())
-		{
-			(*LanguageHeader).second = TCHAR_TO_WCHAR(*LocaleCode);
-		}
-		else
-		{
-			HeaderMap.insert(std::pair<CefString, CefString>(TCHAR_TO_WCHAR(*LanguageHeaderText), TCHAR_TO_WCHAR(*LocaleCode)));
-		}
 		
 #ifdef DEBUG_ONBEFORELOAD
 		auto url = Request->GetURL();
@@ -406,7 +670,7 @@ CefResourceRequestHandler::ReturnValue FChromiumCEFBrowserHandler::OnBeforeResou
 		}
 #endif
 
-		if (BeforeResourceLoadDelegate.IsBound())
+		if (bRunDelegates && BeforeResourceLoadDelegate.IsBound())
 		{
 			FRequestHeaders AdditionalHeaders;
 			BeforeResourceLoadDelegate.Execute(Request->GetURL(), Request->GetResourceType(), AdditionalHeaders);
@@ -424,6 +688,8 @@ CefResourceRequestHandler::ReturnValue FChromiumCEFBrowserHandler::OnBeforeResou
 
 		if (BrowserWindow.IsValid())
 		{
+			BrowserWindow->NotifyResourceHop(HopSeconds);
+
 			TOptional<FString> Contents = BrowserWindow->GetResourceContent(Frame, Request);
 			if(Contents.IsSet())
 			{
@@ -455,7 +721,7 @@ CefResourceRequestHandler::ReturnValue FChromiumCEFBrowserHandler::OnBeforeResou
 		Request->SetHeaderMap(HeaderMap);
 
 		Callback->Continue(true);
-	}));
+	});
 
 	// Tell CEF that we're handling this asynchronously.
 	return RV_CONTINUE_ASYNC;
@@ -469,15 +735,27 @@ void FChromiumCEFBrowserHandler::OnResourceLoadComplete(
 	URLRequestStatus Status,
 	int64 Received_content_length)
 {
+	{
+		FScopeLock Lock(&ResourceRequestsLock);
+		ResourceRequestIds.Remove(Request->GetIdentifier());
+		ResourceRequestsInFlight = ResourceRequestIds.Num();
+	}
+
 	// Current thread is IO thread. We need to invoke our delegates on the UI (aka Game) thread:
-	CefPostTask(TID_UI, new FChromiumCEFBrowserClosureTask(this, [=]()
+	FChromiumCEFGameThreadQueue::Post(this, [=]()
 	{
 		ResourceLoadCompleteDelegate.ExecuteIfBound(Request->GetURL(), Request->GetResourceType(), Status, Received_content_length);
-	}));
+	});
 }
 
 void FChromiumCEFBrowserHandler::OnRenderProcessTerminated(CefRefPtr<CefBrowser> Browser, TerminationStatus Status)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, Status]() { OnRenderProcessTerminated(Browser, Status); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
 	{
@@ -492,6 +770,29 @@ bool FChromiumCEFBrowserHandler::OnBeforeBrowse(CefRefPtr<CefBrowser> Browser,
 	bool IsRedirect)
 {
 	// Current thread: UI thread
+	if (!IsInGameThread())
+	{
+		TSharedPtr<const FViewState, ESPMode::ThreadSafe> State = GetViewState();
+		if (State.IsValid() && !State->bDecidesNavigation)
+		{
+			// Nothing on the game thread is going to cancel the navigation, it only needs to hear about it
+			RunOnGameThread([this, Browser, Frame, Request, user_gesture, IsRedirect]()
+			{
+				TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
+				if (BrowserWindow.IsValid() && !BrowserWindow->OnBeforeBrowse().IsBound())
+				{
+					BrowserWindow->OnBeforeBrowse(Browser, Frame, Request, user_gesture, IsRedirect);
+				}
+			});
+			return false;
+		}
+
+		// Game code decides on the navigation, which goes ahead if it does not answer in time
+		bool bCancelNavigation = false;
+		FChromiumCEFGameThreadQueue::RunAndWait([&]() { bCancelNavigation = OnBeforeBrowse(Browser, Frame, Request, user_gesture, IsRedirect); });
+		return bCancelNavigation;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
 	{
@@ -550,19 +851,76 @@ CefRefPtr<CefResourceRequestHandler> FChromiumCEFBrowserHandler::GetResourceRequ
 		GLog->Logf(ELogVerbosity::Display, TEXT("FChromiumCEFBrowserHandler::GetResourceRequestHandler :%s"), url.c_str());
 	}
 #endif
+	// Filtered requests are cancelled or redirected here, before OnBeforeResourceLoad could send them to the game thread
+	const TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> Filter = GetRequestFilter();
+	if (Filter.IsValid())
+	{
+		return Filter->Filter(request, this);
+	}
 	return this;
 }
 
+void FChromiumCEFBrowserHandler::RunOnGameThread(TUniqueFunction<void()>&& Closure)
+{
+	// Hold a reference so the handler outlives the queued closure
+	CefRefPtr<FChromiumCEFBrowserHandler> Self(this);
+	FChromiumCEFGameThreadQueue::Run([Self, Closure = MoveTemp(Closure)]()
+	{
+		Closure();
+	});
+}
+
 void FChromiumCEFBrowserHandler::SetBrowserWindow(TSharedPtr<FChromiumCEFWebBrowserWindow> InBrowserWindow)
 {
 	BrowserWindowPtr = InBrowserWindow;
 }
 
+void FChromiumCEFBrowserHandler::PublishViewState()
+{
+	if (!FChromiumCEFGameThreadQueue::IsThreadedMessageLoop())
+	{
+		return;
+	}
+	check(IsInGameThread());
+
+	// The game thread paths of the CEF callbacks work the answers out, the browser is not needed for them
+	TSharedRef<FViewState, ESPMode::ThreadSafe> State = MakeShared<FViewState, ESPMode::ThreadSafe>();
+	GetViewRect(nullptr, State->ViewRect);
+	GetRootScreenRect(nullptr, State->RootScreenRect);
+	CefScreenInfo ScreenInfo;
+	GetScreenInfo(nullptr, ScreenInfo);
+	State->DeviceScaleFactor = ScreenInfo.device_scale_factor;
+
+	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
+	if (BrowserWindow.IsValid())
+	{
+		State->bSuppressContextMenu = BrowserWindow->OnSuppressContextMenu().IsBound() && BrowserWindow->OnSuppressContextMenu().Execute();
+		State->bDecidesNavigation = BrowserWindow->OnBeforeBrowse().IsBound();
+	}
+
+	FScopeLock Lock(&ViewStateLock);
+	if (!ViewState.IsValid() || !(*ViewState == *State))
+	{
+		ViewState = State;
+	}
+}
+
 bool FChromiumCEFBrowserHandler::OnProcessMessageReceived(CefRefPtr<CefBrowser> Browser,
 	CefRefPtr<CefFrame> frame,
 	CefProcessId SourceProcess,
 	CefRefPtr<CefProcessMessage> Message)
 {
+	if (!IsInGameThread())
+	{
+		// Only claim what the window is going to handle, CEF passes everything else on
+		if (!FChromiumCEFWebBrowserWindow::HandlesProcessMessage(Message))
+		{
+			return false;
+		}
+		RunOnGameThread([this, Browser, frame, SourceProcess, Message]() { OnProcessMessageReceived(Browser, frame, SourceProcess, Message); });
+		return true;
+	}
+
 	bool Retval = false;
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
@@ -612,6 +970,14 @@ bool FChromiumCEFBrowserHandler::OnKeyEvent(CefRefPtr<CefBrowser> Browser,
 	const CefKeyEvent& Event,
 	CefEventHandle OsEvent)
 {
+	if (!IsInGameThread())
+	{
+		// Keys reach us after the page passed on them, nothing CEF does with them depends on our answer in windowless mode.
+		// OsEvent is only valid during this call and not used.
+		RunOnGameThread([this, Browser, Event]() { OnKeyEvent(Browser, Event, nullptr); });
+		return false;
+	}
+
 	// Show dev tools on CMD/CTRL+SHIFT+I
 	if( (Event.type == KEYEVENT_RAWKEYDOWN || Event.type == KEYEVENT_KEYDOWN || Event.type == KEYEVENT_CHAR) &&
 #if PLATFORM_MAC
@@ -678,6 +1044,13 @@ bool FChromiumCEFBrowserHandler::OnKeyEvent(CefRefPtr<CefBrowser> Browser,
 
 bool FChromiumCEFBrowserHandler::OnJSDialog(CefRefPtr<CefBrowser> Browser, const CefString& OriginUrl, JSDialogType DialogType, const CefString& MessageText, const CefString& DefaultPromptText, CefRefPtr<CefJSDialogCallback> Callback, bool& OutSuppressMessage)
 {
+	if (!IsInGameThread())
+	{
+		bool bHandled = false;
+		FChromiumCEFGameThreadQueue::RunAndWait([&]() { bHandled = OnJSDialog(Browser, OriginUrl, DialogType, MessageText, DefaultPromptText, Callback, OutSuppressMessage); });
+		return bHandled;
+	}
+
 	bool Retval = false;
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
@@ -689,6 +1062,13 @@ bool FChromiumCEFBrowserHandler::OnJSDialog(CefRefPtr<CefBrowser> Browser, const
 
 bool FChromiumCEFBrowserHandler::OnBeforeUnloadDialog(CefRefPtr<CefBrowser> Browser, const CefString& MessageText, bool IsReload, CefRefPtr<CefJSDialogCallback> Callback)
 {
+	if (!IsInGameThread())
+	{
+		bool bHandled = false;
+		FChromiumCEFGameThreadQueue::RunAndWait([&]() { bHandled = OnBeforeUnloadDialog(Browser, MessageText, IsReload, Callback); });
+		return bHandled;
+	}
+
 	bool Retval = false;
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
@@ -700,6 +1080,12 @@ bool FChromiumCEFBrowserHandler::OnBeforeUnloadDialog(CefRefPtr<CefBrowser> Brow
 
 void FChromiumCEFBrowserHandler::OnResetDialogState(CefRefPtr<CefBrowser> Browser)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser]() { OnResetDialogState(Browser); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
 	{
@@ -709,6 +1095,17 @@ void FChromiumCEFBrowserHandler::OnResetDialogState(CefRefPtr<CefBrowser> Browse
 
 void FChromiumCEFBrowserHandler::OnBeforeContextMenu(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefContextMenuParams> Params, CefRefPtr<CefMenuModel> Model)
 {
+	if (!IsInGameThread())
+	{
+		// The model has to be changed before we return, so the decision the game thread published last tick is used
+		TSharedPtr<const FViewState, ESPMode::ThreadSafe> State = GetViewState();
+		if (State.IsValid() && State->bSuppressContextMenu)
+		{
+			Model->Clear();
+		}
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if ( BrowserWindow.IsValid() && BrowserWindow->OnSuppressContextMenu().IsBound() && BrowserWindow->OnSuppressContextMenu().Execute() )
 	{
@@ -718,6 +1115,12 @@ void FChromiumCEFBrowserHandler::OnBeforeContextMenu(CefRefPtr<CefBrowser> Brows
 
 void FChromiumCEFBrowserHandler::OnDraggableRegionsChanged(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> frame, const std::vector<CefDraggableRegion>& Regions)
 {
+	if (!IsInGameThread())
+	{
+		RunOnGameThread([this, Browser, frame, Regions]() { OnDraggableRegionsChanged(Browser, frame, Regions); });
+		return;
+	}
+
 	TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = BrowserWindowPtr.Pin();
 	if (BrowserWindow.IsValid())
 	{
@@ -11,6 +11,9 @@
 
 
 #include "IChromiumWebBrowserWindow.h"
+#include "ChromiumCEFRequestRules.h"
+#include "ChromiumCEFRequestFilter.h"
+#include "Misc/ScopeLock.h"
 
 #endif
 
@@ -63,6 +66,17 @@ public:
 		BrowserPopupFeatures = InPopupFeatures;
 	}
 
+	/**
+	 * Sets the domains a failed main frame load is retried on, for handlers created before the browser window they serve.
+	 *
+	 * @param InAltRetryDomains The domains to try in order.
+	 */
+	void SetAltRetryDomains(const TArray<FString>& InAltRetryDomains)
+	{
+		AltRetryDomains = InAltRetryDomains;
+		AltRetryDomainIdx = 0;
+	}
+
 public:
 
 	// CefClient Interface
@@ -321,6 +335,13 @@ public:
 		return CreateWindowDelegate;
 	}
 
+	/** A delegate that is invoked on the game thread once a browser created with CefBrowserHost::CreateBrowser exists. Not used for popups. */
+	DECLARE_DELEGATE_OneParam(FOnBrowserCreated, CefRefPtr<CefBrowser> /*Browser*/);
+	FOnBrowserCreated& OnBrowserCreated()
+	{
+		return BrowserCreatedDelegate;
+	}
+
 	typedef TMap<FString, FString> FRequestHeaders;
 	DECLARE_DELEGATE_ThreeParams(FOnBeforeResourceLoadDelegate, const CefString& /*URL*/, CefRequest::ResourceType /*Type*/, FRequestHeaders& /*AdditionalHeaders*/);
 	FOnBeforeResourceLoadDelegate& OnBeforeResourceLoad()
@@ -340,10 +361,111 @@ public:
 		return ConsoleMessageDelegate;
 	}
 
+	/** @return Number of resource requests that have started loading and not completed yet. */
+	int32 GetResourceRequestsInFlight() const
+	{
+		return ResourceRequestsInFlight;
+	}
+
+	/**
+	 * Tells the IO thread which requests still have to go through the game thread: those the OnBeforeResourceLoad delegate
+	 * wants to see, and all of them while the window may replace a response with its own content. Until the window
+	 * exists and tells, all of them do, it may be created with content to load.
+	 *
+	 * @param bInBeforeResourceLoadBound Whether the window has an OnBeforeResourceLoad delegate bound.
+	 * @param bInResourceContentPending Whether the window has content to load or an OnLoadUrl delegate bound.
+	 */
+	void SetResourceRouting(bool bInBeforeResourceLoadBound, bool bInResourceContentPending)
+	{
+		bBeforeResourceLoadBound = bInBeforeResourceLoadBound;
+		bResourceContentPending = bInResourceContentPending;
+	}
+
+	/** Sets the request rules of the browser's context, applied after the global ones. */
+	void SetContextRequestRules(const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& Rules)
+	{
+		FScopeLock Lock(&ContextLock);
+		ContextRequestRules = Rules;
+	}
+
+	TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe> GetContextRequestRules() const
+	{
+		FScopeLock Lock(&ContextLock);
+		return ContextRequestRules;
+	}
+
+	/** Sets the request filter of the browser's context, which GetResourceRequestHandler applies. */
+	void SetRequestFilter(const TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe>& Filter)
+	{
+		FScopeLock Lock(&ContextLock);
+		RequestFilter = Filter;
+	}
+
+	TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> GetRequestFilter() const
+	{
+		FScopeLock Lock(&ContextLock);
+		return RequestFilter;
+	}
+
+	/**
+	 * Publishes what CEF's own UI thread may ask about the browser window, so GetViewRect, GetRootScreenRect, GetScreenInfo and
+	 * OnBeforeContextMenu can answer without waiting on the game thread. Game thread only, does nothing while CEF is pumped from
+	 * the game thread.
+	 */
+	void PublishViewState();
+
 private:
 
+	/** The browser window as last published by PublishViewState, never changed once published. */
+	struct FViewState
+	{
+		CefRect ViewRect;
+		CefRect RootScreenRect;
+		float DeviceScaleFactor = 1.0f;
+		/** Result of the window's OnSuppressContextMenu delegate. */
+		bool bSuppressContextMenu = false;
+		/** Whether the window's OnBeforeBrowse delegate is bound, so navigations need the game thread to decide on them. */
+		bool bDecidesNavigation = false;
+
+		bool operator==(const FViewState& Other) const
+		{
+			return ViewRect == Other.ViewRect && RootScreenRect == Other.RootScreenRect && DeviceScaleFactor == Other.DeviceScaleFactor
+				&& bSuppressContextMenu == Other.bSuppressContextMenu && bDecidesNavigation == Other.bDecidesNavigation;
+		}
+	};
+
+	/** @return The last published view state, null if there is none yet. */
+	TSharedPtr<const FViewState, ESPMode::ThreadSafe> GetViewState() const
+	{
+		FScopeLock Lock(&ViewStateLock);
+		return ViewState;
+	}
+
+	/** The latest software paint of an element type, waiting for the game thread while CEF runs its own UI thread. */
+	struct FPendingPaint
+	{
+		CefRefPtr<CefBrowser> Browser;
+		/** Every area dirtied since the game thread last took the paint. */
+		RectList DirtyRects;
+		/** Kept between paints, so painting at a fixed resolution does not allocate. */
+		TArray<uint8> Pixels;
+		int32 Width = 0;
+		int32 Height = 0;
+		bool bPending = false;
+	};
+
+	/** Hands the paints that came in since the last call to the browser window. Game thread only. */
+	void DrainPendingPaints();
+
 	bool ShowDevTools(const CefRefPtr<CefBrowser>& Browser);
 
+	/**
+	 * Runs a callback on the game thread, where all Slate facing state lives. Used when CEF calls us from its own UI thread.
+	 *
+	 * @param Closure The work to run, the handler is kept alive until it has.
+	 */
+	void RunOnGameThread(TUniqueFunction<void()>&& Closure);
+
 	bool bUseTransparency;
 	bool bAllowAllCookies;
 
@@ -356,6 +478,9 @@ private:
 	/** Delegate for handling requests to create new windows. */
 	IChromiumWebBrowserWindow::FOnCreateWindow CreateWindowDelegate;
 
+	/** Delegate for notifying that an asynchronously created browser is ready. */
+	FOnBrowserCreated BrowserCreatedDelegate;
+
 	/** Delegate for handling adding additional headers to requests */
 	FOnBeforeResourceLoadDelegate BeforeResourceLoadDelegate;
 
@@ -374,6 +499,33 @@ private:
 	/** Stores popup window features and settings */
 	TSharedPtr<FChromiumCEFBrowserPopupFeatures> BrowserPopupFeatures;
 
+	/** Identifiers of the requests between OnBeforeResourceLoad and OnResourceLoadComplete, kept on CEF's IO thread. */
+	TSet<uint64> ResourceRequestIds;
+	FCriticalSection ResourceRequestsLock;
+	/** Size of ResourceRequestIds, see GetResourceRequestsInFlight. */
+	TAtomic<int32> ResourceRequestsInFlight { 0 };
+
+	/** Read on CEF's IO thread to decide which requests go through the game thread, see SetResourceRouting. */
+	TAtomic<bool> bBeforeResourceLoadBound { false };
+	TAtomic<bool> bResourceContentPending { true };
+
+	/** Request rules and filter of the browser's context, read on CEF's IO thread. */
+	TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe> ContextRequestRules;
+	TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> RequestFilter;
+	mutable FCriticalSection ContextLock;
+
+	/** See PublishViewState, swapped as a whole so readers on CEF's UI thread only hold the lock to copy the pointer. */
+	TSharedPtr<const FViewState, ESPMode::ThreadSafe> ViewState;
+	mutable FCriticalSection ViewStateLock;
+
+	/** One per PaintElementType, newer paints replace the pixels and add their dirty rects, see OnPaint. */
+	FPendingPaint PendingPaints[2];
+	/** Whether a DrainPendingPaints is queued on the game thread, so a burst of paints queues one. */
+	bool bPaintDrainScheduled = false;
+	FCriticalSection PendingPaintsLock;
+	/** Pixels the game thread is handing to the window, swapped with a pending paint's so neither side reallocates. */
+	TArray<uint8> DrainedPaintPixels;
+
 	// Include the default reference counting implementation.
 	IMPLEMENT_REFCOUNTING(FChromiumCEFBrowserHandler);
 };
@@ -0,0 +1,181 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFBrowserPool.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFBrowserHandler.h"
+#include "ChromiumCEFWebBrowserWindow.h"
+#include "ChromiumWebBrowserLog.h"
+#include "ChromiumWebBrowserStats.h"
+#include "Misc/ConfigCacheIni.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Browser Pool Hits"), STAT_ChromiumBrowserPoolHits, STATGROUP_ChromiumUI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Browser Pool Misses"), STAT_ChromiumBrowserPoolMisses, STATGROUP_ChromiumUI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Browsers Ready"), STAT_ChromiumBrowserPoolReady, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Pooled Browser Warm Up (ms)"), STAT_ChromiumBrowserPoolWarmUp, STATGROUP_ChromiumUI);
+
+FChromiumCEFBrowserPool::FChromiumCEFBrowserPool()
+	: PoolSize(0)
+{
+}
+
+void FChromiumCEFBrowserPool::LoadConfig()
+{
+	PoolSize = 0;
+	GConfig->GetInt(TEXT("Browser"), TEXT("BrowserPoolSize"), PoolSize, GEngineIni);
+	PoolSize = FMath::Clamp(PoolSize, 0, 8);
+}
+
+void FChromiumCEFBrowserPool::Prewarm(const FKey& Key, CefRefPtr<CefRequestContext> RequestContext)
+{
+	if (IsEnabled())
+	{
+		Configurations.FindOrAdd(Key).RequestContext = RequestContext;
+	}
+}
+
+bool FChromiumCEFBrowserPool::Acquire(const FKey& Key, CefRefPtr<CefRequestContext> RequestContext, CefRefPtr<CefBrowser>& OutBrowser, CefRefPtr<FChromiumCEFBrowserHandler>& OutHandler)
+{
+	check(IsInGameThread());
+
+	if (!IsEnabled())
+	{
+		return false;
+	}
+
+	FConfiguration& Configuration = Configurations.FindOrAdd(Key);
+	Configuration.RequestContext = RequestContext;
+
+	for (int32 Index = 0; Index < Configuration.Entries.Num(); ++Index)
+	{
+		FEntry& Entry = Configuration.Entries[Index];
+		if (Entry.Browser.get() != nullptr)
+		{
+			OutBrowser = Entry.Browser;
+			OutHandler = Entry.Handler;
+			OutHandler->OnBrowserCreated().Unbind();
+			Configuration.Entries.RemoveAt(Index);
+
+			OutBrowser->GetHost()->WasHidden(false);
+
+			INC_DWORD_STAT(STAT_ChromiumBrowserPoolHits);
+			DEC_DWORD_STAT(STAT_ChromiumBrowserPoolReady);
+			return true;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_ChromiumBrowserPoolMisses);
+	return false;
+}
+
+void FChromiumCEFBrowserPool::Refill()
+{
+	check(IsInGameThread());
+
+	const double Now = FPlatformTime::Seconds();
+	for (TPair<FKey, FConfiguration>& Pair : Configurations)
+	{
+		FConfiguration& Configuration = Pair.Value;
+		if (Configuration.Entries.Num() >= PoolSize || Now < Configuration.NextRefillTime)
+		{
+			continue;
+		}
+
+		const FKey& Key = Pair.Key;
+
+		CefWindowInfo WindowInfo;
+		WindowInfo.SetAsWindowless(kNullWindowHandle);
+		WindowInfo.shared_texture_enabled = FChromiumCEFWebBrowserWindow::CanSupportAcceleratedPaint() ? 1 : 0;
+		WindowInfo.external_begin_frame_enabled = Key.bExternalBeginFrame ? 1 : 0;
+
+		CefBrowserSettings BrowserSettings;
+		BrowserSettings.background_color = Key.BackgroundColor;
+		BrowserSettings.plugins = STATE_DISABLED;
+		// The browser window sets the real rate once the browser is handed out
+		BrowserSettings.windowless_frame_rate = 60;
+
+		FEntry Entry;
+		Entry.Handler = new FChromiumCEFBrowserHandler(Key.bUseTransparency);
+		Entry.Handler->OnBrowserCreated().BindRaw(this, &FChromiumCEFBrowserPool::HandleBrowserCreated, Key, Entry.Handler.get());
+		Entry.RequestTime = Now;
+
+		if (CefBrowserHost::CreateBrowser(WindowInfo, Entry.Handler.get(), "about:blank", BrowserSettings, nullptr, Configuration.RequestContext))
+		{
+			Configuration.Entries.Add(Entry);
+			Configuration.ConsecutiveFailures = 0;
+		}
+		else
+		{
+			Entry.Handler->OnBrowserCreated().Unbind();
+
+			// Whatever keeps CEF from creating browsers is unlikely to clear up by the next tick, back off up to a minute
+			const double RetrySeconds = FMath::Min(FMath::Pow(2.0f, (float)FMath::Min(Configuration.ConsecutiveFailures, 6)), 60.0f);
+			Configuration.NextRefillTime = Now + RetrySeconds;
+			if (Configuration.ConsecutiveFailures++ == 0)
+			{
+				UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Failed to create a pooled browser, retrying with backoff"));
+			}
+			else
+			{
+				UE_LOG(ChromiumLogWebBrowser, Verbose, TEXT("Failed to create a pooled browser again, retrying in %.0f s"), RetrySeconds);
+			}
+		}
+
+		// Spread creation out over several ticks
+		return;
+	}
+}
+
+void FChromiumCEFBrowserPool::HandleBrowserCreated(CefRefPtr<CefBrowser> Browser, FKey Key, FChromiumCEFBrowserHandler* Handler)
+{
+	FConfiguration* Configuration = Configurations.Find(Key);
+	if (Configuration != nullptr)
+	{
+		for (FEntry& Entry : Configuration->Entries)
+		{
+			if (Entry.Handler.get() == Handler)
+			{
+				// Keep it from rendering until it is handed out
+				Browser->GetHost()->WasHidden(true);
+				Entry.Browser = Browser;
+
+				const float WarmUpMs = (FPlatformTime::Seconds() - Entry.RequestTime) * 1000.0;
+				SET_FLOAT_STAT(STAT_ChromiumBrowserPoolWarmUp, WarmUpMs);
+				INC_DWORD_STAT(STAT_ChromiumBrowserPoolReady);
+				UE_LOG(ChromiumLogWebBrowser, Verbose, TEXT("Pooled browser ready after %.1f ms"), WarmUpMs);
+				return;
+			}
+		}
+	}
+
+	Browser->GetHost()->CloseBrowser(true);
+}
+
+void FChromiumCEFBrowserPool::Shutdown()
+{
+	for (TPair<FKey, FConfiguration>& Pair : Configurations)
+	{
+		for (FEntry& Entry : Pair.Value.Entries)
+		{
+			if (Entry.Browser.get() != nullptr)
+			{
+				Entry.Handler->OnBrowserCreated().Unbind();
+				Entry.Browser->GetHost()->CloseBrowser(true);
+			}
+			else
+			{
+				// Still being created, close it as soon as it exists
+				Entry.Handler->OnBrowserCreated().BindLambda([](CefRefPtr<CefBrowser> Browser)
+				{
+					Browser->GetHost()->CloseBrowser(true);
+				});
+			}
+		}
+	}
+
+	Configurations.Reset();
+	SET_DWORD_STAT(STAT_ChromiumBrowserPoolReady, 0);
+}
+
+#endif
@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFLibCefIncludes.h"
+
+class FChromiumCEFBrowserHandler;
+
+/**
+ * Keeps hidden about:blank browsers ready so browser windows can be created without waiting for CEF to spin up a renderer.
+ * Browsers are pooled per configuration that cannot be changed once a browser exists. Every configuration that has been asked
+ * for is topped back up to the configured size in the background, one asynchronous CefBrowserHost::CreateBrowser per tick.
+ *
+ * Pooled browsers are created with the pool's own CefBrowserSettings and the key leaves the rest of them out, so only the
+ * background colour, which is part of the key, and the frame rate, which the window sets once it has the browser, may differ
+ * between windows handed a pooled browser. Settings the singleton does not change per window are the same either way.
+ * The about:blank entry a pooled browser starts with is hidden from the window's history.
+ *
+ * Configured from the [Browser] section of the engine ini: BrowserPoolSize is the number of browsers kept ready per
+ * configuration, 0 (the default) disables the pool.
+ */
+class FChromiumCEFBrowserPool
+{
+public:
+	/** The settings a pooled browser has to match to be handed out. Any other CefBrowserSettings are the pool's, see above. */
+	struct FKey
+	{
+		FKey()
+			: bUseTransparency(false)
+			, BackgroundColor(0)
+			, bExternalBeginFrame(false)
+		{}
+
+		FKey(const FString& InContextId, bool bInUseTransparency, cef_color_t InBackgroundColor, bool bInExternalBeginFrame)
+			: ContextId(InContextId)
+			, bUseTransparency(bInUseTransparency)
+			, BackgroundColor(InBackgroundColor)
+			, bExternalBeginFrame(bInExternalBeginFrame)
+		{}
+
+		bool operator==(const FKey& Other) const
+		{
+			return ContextId == Other.ContextId && bUseTransparency == Other.bUseTransparency && BackgroundColor == Other.BackgroundColor && bExternalBeginFrame == Other.bExternalBeginFrame;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.ContextId), HashCombine(GetTypeHash(Key.BackgroundColor), (Key.bUseTransparency ? 1u : 0u) | (Key.bExternalBeginFrame ? 2u : 0u)));
+		}
+
+		/** Request context id, empty for the global context. */
+		FString ContextId;
+		bool bUseTransparency;
+		cef_color_t BackgroundColor;
+		bool bExternalBeginFrame;
+	};
+
+	FChromiumCEFBrowserPool();
+
+	/** Reads the configuration from the engine ini. */
+	void LoadConfig();
+
+	/** @return true if browsers are pooled at all. */
+	bool IsEnabled() const { return PoolSize > 0; }
+
+	/**
+	 * Marks a configuration as worth keeping browsers ready for.
+	 *
+	 * @param Key The configuration.
+	 * @param RequestContext The context pooled browsers for it are created in, null for the global context.
+	 */
+	void Prewarm(const FKey& Key, CefRefPtr<CefRequestContext> RequestContext);
+
+	/**
+	 * Takes a ready browser out of the pool, and marks the configuration to be refilled. Game thread only.
+	 *
+	 * @param Key The configuration the browser has to match.
+	 * @param RequestContext The context of the requested browser.
+	 * @param OutBrowser The browser, shown again and still on about:blank.
+	 * @param OutHandler The handler the browser was created with.
+	 * @return false if no matching browser was ready.
+	 */
+	bool Acquire(const FKey& Key, CefRefPtr<CefRequestContext> RequestContext, CefRefPtr<CefBrowser>& OutBrowser, CefRefPtr<FChromiumCEFBrowserHandler>& OutHandler);
+
+	/** Starts creating a browser for the first configuration short of the pool size. Game thread only. */
+	void Refill();
+
+	/** Closes every pooled browser, including those still being created. Must be called before CefShutdown. */
+	void Shutdown();
+
+private:
+	struct FEntry
+	{
+		CefRefPtr<FChromiumCEFBrowserHandler> Handler;
+
+		/** Null until CEF has finished creating the browser. */
+		CefRefPtr<CefBrowser> Browser;
+
+		/** When creation was requested, in FPlatformTime::Seconds. */
+		double RequestTime;
+	};
+
+	struct FConfiguration
+	{
+		CefRefPtr<CefRequestContext> RequestContext;
+		TArray<FEntry> Entries;
+
+		/** CreateBrowser failures since the last success, each one doubling the wait before the next attempt. */
+		int32 ConsecutiveFailures = 0;
+		/** When Refill may next try to create a browser for the configuration, in FPlatformTime::Seconds. */
+		double NextRefillTime = 0.0;
+	};
+
+	/** Called when CEF has created a pooled browser. */
+	void HandleBrowserCreated(CefRefPtr<CefBrowser> Browser, FKey Key, FChromiumCEFBrowserHandler* Handler);
+
+	int32 PoolSize;
+
+	TMap<FKey, FConfiguration> Configurations;
+};
+
+#endif
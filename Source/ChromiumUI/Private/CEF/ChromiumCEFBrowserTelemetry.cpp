@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFBrowserTelemetry.h"
+
+#if WITH_CEF3
+
+#include "IChromiumWebBrowserWindow.h"
+
+namespace
+{
+	/** Shortest time rates are measured over, shorter samples would be dominated by single paints. */
+	const double MinSampleSeconds = 1.0;
+}
+
+FChromiumCEFBrowserTelemetry::FChromiumCEFBrowserTelemetry()
+	: SampleTime(FPlatformTime::Seconds())
+	, RenderProcessId(0)
+	, RenderProcessMemoryBytes(0)
+	, RenderProcessCpuPercent(0.0f)
+{
+}
+
+void FChromiumCEFBrowserTelemetry::Sample(double Now)
+{
+	const double Elapsed = Now - SampleTime;
+	if (Elapsed < MinSampleSeconds)
+	{
+		return;
+	}
+	SampleTime = Now;
+
+	Paints.Sample(Elapsed);
+	UploadedBytes.Sample(Elapsed);
+	JSMessages.Sample(Elapsed);
+	ResourceHops.Sample(Elapsed);
+	ResourceHopMicroseconds.Sample(Elapsed);
+	for (FCallbackCounter& Counter : Callbacks)
+	{
+		Counter.Calls.Sample(Elapsed);
+		Counter.Cycles.Sample(Elapsed);
+	}
+}
+
+void FChromiumCEFBrowserTelemetry::SetRenderProcess(uint32 ProcessId, uint64 MemoryBytes, float CpuPercent)
+{
+	RenderProcessId = ProcessId;
+	RenderProcessMemoryBytes = MemoryBytes;
+	RenderProcessCpuPercent = CpuPercent;
+}
+
+void FChromiumCEFBrowserTelemetry::GetStats(FChromiumWebBrowserWindowStats& OutStats) const
+{
+	OutStats.PaintsPerSecond = Paints.PerSecond;
+	OutStats.UploadedBytesPerSecond = UploadedBytes.PerSecond;
+	OutStats.JSMessagesPerSecond = JSMessages.PerSecond;
+	OutStats.ResourceHopsPerSecond = ResourceHops.PerSecond;
+	OutStats.ResourceHopMilliseconds = ResourceHops.PerSecond > 0.0f ? ResourceHopMicroseconds.PerSecond / ResourceHops.PerSecond / 1000.0f : 0.0f;
+	OutStats.RenderProcessId = RenderProcessId;
+	OutStats.RenderProcessMemoryBytes = RenderProcessMemoryBytes;
+	OutStats.RenderProcessCpuPercent = RenderProcessCpuPercent;
+	OutStats.GameThreadMillisecondsPerSecond = GetGameThreadMillisecondsPerSecond();
+
+	OutStats.Callbacks.Reset((int32)ECallback::Count);
+	for (int32 Index = 0; Index < (int32)ECallback::Count; ++Index)
+	{
+		FChromiumWebBrowserCallbackStats& CallbackStats = OutStats.Callbacks.AddDefaulted_GetRef();
+		CallbackStats.Callback = GetCallbackName((ECallback)Index);
+		CallbackStats.CallsPerSecond = Callbacks[Index].Calls.PerSecond;
+		CallbackStats.MillisecondsPerSecond = Callbacks[Index].Cycles.PerSecond * FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+	}
+}
+
+float FChromiumCEFBrowserTelemetry::GetGameThreadMillisecondsPerSecond() const
+{
+	double CyclesPerSecond = 0.0;
+	for (const FCallbackCounter& Counter : Callbacks)
+	{
+		CyclesPerSecond += Counter.Cycles.PerSecond;
+	}
+	return (float)(CyclesPerSecond * FPlatformTime::GetSecondsPerCycle64() * 1000.0);
+}
+
+FName FChromiumCEFBrowserTelemetry::GetCallbackName(ECallback Callback)
+{
+	static const FName Names[] =
+	{
+		TEXT("Paint"),
+		TEXT("Navigation"),
+		TEXT("ResourceLoad"),
+		TEXT("JSBridge"),
+		TEXT("Console"),
+		TEXT("Other"),
+	};
+	static_assert(UE_ARRAY_COUNT(Names) == (int32)ECallback::Count, "Every callback needs a name");
+	return Names[(int32)Callback];
+}
+
+#endif
@@ -0,0 +1,125 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+struct FChromiumWebBrowserWindowStats;
+
+/**
+ * Counts what a browser window does and turns the counts into per second rates for FChromiumWebBrowserWindowStats.
+ * Everything but the render process figures is recorded on the game thread, where the window's CEF callbacks run or are
+ * marshalled to. Counters only ever grow, Sample compares them with the previous sample about once a second.
+ */
+class FChromiumCEFBrowserTelemetry
+{
+public:
+	/** Kinds of callbacks game thread time is broken down by. */
+	enum class ECallback : uint8
+	{
+		Paint,
+		Navigation,
+		ResourceLoad,
+		JSBridge,
+		Console,
+		Other,
+		Count
+	};
+
+	/** Adds the time until it goes out of scope to a kind of callback. */
+	class FCallbackScope
+	{
+	public:
+		FCallbackScope(FChromiumCEFBrowserTelemetry& InTelemetry, ECallback InCallback)
+			: Telemetry(InTelemetry)
+			, Callback(InCallback)
+			, StartCycles(FPlatformTime::Cycles64())
+		{
+		}
+
+		~FCallbackScope()
+		{
+			Telemetry.AddCallbackCycles(Callback, FPlatformTime::Cycles64() - StartCycles);
+		}
+
+	private:
+		FChromiumCEFBrowserTelemetry& Telemetry;
+		ECallback Callback;
+		uint64 StartCycles;
+	};
+
+	FChromiumCEFBrowserTelemetry();
+
+	void NotifyPaint() { ++Paints.Total; }
+
+	/** Called with the window's running totals of uploaded bytes and JS bridge messages, which it keeps anyway. */
+	void SetUploadedBytes(uint64 Total) { UploadedBytes.Total = Total; }
+	void SetJSMessages(uint64 Total) { JSMessages.Total = Total; }
+
+	/** Counts a resource request that waited for the game thread, and how long it waited. */
+	void NotifyResourceHop(double Seconds)
+	{
+		++ResourceHops.Total;
+		ResourceHopMicroseconds.Total += (uint64)(Seconds * 1000000.0);
+	}
+
+	void AddCallbackCycles(ECallback Callback, uint64 Cycles)
+	{
+		FCallbackCounter& Counter = Callbacks[(int32)Callback];
+		++Counter.Calls.Total;
+		Counter.Cycles.Total += Cycles;
+	}
+
+	/** Recomputes the rates if the last sample is at least a second old. Game thread only. */
+	void Sample(double Now);
+
+	/** Stores the render process figures found by the last process scan. */
+	void SetRenderProcess(uint32 ProcessId, uint64 MemoryBytes, float CpuPercent);
+
+	/** Fills in the rates and render process figures. */
+	void GetStats(FChromiumWebBrowserWindowStats& OutStats) const;
+
+	/** @return The game thread time spent in callbacks, in milliseconds per second, as of the last sample. */
+	float GetGameThreadMillisecondsPerSecond() const;
+
+	/** @return The name a kind of callback is reported under. */
+	static FName GetCallbackName(ECallback Callback);
+
+private:
+	/** A running total and its rate over the last sample. */
+	struct FRate
+	{
+		uint64 Total = 0;
+		uint64 SampledTotal = 0;
+		float PerSecond = 0.0f;
+
+		void Sample(double Elapsed)
+		{
+			PerSecond = (float)((Total - SampledTotal) / Elapsed);
+			SampledTotal = Total;
+		}
+	};
+
+	struct FCallbackCounter
+	{
+		FRate Calls;
+		FRate Cycles;
+	};
+
+	FRate Paints;
+	FRate UploadedBytes;
+	FRate JSMessages;
+	FRate ResourceHops;
+	FRate ResourceHopMicroseconds;
+	FCallbackCounter Callbacks[(int32)ECallback::Count];
+
+	double SampleTime;
+
+	uint32 RenderProcessId;
+	uint64 RenderProcessMemoryBytes;
+	float RenderProcessCpuPercent;
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include "ChromiumWebBrowserSingleton.h"
 
 #include "ChromiumCEFLibCefIncludes.h"
+#include "ChromiumCEFGameThreadQueue.h"
 
 class FChromiumCefCookieManager
 	: public IChromiumWebBrowserCookieManager
@@ -86,7 +87,11 @@ private:
 		virtual void OnComplete(int NumDeleted) override
 		{
 			// We're on the IO thread, so we'll have to schedule the callback on the main thread
-			CefPostTask(TID_UI, new FChromiumDeleteCookiesNotificationTask(Callback, NumDeleted));
+			TFunction<void(int)> CompletedCallback = Callback;
+			FChromiumCEFGameThreadQueue::Post(nullptr, [CompletedCallback, NumDeleted]()
+			{
+				CompletedCallback(NumDeleted);
+			});
 		}
 
 		IMPLEMENT_REFCOUNTING(FChromiumDeleteCookiesFunctionCallback);
@@ -105,56 +110,16 @@ private:
 		virtual void OnComplete(bool bSuccess) override
 		{
 			// We're on the IO thread, so we'll have to schedule the callback on the main thread
-			CefPostTask(TID_UI, new FChromiumSetCookieNotificationTask(Callback, bSuccess));
+			TFunction<void(bool)> CompletedCallback = Callback;
+			FChromiumCEFGameThreadQueue::Post(nullptr, [CompletedCallback, bSuccess]()
+			{
+				CompletedCallback(bSuccess);
+			});
 		}
 
 		IMPLEMENT_REFCOUNTING(FChromiumSetCookieFunctionCallback);
 	};
 
-	// Task for executing a callback on a given thread.
-	class FChromiumDeleteCookiesNotificationTask
-		: public CefTask
-	{
-		TFunction<void(int)> Callback;
-		int Value;
-
-	public:
-
-		FChromiumDeleteCookiesNotificationTask(const TFunction<void(int)>& InCallback, int InValue)
-			: Callback(InCallback)
-			, Value(InValue)
-		{}
-
-		virtual void Execute() override
-		{
-			Callback(Value);
-		}
-
-		IMPLEMENT_REFCOUNTING(FChromiumDeleteCookiesNotificationTask);
-	};
-
-	// Task for executing a callback on a given thread.
-	class FChromiumSetCookieNotificationTask
-		: public CefTask
-	{
-		TFunction<void(bool)> Callback;
-		bool bSuccess;
-
-	public:
-
-		FChromiumSetCookieNotificationTask(const TFunction<void(bool)>& InCallback, bool InSuccess)
-			: Callback(InCallback)
-			, bSuccess(InSuccess)
-		{}
-
-		virtual void Execute() override
-		{
-			Callback(bSuccess);
-		}
-
-		IMPLEMENT_REFCOUNTING(FChromiumSetCookieNotificationTask);
-	};
-
 private:
 
 	const CefRefPtr<CefCookieManager> CookieManager;
@@ -0,0 +1,188 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFDirtyRegion.h"
+
+#if WITH_CEF3
+
+#include "Textures/SlateUpdatableTexture.h"
+
+namespace
+{
+	const int32 DirtyRegionBytesPerPixel = FChromiumCEFTextureUploader::BytesPerPixel;
+
+	/** Two rectangles are merged unconditionally if their union covers at most this many pixels that neither of them does. */
+	const int64 DirtyRegionMergeSlack = 32 * 32;
+
+	int64 RectPixelCount(const FIntRect& Rect)
+	{
+		return (int64)Rect.Width() * (int64)Rect.Height();
+	}
+
+	/** Number of pixels the union of A and B covers that are not dirty in either of them. */
+	int64 MergeCost(const FIntRect& A, const FIntRect& B)
+	{
+		FIntRect Union = A;
+		Union.Union(B);
+		FIntRect Overlap = A;
+		Overlap.Clip(B);
+		return RectPixelCount(Union) - RectPixelCount(A) - RectPixelCount(B) + RectPixelCount(Overlap);
+	}
+}
+
+FChromiumCEFDirtyRegion::FChromiumCEFDirtyRegion()
+	: FrameWidth(0)
+	, FrameHeight(0)
+	, bFullFrame(true)
+{
+}
+
+void FChromiumCEFDirtyRegion::Build(const CefRenderHandler::RectList& DirtyRects, int32 Width, int32 Height)
+{
+	FrameWidth = Width;
+	FrameHeight = Height;
+	bFullFrame = false;
+	Rects.Reset();
+
+	const FIntRect Frame(0, 0, Width, Height);
+	FIntRect Bounds;
+	for (const CefRect& DirtyRect : DirtyRects)
+	{
+		FIntRect Rect(DirtyRect.x, DirtyRect.y, DirtyRect.x + DirtyRect.width, DirtyRect.y + DirtyRect.height);
+		Rect.Clip(Frame);
+		if (Rect.Area() <= 0)
+		{
+			continue;
+		}
+
+		// CEF usually reports a handful of rects, but don't let a pathological list turn merging quadratic in the paint call.
+		if (Rects.Num() >= MaxRects * 4)
+		{
+			if (Bounds.Area() > 0)
+			{
+				Bounds.Union(Rect);
+			}
+			else
+			{
+				Bounds = Rect;
+			}
+			continue;
+		}
+		Rects.Add(Rect);
+	}
+	if (Bounds.Area() > 0)
+	{
+		Rects.Add(Bounds);
+	}
+
+	if (Rects.Num() == 0)
+	{
+		bFullFrame = true;
+		return;
+	}
+
+	MergeRects();
+
+	// Uploading most of the frame piecewise costs more than a single full update.
+	if (GetPixelCount() * 4 >= RectPixelCount(Frame) * 3)
+	{
+		bFullFrame = true;
+		Rects.Reset();
+	}
+}
+
+int64 FChromiumCEFDirtyRegion::GetPixelCount() const
+{
+	if (bFullFrame)
+	{
+		return (int64)FrameWidth * (int64)FrameHeight;
+	}
+
+	int64 PixelCount = 0;
+	for (const FIntRect& Rect : Rects)
+	{
+		PixelCount += RectPixelCount(Rect);
+	}
+	return PixelCount;
+}
+
+void FChromiumCEFDirtyRegion::MergeRects()
+{
+	while (Rects.Num() > 1)
+	{
+		int32 BestA = INDEX_NONE;
+		int32 BestB = INDEX_NONE;
+		int64 BestCost = MAX_int64;
+		for (int32 A = 0; A < Rects.Num(); ++A)
+		{
+			for (int32 B = A + 1; B < Rects.Num(); ++B)
+			{
+				const int64 Cost = MergeCost(Rects[A], Rects[B]);
+				if (Cost < BestCost)
+				{
+					BestCost = Cost;
+					BestA = A;
+					BestB = B;
+				}
+			}
+		}
+
+		// Stop once every remaining merge would upload a meaningful amount of clean pixels and we are within budget.
+		if (BestCost > DirtyRegionMergeSlack && Rects.Num() <= MaxRects)
+		{
+			break;
+		}
+
+		Rects[BestA].Union(Rects[BestB]);
+		Rects.RemoveAtSwap(BestB, 1, false);
+	}
+}
+
+int64 FChromiumCEFDirtyRegion::Upload(FChromiumCEFTextureUploader& Uploader, FSlateUpdatableTexture* Texture, int32 Width, int32 Height, const void* Buffer) const
+{
+	check(Texture != nullptr);
+	check(Width == FrameWidth && Height == FrameHeight);
+
+	if (FChromiumCEFTextureUploader::CanUpdateInPlace(Texture, Width, Height))
+	{
+		// Copy only the dirty rows of every rect, back to back, so the paint returns quickly and the render thread does the rest.
+		const int32 NumBytes = (int32)(GetPixelCount() * DirtyRegionBytesPerPixel);
+		FChromiumCEFTextureUploader::FStagingBuffer* Staging = Uploader.AcquireStagingBuffer(Width, Height, NumBytes);
+		if (bFullFrame)
+		{
+			FMemory::Memcpy(Staging->Pixels.GetData(), Buffer, NumBytes);
+		}
+		else
+		{
+			uint8* Dest = Staging->Pixels.GetData();
+			const uint8* Source = static_cast<const uint8*>(Buffer);
+			const int32 SourcePitch = Width * DirtyRegionBytesPerPixel;
+			for (const FIntRect& Rect : Rects)
+			{
+				const int32 RowBytes = Rect.Width() * DirtyRegionBytesPerPixel;
+				for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+				{
+					FMemory::Memcpy(Dest, Source + Y * SourcePitch + Rect.Min.X * DirtyRegionBytesPerPixel, RowBytes);
+					Dest += RowBytes;
+				}
+			}
+			Staging->Rects.Append(Rects);
+		}
+		Uploader.Submit(Texture, Staging);
+		return NumBytes;
+	}
+
+	// Resizes and renderers without direct texture access go through the texture itself, restricted to the bounds of the region.
+	FIntRect Dirty;
+	if (!bFullFrame)
+	{
+		Dirty = Rects[0];
+		for (const FIntRect& Rect : Rects)
+		{
+			Dirty.Union(Rect);
+		}
+	}
+	Texture->UpdateTextureThreadSafeRaw(Width, Height, Buffer, Dirty);
+	return (Dirty.Area() > 0 ? RectPixelCount(Dirty) : (int64)Width * (int64)Height) * DirtyRegionBytesPerPixel;
+}
+
+#endif
@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFLibCefIncludes.h"
+#include "ChromiumCEFTextureUploader.h"
+
+class FSlateUpdatableTexture;
+
+/**
+ * A bounded set of dirty rectangles for a single CEF paint.
+ * Overlapping or nearby rectangles reported by CEF are merged so that at most MaxRects sub-rectangles need to be uploaded,
+ * falling back to a full frame update when the dirty area covers most of the frame anyway.
+ */
+class FChromiumCEFDirtyRegion
+{
+public:
+	/** Upper bound on the number of sub-rectangles uploaded for a single paint. */
+	static const int32 MaxRects = 8;
+
+	typedef TArray<FIntRect, TInlineAllocator<MaxRects>> FRectArray;
+
+	FChromiumCEFDirtyRegion();
+
+	/**
+	 * Rebuilds the region from the rectangles provided by CefRenderHandler::OnPaint.
+	 *
+	 * @param DirtyRects The rectangles CEF reported as changed, in view coordinates.
+	 * @param Width Width of the painted buffer.
+	 * @param Height Height of the painted buffer.
+	 */
+	void Build(const CefRenderHandler::RectList& DirtyRects, int32 Width, int32 Height);
+
+	/** @return true if the whole frame should be updated rather than the individual rectangles. */
+	bool IsFullFrame() const { return bFullFrame; }
+
+	/** @return The merged rectangles, clipped to the frame. Empty when IsFullFrame() is true. */
+	const FRectArray& GetRects() const { return Rects; }
+
+	/** @return Number of pixels covered by the region. */
+	int64 GetPixelCount() const;
+
+	/**
+	 * Uploads the region of a CEF paint buffer into an updatable texture.
+	 * The dirty pixels are packed into a staging buffer and written into the texture by the render thread,
+	 * resizes and renderers without direct texture access go through UpdateTextureThreadSafeRaw.
+	 *
+	 * @param Uploader The upload pipeline of the window being painted.
+	 * @param Texture The texture to update.
+	 * @param Width Width of the painted buffer.
+	 * @param Height Height of the painted buffer.
+	 * @param Buffer The BGRA pixel data of the painted buffer.
+	 * @return Number of bytes submitted for upload.
+	 */
+	int64 Upload(FChromiumCEFTextureUploader& Uploader, FSlateUpdatableTexture* Texture, int32 Width, int32 Height, const void* Buffer) const;
+
+private:
+	/** Merges rectangles whose union wastes little area, then keeps merging the cheapest pairs until at most MaxRects remain. */
+	void MergeRects();
+
+	/** Dimensions of the frame the region was built for. */
+	int32 FrameWidth;
+	int32 FrameHeight;
+
+	/** Whether the whole frame should be updated. */
+	bool bFullFrame;
+
+	/** Merged rectangles, valid when bFullFrame is false. */
+	FRectArray Rects;
+};
+
+#endif
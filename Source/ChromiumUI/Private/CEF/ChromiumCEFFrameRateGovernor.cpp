@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFFrameRateGovernor.h"
+
+#if WITH_CEF3
+
+/** How long after the last input the maximum frame rate is held. */
+static const double InputHoldSeconds = 1.0;
+
+/** Length of the window paints are counted over before the rate is re-evaluated. */
+static const double SampleSeconds = 0.5;
+
+/** How long a page has to stay completely quiet before dropping to the minimum rate. */
+static const double IdleDelaySeconds = 2.0;
+
+/** A page painting at least this fraction of the current rate is assumed to want more frames. */
+static const float SaturatedFraction = 0.8f;
+
+/** Headroom given on top of the measured paint rate of a page that does not use every frame. */
+static const float PaintRateHeadroom = 1.5f;
+
+/** The rate is only lowered when the new rate is below this fraction of the current one, to avoid churning CEF. */
+static const float LowerThreshold = 0.75f;
+
+/** The most a single sample lowers the rate by, so a page that slows down briefly is not left short of frames. */
+static const float MaxDecayFraction = 0.5f;
+
+FChromiumCEFFrameRateGovernor::FChromiumCEFFrameRateGovernor()
+	: MinFrameRate(1)
+	, MaxFrameRate(60)
+	, FrameRate(60)
+	, PaintCount(0)
+	, SampleStartTime(0.0)
+	, LastInputTime(-DBL_MAX)
+	, LastActivityTime(0.0)
+{
+}
+
+void FChromiumCEFFrameRateGovernor::SetLimits(int32 InMinFrameRate, int32 InMaxFrameRate)
+{
+	MaxFrameRate = FMath::Max(InMaxFrameRate, 1);
+	MinFrameRate = FMath::Clamp(InMinFrameRate, 1, MaxFrameRate);
+	FrameRate = MaxFrameRate;
+
+	// Give a freshly configured browser the full idle delay before slowing it down
+	const double Now = FPlatformTime::Seconds();
+	PaintCount = 0;
+	SampleStartTime = Now;
+	LastActivityTime = Now;
+}
+
+int32 FChromiumCEFFrameRateGovernor::Update(double Now, bool bEnabled)
+{
+	int32 TargetFrameRate = FrameRate;
+	if (!bEnabled || Now - LastInputTime < InputHoldSeconds)
+	{
+		TargetFrameRate = MaxFrameRate;
+		LastActivityTime = Now;
+		PaintCount = 0;
+		SampleStartTime = Now;
+	}
+	else
+	{
+		const double Elapsed = Now - SampleStartTime;
+		if (Elapsed < SampleSeconds)
+		{
+			return INDEX_NONE;
+		}
+
+		const float PaintRate = PaintCount / Elapsed;
+		PaintCount = 0;
+		SampleStartTime = Now;
+
+		if (PaintRate >= FrameRate * SaturatedFraction)
+		{
+			// Stepping up from a low rate would take several samples, which shows as stutter in animations not driven by input
+			TargetFrameRate = MaxFrameRate;
+			LastActivityTime = Now;
+		}
+		else if (PaintRate > 0.0f)
+		{
+			TargetFrameRate = FMath::Max(FMath::CeilToInt(PaintRate * PaintRateHeadroom), FMath::CeilToInt(FrameRate * MaxDecayFraction));
+			LastActivityTime = Now;
+		}
+		else if (Now - LastActivityTime >= IdleDelaySeconds)
+		{
+			TargetFrameRate = MinFrameRate;
+		}
+	}
+
+	TargetFrameRate = FMath::Clamp(TargetFrameRate, MinFrameRate, MaxFrameRate);
+	if (TargetFrameRate == FrameRate || (TargetFrameRate > MinFrameRate && TargetFrameRate < FrameRate && TargetFrameRate >= FrameRate * LowerThreshold))
+	{
+		return INDEX_NONE;
+	}
+
+	FrameRate = TargetFrameRate;
+	return FrameRate;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+/**
+ * Picks the windowless frame rate of a browser from its recent activity.
+ * Input ramps the rate straight up to the maximum. Otherwise paints are sampled over short windows: a page that uses every frame
+ * it is offered (CSS animation, video) goes straight back to the maximum as well, a page painting less often is lowered towards
+ * its measured rate plus some headroom, by at most half per sample, and a page that neither paints nor receives input for a while
+ * drops to the idle minimum.
+ */
+class FChromiumCEFFrameRateGovernor
+{
+public:
+	FChromiumCEFFrameRateGovernor();
+
+	/** Sets the range the frame rate is kept in and resets the rate to the maximum. */
+	void SetLimits(int32 InMinFrameRate, int32 InMaxFrameRate);
+
+	int32 GetMinFrameRate() const { return MinFrameRate; }
+	int32 GetMaxFrameRate() const { return MaxFrameRate; }
+
+	/** @return The frame rate the browser was last set to. */
+	int32 GetFrameRate() const { return FrameRate; }
+
+	/** Records a paint from CEF. */
+	void NotifyPaint() { ++PaintCount; }
+
+	/** Records user input sent to the browser. */
+	void NotifyInput(double Now) { LastInputTime = Now; }
+
+	/**
+	 * Re-evaluates the frame rate. Called once per engine tick.
+	 *
+	 * @param Now The current time in seconds.
+	 * @param bEnabled Whether the rate should adapt at all, the maximum is used otherwise.
+	 * @return The new frame rate, or INDEX_NONE if it should not change.
+	 */
+	int32 Update(double Now, bool bEnabled);
+
+private:
+	int32 MinFrameRate;
+	int32 MaxFrameRate;
+	int32 FrameRate;
+
+	/** Paints counted since SampleStartTime. */
+	int32 PaintCount;
+	double SampleStartTime;
+
+	double LastInputTime;
+
+	/** Last time input or paints showed the page was active. */
+	double LastActivityTime;
+};
+
+#endif
@@ -0,0 +1,189 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFGameThreadQueue.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFBrowserClosureTask.h"
+#include "ChromiumWebBrowserLog.h"
+#include "ChromiumWebBrowserStats.h"
+#include "Containers/Queue.h"
+#include "HAL/Event.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/ThreadSafeBool.h"
+
+DECLARE_CYCLE_STAT(TEXT("Marshalled Callbacks"), STAT_ChromiumMarshalledCallbacks, STATGROUP_ChromiumUI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Num Marshalled Callbacks"), STAT_ChromiumNumMarshalledCallbacks, STATGROUP_ChromiumUI);
+
+static bool bThreadedMessageLoop = false;
+
+static float CEFGameThreadWaitTimeout = 2.0f;
+static FAutoConsoleVariableRef CVarCEFGameThreadWaitTimeout(
+	TEXT("r.CEFGameThreadWaitTimeout"),
+	CEFGameThreadWaitTimeout,
+	TEXT("Seconds CEF's UI thread waits for the game thread to make a popup, dialog or navigation decision before going on\n")
+	TEXT("with its default answer. Only used while CEF runs its own UI thread.\n"),
+	ECVF_Default);
+
+/** Set once the queue is shutting down, RunAndWait stops waiting from then on. */
+static FThreadSafeBool bShuttingDown(false);
+
+namespace
+{
+	/** A task RunAndWait is waiting on, shared with the queue as the waiter may give up on it. */
+	struct FWaitedTask
+	{
+		enum EState : int32
+		{
+			Pending,
+			Running,
+			Abandoned,
+		};
+
+		explicit FWaitedTask(TUniqueFunction<void()>&& InTask)
+			: Task(MoveTemp(InTask))
+			, Done(FPlatformProcess::GetSynchEventFromPool(true))
+		{
+		}
+
+		~FWaitedTask()
+		{
+			FPlatformProcess::ReturnSynchEventToPool(Done);
+		}
+
+		TUniqueFunction<void()> Task;
+		FEvent* Done;
+		/** Moves from Pending to either Running, by the game thread, or Abandoned, by the waiter. */
+		TAtomic<int32> State{ Pending };
+	};
+}
+
+/** Work posted from CEF's threads, multiple producers and the game thread as the only consumer. */
+static TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> GameThreadTasks;
+
+void FChromiumCEFGameThreadQueue::SetThreadedMessageLoop(bool bEnabled)
+{
+	bThreadedMessageLoop = bEnabled;
+}
+
+bool FChromiumCEFGameThreadQueue::IsThreadedMessageLoop()
+{
+	return bThreadedMessageLoop;
+}
+
+void FChromiumCEFGameThreadQueue::Run(TUniqueFunction<void()>&& Task)
+{
+	if (IsInGameThread())
+	{
+		Task();
+		return;
+	}
+
+	GameThreadTasks.Enqueue(MoveTemp(Task));
+}
+
+bool FChromiumCEFGameThreadQueue::RunAndWait(TUniqueFunction<void()>&& Task)
+{
+	if (IsInGameThread())
+	{
+		Task();
+		return true;
+	}
+	if (bShuttingDown)
+	{
+		return false;
+	}
+
+	TSharedRef<FWaitedTask, ESPMode::ThreadSafe> Waited = MakeShared<FWaitedTask, ESPMode::ThreadSafe>(MoveTemp(Task));
+	GameThreadTasks.Enqueue([Waited]()
+	{
+		int32 Expected = FWaitedTask::Pending;
+		if (Waited->State.CompareExchange(Expected, FWaitedTask::Running))
+		{
+			Waited->Task();
+			Waited->Done->Trigger();
+		}
+	});
+
+	// Waits in slices so Shutdown is noticed without having to wake every waiter
+	const double Deadline = FPlatformTime::Seconds() + CEFGameThreadWaitTimeout;
+	while (!Waited->Done->Wait(FTimespan::FromMilliseconds(20.0)))
+	{
+		if (bShuttingDown || FPlatformTime::Seconds() >= Deadline)
+		{
+			int32 Expected = FWaitedTask::Pending;
+			if (Waited->State.CompareExchange(Expected, FWaitedTask::Abandoned))
+			{
+				UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Gave up waiting for the game thread to answer CEF after %.1f seconds"), CEFGameThreadWaitTimeout);
+				return false;
+			}
+			// The game thread already started on the task, which it finishes without waiting on us
+			Waited->Done->Wait();
+			break;
+		}
+	}
+	return true;
+}
+
+void FChromiumCEFGameThreadQueue::Shutdown()
+{
+	bShuttingDown = true;
+}
+
+void FChromiumCEFGameThreadQueue::Post(CefRefPtr<CefBaseRefCounted> Handle, TFunction<void()> Closure)
+{
+	if (bThreadedMessageLoop)
+	{
+		Run([Handle, Closure = MoveTemp(Closure)]()
+		{
+			Closure();
+		});
+	}
+	else
+	{
+		CefPostTask(TID_UI, new FChromiumCEFBrowserClosureTask(Handle, MoveTemp(Closure)));
+	}
+}
+
+void FChromiumCEFGameThreadQueue::RunOnUIThreadAndWait(TFunction<void()> Closure)
+{
+	if (!bThreadedMessageLoop || CefCurrentlyOn(TID_UI))
+	{
+		Closure();
+		return;
+	}
+
+	check(IsInGameThread());
+
+	FThreadSafeBool bFinished(false);
+	CefPostTask(TID_UI, new FChromiumCEFBrowserClosureTask(nullptr, [&Closure, &bFinished]()
+	{
+		Closure();
+		bFinished = true;
+	}));
+
+	while (!bFinished)
+	{
+		Drain();
+		FPlatformProcess::Sleep(0.0f);
+	}
+}
+
+int32 FChromiumCEFGameThreadQueue::Drain()
+{
+	check(IsInGameThread());
+	SCOPE_CYCLE_COUNTER(STAT_ChromiumMarshalledCallbacks);
+
+	int32 NumTasks = 0;
+	TUniqueFunction<void()> Task;
+	while (GameThreadTasks.Dequeue(Task))
+	{
+		Task();
+		++NumTasks;
+	}
+
+	INC_DWORD_STAT_BY(STAT_ChromiumNumMarshalledCallbacks, NumTasks);
+	return NumTasks;
+}
+
+#endif
@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFLibCefIncludes.h"
+
+/**
+ * Moves work between CEF's threads and the game thread.
+ * With the default external message pump CEF's UI thread is the game thread, so everything runs inline. When CEF runs its own UI
+ * thread (multi_threaded_message_loop), callbacks that touch Slate facing state are pushed onto a lock-free queue which the
+ * singleton drains once per tick. Callbacks that have to hand an answer back to CEF are answered from state the game thread
+ * published, only popup, dialog and navigation decisions made by game code block CEF's UI thread until the game thread has run them.
+ */
+class FChromiumCEFGameThreadQueue
+{
+public:
+	/** Selects whether CEF runs its own UI thread. Must be set before CefInitialize. */
+	static void SetThreadedMessageLoop(bool bEnabled);
+
+	/** @return true if CEF runs its own UI thread instead of being pumped from the game thread. */
+	static bool IsThreadedMessageLoop();
+
+	/** Runs Task on the game thread: immediately if called there, otherwise on the next Drain. */
+	static void Run(TUniqueFunction<void()>&& Task);
+
+	/**
+	 * Runs Task on the game thread and blocks the calling thread until it has finished, for decisions CEF needs an answer to.
+	 * Gives up once r.CEFGameThreadWaitTimeout has passed or Shutdown was called, in which case Task never runs.
+	 *
+	 * @return false if Task was given up on, the caller should go on with its default answer.
+	 */
+	static bool RunAndWait(TUniqueFunction<void()>&& Task);
+
+	/** Makes RunAndWait give up on every wait, so CEF's UI thread is not left waiting on a game thread that is shutting down. */
+	static void Shutdown();
+
+	/**
+	 * Posts a closure from one of CEF's threads to the game thread.
+	 * Use instead of CefPostTask(TID_UI, ...) for work that touches engine state, as CEF's UI thread is only the game thread
+	 * while the message loop is pumped externally.
+	 *
+	 * @param Handle Kept alive until the closure has run.
+	 * @param Closure The work to run.
+	 */
+	static void Post(CefRefPtr<CefBaseRefCounted> Handle, TFunction<void()> Closure);
+
+	/**
+	 * Runs Closure on CEF's UI thread and waits for it. Game thread only.
+	 * The queue keeps being drained while waiting, so callbacks triggered by the closure can still reach the game thread.
+	 */
+	static void RunOnUIThreadAndWait(TFunction<void()> Closure);
+
+	/**
+	 * Runs every task queued for the game thread.
+	 *
+	 * @return The number of tasks run.
+	 */
+	static int32 Drain();
+};
+
+#endif
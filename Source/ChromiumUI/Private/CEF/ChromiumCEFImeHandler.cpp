@@ -25,6 +25,11 @@ bool FChromiumCEFImeHandler::OnProcessMessageReceived(CefRefPtr<CefBrowser> Brow
 	return Result;
 }
 
+bool FChromiumCEFImeHandler::HandlesProcessMessage(const FString& MessageName)
+{
+	return MessageName == TEXT("UE::IME::FocusChanged");
+}
+
 void FChromiumCEFImeHandler::SendProcessMessage(CefRefPtr<CefProcessMessage> Message)
 {
 	if (IsValid() && InternalCefBrowser->GetMainFrame())
@@ -152,6 +157,11 @@ bool FChromiumCEFImeHandler::HandleFocusChangedMessage(CefRefPtr<CefListValue> M
 	return false;
 }
 
+void FChromiumCEFImeHandler::BindCefBrowser(CefRefPtr<CefBrowser> Browser)
+{
+	InternalCefBrowser = Browser;
+}
+
 void FChromiumCEFImeHandler::UnbindCefBrowser()
 {
 	if (TextInputMethodContext.IsValid())
@@ -42,6 +42,7 @@ class FChromiumCEFImeHandler
 public:
 	FChromiumCEFImeHandler(CefRefPtr<CefBrowser> Browser);
 
+	void BindCefBrowser(CefRefPtr<CefBrowser> Browser);
 	void UnbindCefBrowser();
 	void CacheBrowserSlateInfo(const TSharedRef<SWidget>& Widget);
 	void SetFocus(bool bHasFocus);
@@ -65,6 +66,9 @@ public:
 	 */
 	bool OnProcessMessageReceived(CefRefPtr<CefBrowser> Browser, CefProcessId SourceProcess, CefRefPtr<CefProcessMessage> Message);
 
+	/** @return Whether OnProcessMessageReceived handles messages of this name. Safe to call from any thread. */
+	static bool HandlesProcessMessage(const FString& MessageName);
+
 	/**
 	 * Sends a message to the renderer process.
 	 * See https://bitbucket.org/chromiumembedded/cef/wiki/GeneralUsage#markdown-header-inter-process-communication-ipc for more information.
@@ -94,11 +94,17 @@ bool FChromiumCEFJSScripting::OnProcessMessageReceived(CefRefPtr<CefBrowser> Bro
 	return Result;
 }
 
+bool FChromiumCEFJSScripting::HandlesProcessMessage(const FString& MessageName)
+{
+	return MessageName == TEXT("UE::ExecuteUObjectMethod") || MessageName == TEXT("UE::ReleaseUObject");
+}
+
 void FChromiumCEFJSScripting::SendProcessMessage(CefRefPtr<CefProcessMessage> Message)
 {
 	if (IsValid() && InternalCefBrowser->GetMainFrame())
 	{
 		InternalCefBrowser->GetMainFrame()->SendProcessMessage(PID_RENDERER, Message);
+		++SentMessageCount;
 	}
 }
 
@@ -136,6 +142,21 @@ void FChromiumCEFJSScripting::BindUObject(const FString& Name, UObject* Object,
 		PermanentUObjectsByName.Add(ExposedName, Object);
 	}
 
+	SendSetValueMessage(ExposedName, Converted, bIsPermanent);
+}
+
+void FChromiumCEFJSScripting::ResendPermanentBindings()
+{
+	TMap<FString, UObject*> CachedPermanentUObjectsByName = PermanentUObjectsByName;
+
+	for (auto& Entry : CachedPermanentUObjectsByName)
+	{
+		SendSetValueMessage(Entry.Key, ConvertObject(Entry.Value), true);
+	}
+}
+
+void FChromiumCEFJSScripting::SendSetValueMessage(const FString& ExposedName, CefRefPtr<CefDictionaryValue> Converted, bool bIsPermanent)
+{
 	CefRefPtr<CefProcessMessage> SetValueMessage = CefProcessMessage::Create(TCHAR_TO_WCHAR(TEXT("UE::SetValue")));
 	CefRefPtr<CefListValue>MessageArguments = SetValueMessage->GetArgumentList();
 	CefRefPtr<CefDictionaryValue> Value = CefDictionaryValue::Create();
@@ -333,6 +354,11 @@ bool FChromiumCEFJSScripting::HandleExecuteUObjectMethodMessage(CefRefPtr<CefLis
 	return true;
 }
 
+void FChromiumCEFJSScripting::BindCefBrowser(CefRefPtr<CefBrowser> Browser)
+{
+	InternalCefBrowser = Browser;
+}
+
 void FChromiumCEFJSScripting::UnbindCefBrowser()
 {
 	InternalCefBrowser = nullptr;
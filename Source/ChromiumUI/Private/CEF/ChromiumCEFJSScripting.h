@@ -48,8 +48,10 @@ public:
 	FChromiumCEFJSScripting(CefRefPtr<CefBrowser> Browser, bool bJSBindingToLoweringEnabled)
 		: FChromiumWebJSScripting(bJSBindingToLoweringEnabled)
 		, InternalCefBrowser(Browser)
+		, SentMessageCount(0)
 	{}
 
+	void BindCefBrowser(CefRefPtr<CefBrowser> Browser);
 	void UnbindCefBrowser();
 
 	virtual void BindUObject(const FString& Name, UObject* Object, bool bIsPermanent = true) override;
@@ -65,6 +67,9 @@ public:
 	 */
 	bool OnProcessMessageReceived(CefRefPtr<CefBrowser> Browser, CefProcessId SourceProcess, CefRefPtr<CefProcessMessage> Message);
 
+	/** @return Whether OnProcessMessageReceived handles messages of this name. Safe to call from any thread. */
+	static bool HandlesProcessMessage(const FString& MessageName);
+
 	/**
 	 * Sends a message to the renderer process.
 	 * See https://bitbucket.org/chromiumembedded/cef/wiki/GeneralUsage#markdown-header-inter-process-communication-ipc for more information.
@@ -137,6 +142,12 @@ public:
 
 	CefRefPtr<CefDictionaryValue> GetPermanentBindings();
 
+	/** Sends every permanent binding to the renderer again, for a browser that replaced one that had them. */
+	void ResendPermanentBindings();
+
+	/** @return Number of messages sent to the renderer. */
+	uint64 GetSentMessageCount() const { return SentMessageCount; }
+
 	void InvokeJSFunction(FGuid FunctionId, int32 ArgCount, FChromiumWebJSParam Arguments[], bool bIsError=false) override;
 	void InvokeJSFunction(FGuid FunctionId, const CefRefPtr<CefListValue>& FunctionArguments, bool bIsError=false);
 	void InvokeJSErrorResult(FGuid FunctionId, const FString& Error) override;
@@ -144,6 +155,9 @@ public:
 private:
 	bool ConvertStructArgImpl(uint8* Args, FProperty* Param, CefRefPtr<CefListValue> List, int32 Index);
 
+	/** Sends the renderer the value of a binding. */
+	void SendSetValueMessage(const FString& ExposedName, CefRefPtr<CefDictionaryValue> Converted, bool bIsPermanent);
+
 	bool IsValid()
 	{
 		return InternalCefBrowser.get() != nullptr;
@@ -156,6 +170,8 @@ private:
 
 	/** Pointer to the CEF Browser for this window. */
 	CefRefPtr<CefBrowser> InternalCefBrowser;
+
+	uint64 SentMessageCount;
 };
 
 #endif
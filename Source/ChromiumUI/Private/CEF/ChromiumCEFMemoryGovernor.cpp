@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFMemoryGovernor.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFWebBrowserWindow.h"
+#include "ChromiumWebBrowserLog.h"
+#include "ChromiumWebBrowserStats.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/CoreDelegates.h"
+
+// Only set when the budget is checked, accumulators keep the value in between
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resident Browsers"), STAT_ChromiumResidentBrowsers, STATGROUP_ChromiumUI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Discarded Browsers"), STAT_ChromiumDiscardedBrowsers, STATGROUP_ChromiumUI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Browser Discards"), STAT_ChromiumBrowserDiscards, STATGROUP_ChromiumUI);
+
+namespace
+{
+	/** How often the budget is checked, the windows only change state as fast as Slate shows and hides them. */
+	const double BudgetCheckInterval = 0.5;
+}
+
+FChromiumCEFMemoryGovernor::FChromiumCEFMemoryGovernor()
+	: MaxResidentBrowsers(0)
+	, MinHiddenSecondsBeforeDiscard(10.0)
+	, bDiscardOnLowMemory(true)
+	, bTrimRequested(false)
+	, NextBudgetCheckTime(0.0)
+{
+}
+
+void FChromiumCEFMemoryGovernor::Initialize()
+{
+	MaxResidentBrowsers = 0;
+	GConfig->GetInt(TEXT("Browser"), TEXT("MaxResidentBrowsers"), MaxResidentBrowsers, GEngineIni);
+	MaxResidentBrowsers = FMath::Max(MaxResidentBrowsers, 0);
+
+	float MinHiddenSeconds = 10.0f;
+	GConfig->GetFloat(TEXT("Browser"), TEXT("MinHiddenSecondsBeforeDiscard"), MinHiddenSeconds, GEngineIni);
+	MinHiddenSecondsBeforeDiscard = FMath::Max(MinHiddenSeconds, 0.0f);
+
+	bDiscardOnLowMemory = true;
+	GConfig->GetBool(TEXT("Browser"), TEXT("bDiscardOnLowMemory"), bDiscardOnLowMemory, GEngineIni);
+
+	if (bDiscardOnLowMemory && !MemoryTrimHandle.IsValid())
+	{
+		MemoryTrimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddRaw(this, &FChromiumCEFMemoryGovernor::HandleMemoryTrim);
+		UnloadResourcesHandle = FCoreDelegates::ApplicationShouldUnloadResourcesDelegate.AddRaw(this, &FChromiumCEFMemoryGovernor::HandleMemoryTrim);
+	}
+}
+
+void FChromiumCEFMemoryGovernor::Shutdown()
+{
+	if (MemoryTrimHandle.IsValid())
+	{
+		FCoreDelegates::GetMemoryTrimDelegate().Remove(MemoryTrimHandle);
+		FCoreDelegates::ApplicationShouldUnloadResourcesDelegate.Remove(UnloadResourcesHandle);
+		MemoryTrimHandle.Reset();
+		UnloadResourcesHandle.Reset();
+	}
+}
+
+void FChromiumCEFMemoryGovernor::HandleMemoryTrim()
+{
+	bTrimRequested = true;
+}
+
+void FChromiumCEFMemoryGovernor::Update(const FWindowList& Windows)
+{
+	check(IsInGameThread());
+
+	const bool bTrim = bTrimRequested.Exchange(false);
+	const double Now = FPlatformTime::Seconds();
+	if (!bTrim && Now < NextBudgetCheckTime)
+	{
+		return;
+	}
+	NextBudgetCheckTime = Now + BudgetCheckInterval;
+
+	int32 NumResident = 0;
+	int32 NumDiscarded = 0;
+	bool bRetryTrim = false;
+	TArray<TSharedPtr<FChromiumCEFWebBrowserWindow>, TInlineAllocator<16>> Candidates;
+	for (const TWeakPtr<FChromiumCEFWebBrowserWindow>& WeakWindow : Windows)
+	{
+		TSharedPtr<FChromiumCEFWebBrowserWindow> Window = WeakWindow.Pin();
+		if (!Window.IsValid())
+		{
+			continue;
+		}
+		if (Window->IsDiscarded())
+		{
+			NumDiscarded++;
+			continue;
+		}
+
+		NumResident++;
+		if (Window->CanDiscard() && (bTrim || Now - Window->GetLastVisibleTime() >= MinHiddenSecondsBeforeDiscard))
+		{
+			Candidates.Add(Window);
+		}
+	}
+
+	const int32 NumToDiscard = bTrim ? Candidates.Num() : FMath::Min(Candidates.Num(), MaxResidentBrowsers > 0 ? NumResident - MaxResidentBrowsers : 0);
+	if (NumToDiscard > 0)
+	{
+		// Least recently visible first
+		Candidates.Sort([](const TSharedPtr<FChromiumCEFWebBrowserWindow>& A, const TSharedPtr<FChromiumCEFWebBrowserWindow>& B)
+		{
+			return A->GetLastVisibleTime() < B->GetLastVisibleTime();
+		});
+
+		int32 NumDiscardedNow = 0;
+		for (int32 Index = 0; Index < NumToDiscard; ++Index)
+		{
+			const TSharedPtr<FChromiumCEFWebBrowserWindow>& Window = Candidates[Index];
+			if (!Window->HasCapturedViewState())
+			{
+				// The scroll position and history are only asked for once a browser is about to go, it goes once they are in
+				if (!Window->IsViewStateCapturePending())
+				{
+					Window->CaptureViewState();
+				}
+				bRetryTrim |= bTrim;
+				continue;
+			}
+
+			UE_LOG(ChromiumLogWebBrowser, Verbose, TEXT("Discarding browser for %s, hidden for %.1f s%s"), *Window->GetUrl(), Now - Window->GetLastVisibleTime(), bTrim ? TEXT(" (low memory)") : TEXT(""));
+			Window->Discard();
+			NumDiscardedNow++;
+		}
+		NumResident -= NumDiscardedNow;
+		NumDiscarded += NumDiscardedNow;
+		INC_DWORD_STAT_BY(STAT_ChromiumBrowserDiscards, NumDiscardedNow);
+	}
+	if (bRetryTrim)
+	{
+		bTrimRequested = true;
+	}
+
+	SET_DWORD_STAT(STAT_ChromiumResidentBrowsers, NumResident);
+	SET_DWORD_STAT(STAT_ChromiumDiscardedBrowsers, NumDiscarded);
+}
+
+#endif
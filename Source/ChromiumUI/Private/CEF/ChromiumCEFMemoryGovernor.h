@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+class FChromiumCEFWebBrowserWindow;
+
+/**
+ * Keeps the number of browsers holding a renderer and textures within a budget by discarding hidden ones.
+ * The least recently visible browsers are discarded first, their windows keep what is needed to recreate them once shown again.
+ * A browser picked for discarding is first asked for its view state, and is discarded by a later Update once that is in.
+ * An engine low memory notification discards every hidden browser that can be, regardless of the budget.
+ *
+ * Configured from the [Browser] section of the engine ini: MaxResidentBrowsers is the budget, 0 (the default) for none.
+ * MinHiddenSecondsBeforeDiscard keeps browsers that were only hidden briefly, 10 seconds by default, and bDiscardOnLowMemory
+ * (true by default) selects whether low memory notifications are acted on.
+ */
+class FChromiumCEFMemoryGovernor
+{
+public:
+	typedef TArray<TWeakPtr<FChromiumCEFWebBrowserWindow>> FWindowList;
+
+	FChromiumCEFMemoryGovernor();
+
+	/** Reads the configuration from the engine ini and starts listening for low memory notifications. */
+	void Initialize();
+
+	/** Stops listening for low memory notifications. */
+	void Shutdown();
+
+	/**
+	 * Discards browsers as needed to stay within the budget, or to answer a low memory notification. Game thread only.
+	 *
+	 * @param Windows Every browser window.
+	 */
+	void Update(const FWindowList& Windows);
+
+private:
+	/** Called by the engine when memory runs low, possibly off the game thread. */
+	void HandleMemoryTrim();
+
+	int32 MaxResidentBrowsers;
+	double MinHiddenSecondsBeforeDiscard;
+	bool bDiscardOnLowMemory;
+
+	/** Set by HandleMemoryTrim, acted on by the next Update. */
+	TAtomic<bool> bTrimRequested;
+
+	/** When Update next checks the budget, in FPlatformTime::Seconds. */
+	double NextBudgetCheckTime;
+
+	FDelegateHandle MemoryTrimHandle;
+	FDelegateHandle UnloadResourcesHandle;
+};
+
+#endif
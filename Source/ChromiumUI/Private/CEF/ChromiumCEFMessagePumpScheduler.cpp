@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFMessagePumpScheduler.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFLibCefIncludes.h"
+#include "ChromiumWebBrowserStats.h"
+#include "Misc/ConfigCacheIni.h"
+
+DECLARE_CYCLE_STAT(TEXT("CEF Message Pump"), STAT_ChromiumMessagePump, STATGROUP_ChromiumUI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Num Message Pumps"), STAT_ChromiumNumMessagePumps, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Message Pump Latency (ms)"), STAT_ChromiumMessagePumpLatency, STATGROUP_ChromiumUI);
+
+FChromiumCEFMessagePumpScheduler::FChromiumCEFMessagePumpScheduler()
+	: bForceMessageLoop(false)
+	, MinMessageLoopSeconds(1.0)
+	, MaxForcedMessageLoopSeconds(1.0 / 15.0)
+	, PumpBudgetSeconds(0.002)
+	, MaxPumpsPerFrame(4)
+	, PumpDeadline(-1.0)
+	, LastPumpTime(0.0)
+	, BudgetFrameCounter(0)
+	, FramePumps(0)
+	, FramePumpSeconds(0.0)
+	, FrameMaxLatencyMs(0.0f)
+{
+}
+
+void FChromiumCEFMessagePumpScheduler::LoadConfig()
+{
+	bForceMessageLoop = false;
+	GConfig->GetBool(TEXT("Browser"), TEXT("bForceMessageLoop"), bForceMessageLoop, GEngineIni);
+
+	// Get the configured minimum hertz and make sure the value is within a reasonable range
+	int32 MinMessageLoopHz = 1;
+	GConfig->GetInt(TEXT("Browser"), TEXT("MinMessageLoopHertz"), MinMessageLoopHz, GEngineIni);
+	MinMessageLoopHz = FMath::Clamp(MinMessageLoopHz, 1, 60);
+
+	// Get the configured forced maximum hertz and make sure the value is within a reasonable range
+	int32 MaxForcedMessageLoopHz = 15;
+	GConfig->GetInt(TEXT("Browser"), TEXT("MaxForcedMessageLoopHertz"), MaxForcedMessageLoopHz, GEngineIni);
+	MaxForcedMessageLoopHz = FMath::Clamp(MaxForcedMessageLoopHz, MinMessageLoopHz, 60);
+
+	float PumpBudgetMs = 2.0f;
+	GConfig->GetFloat(TEXT("Browser"), TEXT("MessagePumpBudgetMs"), PumpBudgetMs, GEngineIni);
+
+	MaxPumpsPerFrame = 4;
+	GConfig->GetInt(TEXT("Browser"), TEXT("MaxMessagePumpsPerFrame"), MaxPumpsPerFrame, GEngineIni);
+
+	MinMessageLoopSeconds = 1.0 / MinMessageLoopHz;
+	MaxForcedMessageLoopSeconds = 1.0 / MaxForcedMessageLoopHz;
+	PumpBudgetSeconds = FMath::Max(PumpBudgetMs, 0.0f) / 1000.0;
+	MaxPumpsPerFrame = FMath::Max(MaxPumpsPerFrame, 1);
+}
+
+void FChromiumCEFMessagePumpScheduler::ScheduleWork(int64 DelayMs)
+{
+	// As per CEF documentation, if delay_ms is <= 0, then the call to CefDoMessageLoopWork should happen reasonably soon.  If delay_ms is > 0, then the call
+	//  to CefDoMessageLoopWork should be scheduled to happen after the specified delay and any currently pending scheduled call should be canceled.
+	const double Deadline = FPlatformTime::Seconds() + FMath::Max<int64>(DelayMs, 0) / 1000.0;
+
+	FScopeLock Lock(&DeadlineCS);
+	PumpDeadline = Deadline;
+}
+
+int32 FChromiumCEFMessagePumpScheduler::Tick(bool bHasBrowsers)
+{
+	// @todo: Hack: We rely on OnScheduleMessagePumpWork() which tells us to drive the CEF message pump,
+	//  there appear to be some edge cases where we might not be getting a signal from it so for the time being
+	//  we force a minimum rates here and let it run at a configurable maximum rate when we have any browser windows.
+	const double SecondsSinceLastPump = FPlatformTime::Seconds() - LastPumpTime;
+	const bool bWantForce = bForceMessageLoop || bHasBrowsers;                          // True if we wish to force message pump
+	const bool bCanForce = SecondsSinceLastPump >= MaxForcedMessageLoopSeconds;         // But can we?
+	const bool bMustForce = SecondsSinceLastPump >= MinMessageLoopSeconds;              // Absolutely must force (Min frequency rate hit)
+
+	return Pump((bWantForce && bCanForce) || bMustForce);
+}
+
+int32 FChromiumCEFMessagePumpScheduler::PumpDueWork()
+{
+	return Pump(false);
+}
+
+int32 FChromiumCEFMessagePumpScheduler::Pump(bool bForce)
+{
+	check(IsInGameThread());
+
+	if (BudgetFrameCounter != GFrameCounter)
+	{
+		BudgetFrameCounter = GFrameCounter;
+		FramePumps = 0;
+		FramePumpSeconds = 0.0;
+		FrameMaxLatencyMs = 0.0f;
+	}
+
+	int32 NumPumps = 0;
+	while (FramePumps < MaxPumpsPerFrame && (FramePumps == 0 || FramePumpSeconds < PumpBudgetSeconds))
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		double Deadline = 0.0;
+		if (TakeDueDeadline(StartTime, Deadline))
+		{
+			FrameMaxLatencyMs = FMath::Max(FrameMaxLatencyMs, (float)((StartTime - Deadline) * 1000.0));
+		}
+		else if (!bForce)
+		{
+			break;
+		}
+		bForce = false;
+
+		{
+			SCOPE_CYCLE_COUNTER(STAT_ChromiumMessagePump);
+			CefDoMessageLoopWork();
+		}
+
+		LastPumpTime = FPlatformTime::Seconds();
+		FramePumpSeconds += LastPumpTime - StartTime;
+		++FramePumps;
+		++NumPumps;
+	}
+
+	INC_DWORD_STAT_BY(STAT_ChromiumNumMessagePumps, NumPumps);
+	SET_FLOAT_STAT(STAT_ChromiumMessagePumpLatency, FrameMaxLatencyMs);
+	return NumPumps;
+}
+
+bool FChromiumCEFMessagePumpScheduler::TakeDueDeadline(double Now, double& OutDeadline)
+{
+	FScopeLock Lock(&DeadlineCS);
+	if (PumpDeadline < 0.0 || PumpDeadline > Now)
+	{
+		return false;
+	}
+
+	OutDeadline = PumpDeadline;
+	PumpDeadline = -1.0;
+	return true;
+}
+
+#endif
@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/ScopeLock.h"
+
+#if WITH_CEF3
+
+/**
+ * Decides when to call CefDoMessageLoopWork while CEF is pumped from the game thread (external_message_pump).
+ * CEF asks for work through OnScheduleMessagePumpWork with a delay, which is turned into an absolute deadline on the platform's
+ * high resolution clock. Deadlines are checked when the singleton ticks and again at the end of the frame, and every due pump
+ * runs right away, several times per frame if CEF keeps asking, until the per frame budget is spent. On top of that a minimum
+ * pump rate is always kept, and a faster forced rate while any browser exists, as CEF does not reliably schedule all its work.
+ *
+ * Configured from the [Browser] section of the engine ini: bForceMessageLoop, MinMessageLoopHertz, MaxForcedMessageLoopHertz,
+ * MessagePumpBudgetMs and MaxMessagePumpsPerFrame.
+ */
+class FChromiumCEFMessagePumpScheduler
+{
+public:
+	FChromiumCEFMessagePumpScheduler();
+
+	/** Reads the configuration from the engine ini. */
+	void LoadConfig();
+
+	/**
+	 * Requests a pump. May be called from any thread.
+	 *
+	 * @param DelayMs How long from now the pump should happen, zero or less for as soon as possible. Replaces any pending request.
+	 */
+	void ScheduleWork(int64 DelayMs);
+
+	/**
+	 * Pumps once per engine tick: any work that is due plus the forced minimum rates. Game thread only.
+	 *
+	 * @param bHasBrowsers Whether any browser windows exist, which enables the faster forced rate.
+	 * @return The number of times CefDoMessageLoopWork was called.
+	 */
+	int32 Tick(bool bHasBrowsers);
+
+	/**
+	 * Pumps only if CEF asked for work that is due by now, within what is left of this frame's budget. Game thread only.
+	 *
+	 * @return The number of times CefDoMessageLoopWork was called.
+	 */
+	int32 PumpDueWork();
+
+private:
+	/** Pumps while work is due, or once unconditionally if bForce is set, until the frame's budget or pump limit is reached. */
+	int32 Pump(bool bForce);
+
+	/** Takes the pending deadline if it has passed. */
+	bool TakeDueDeadline(double Now, double& OutDeadline);
+
+	/** Cached configuration. */
+	bool bForceMessageLoop;
+	double MinMessageLoopSeconds;
+	double MaxForcedMessageLoopSeconds;
+	double PumpBudgetSeconds;
+	int32 MaxPumpsPerFrame;
+
+	/** Guards PumpDeadline, which is written by CEF's threads. */
+	FCriticalSection DeadlineCS;
+
+	/** Time CEF wants the next pump by, in FPlatformTime::Seconds, or negative if nothing is scheduled. */
+	double PumpDeadline;
+
+	/** Time of the last pump. */
+	double LastPumpTime;
+
+	/** Frame the budget below belongs to, and the pumps and time already spent in it. */
+	uint64 BudgetFrameCounter;
+	int32 FramePumps;
+	double FramePumpSeconds;
+
+	/** Longest any due pump waited past its deadline this frame, reported as the pump latency. */
+	float FrameMaxLatencyMs;
+};
+
+#endif
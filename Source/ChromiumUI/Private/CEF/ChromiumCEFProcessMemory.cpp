@@ -0,0 +1,228 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFProcessMemory.h"
+
+#if WITH_CEF3
+
+#include "HAL/PlatformProcess.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <psapi.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_MAC
+#include <libproc.h>
+#include <mach/mach_time.h>
+#include <sys/resource.h>
+#include <sys/sysctl.h>
+#elif PLATFORM_LINUX
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if PLATFORM_WINDOWS
+	/** Layout of the UNICODE_STRING returned for ProcessCommandLineInformation, declared here to stay clear of winternl.h. */
+	struct FNtUnicodeString
+	{
+		USHORT Length;
+		USHORT MaximumLength;
+		PWSTR Buffer;
+	};
+
+	/** ProcessCommandLineInformation, available from Windows 8.1. */
+	const ULONG ProcessCommandLineInformationClass = 60;
+
+	typedef LONG (WINAPI *FNtQueryInformationProcess)(HANDLE, ULONG, PVOID, ULONG, PULONG);
+
+	FString ReadCommandLine(HANDLE ProcessHandle)
+	{
+		static const FNtQueryInformationProcess NtQueryInformationProcess = (FNtQueryInformationProcess)::GetProcAddress(::GetModuleHandleW(L"ntdll.dll"), "NtQueryInformationProcess");
+		if (NtQueryInformationProcess == nullptr)
+		{
+			return FString();
+		}
+
+		ULONG Size = 0;
+		NtQueryInformationProcess(ProcessHandle, ProcessCommandLineInformationClass, nullptr, 0, &Size);
+		if (Size < sizeof(FNtUnicodeString))
+		{
+			return FString();
+		}
+
+		TArray<uint8> Buffer;
+		Buffer.SetNumUninitialized(Size);
+		if (NtQueryInformationProcess(ProcessHandle, ProcessCommandLineInformationClass, Buffer.GetData(), Size, &Size) < 0)
+		{
+			return FString();
+		}
+		const FNtUnicodeString* CommandLine = (const FNtUnicodeString*)Buffer.GetData();
+		return FString(CommandLine->Length / sizeof(WCHAR), CommandLine->Buffer);
+	}
+#endif
+
+	/**
+	 * Fills in the memory and processor use of a process.
+	 *
+	 * @return The command line of the process, empty if it could not be read.
+	 */
+	FString ReadProcessInfo(FChromiumBrowserProcessMemory& Process)
+	{
+		FString CommandLine;
+#if PLATFORM_WINDOWS
+		HANDLE ProcessHandle = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, 0, Process.ProcessId);
+		if (ProcessHandle != nullptr)
+		{
+			PROCESS_MEMORY_COUNTERS_EX Counters;
+			FMemory::Memzero(Counters);
+			if (::GetProcessMemoryInfo(ProcessHandle, (PROCESS_MEMORY_COUNTERS*)&Counters, sizeof(Counters)))
+			{
+				Process.WorkingSetBytes = Counters.WorkingSetSize;
+				Process.PrivateBytes = Counters.PrivateUsage;
+			}
+
+			FILETIME CreationTime, ExitTime, KernelTime, UserTime;
+			if (::GetProcessTimes(ProcessHandle, &CreationTime, &ExitTime, &KernelTime, &UserTime))
+			{
+				// Both are in 100 nanosecond units
+				const uint64 Kernel = ((uint64)KernelTime.dwHighDateTime << 32) | KernelTime.dwLowDateTime;
+				const uint64 User = ((uint64)UserTime.dwHighDateTime << 32) | UserTime.dwLowDateTime;
+				Process.CpuSeconds = (Kernel + User) * 1e-7;
+			}
+
+			CommandLine = ReadCommandLine(ProcessHandle);
+			::CloseHandle(ProcessHandle);
+		}
+#elif PLATFORM_MAC
+		rusage_info_v2 Usage;
+		if (proc_pid_rusage((int)Process.ProcessId, RUSAGE_INFO_V2, (rusage_info_t*)&Usage) == 0)
+		{
+			Process.WorkingSetBytes = Usage.ri_resident_size;
+			Process.PrivateBytes = Usage.ri_phys_footprint;
+
+			// The times are in mach absolute time units
+			mach_timebase_info_data_t Timebase;
+			mach_timebase_info(&Timebase);
+			Process.CpuSeconds = (double)(Usage.ri_user_time + Usage.ri_system_time) * Timebase.numer / Timebase.denom * 1e-9;
+		}
+
+		// The arguments follow the argument count and the executable path, separated by nul characters
+		int Mib[3] = { CTL_KERN, KERN_PROCARGS2, (int)Process.ProcessId };
+		size_t Size = 0;
+		if (sysctl(Mib, 3, nullptr, &Size, nullptr, 0) == 0 && Size > sizeof(int))
+		{
+			TArray<ANSICHAR> Buffer;
+			Buffer.SetNumZeroed(Size + 1);
+			if (sysctl(Mib, 3, Buffer.GetData(), &Size, nullptr, 0) == 0)
+			{
+				for (size_t Offset = sizeof(int); Offset < Size; Offset += FCStringAnsi::Strlen(Buffer.GetData() + Offset) + 1)
+				{
+					CommandLine += UTF8_TO_TCHAR(Buffer.GetData() + Offset);
+					CommandLine += TEXT(" ");
+				}
+			}
+		}
+#elif PLATFORM_LINUX
+		// /proc reports a size of 0 for its files, so they are read with stdio rather than the file manager
+		const uint64 PageSize = (uint64)sysconf(_SC_PAGESIZE);
+		if (FILE* Statm = fopen(TCHAR_TO_UTF8(*FString::Printf(TEXT("/proc/%u/statm"), Process.ProcessId)), "r"))
+		{
+			unsigned long Size = 0, Resident = 0, Shared = 0;
+			if (fscanf(Statm, "%lu %lu %lu", &Size, &Resident, &Shared) == 3)
+			{
+				Process.WorkingSetBytes = Resident * PageSize;
+				Process.PrivateBytes = (Resident - FMath::Min(Shared, Resident)) * PageSize;
+			}
+			fclose(Statm);
+		}
+
+		if (FILE* Stat = fopen(TCHAR_TO_UTF8(*FString::Printf(TEXT("/proc/%u/stat"), Process.ProcessId)), "r"))
+		{
+			ANSICHAR Buffer[1024];
+			const size_t Length = fread(Buffer, 1, sizeof(Buffer) - 1, Stat);
+			fclose(Stat);
+			Buffer[Length] = '\0';
+
+			// The executable name in parentheses may contain spaces, utime and stime are the 14th and 15th fields
+			const ANSICHAR* Fields = FCStringAnsi::Strrchr(Buffer, ')');
+			unsigned long UserTicks = 0, SystemTicks = 0;
+			if (Fields != nullptr && sscanf(Fields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &UserTicks, &SystemTicks) == 2)
+			{
+				Process.CpuSeconds = (double)(UserTicks + SystemTicks) / sysconf(_SC_CLK_TCK);
+			}
+		}
+
+		if (FILE* CmdLine = fopen(TCHAR_TO_UTF8(*FString::Printf(TEXT("/proc/%u/cmdline"), Process.ProcessId)), "r"))
+		{
+			// Arguments are separated by nul characters
+			ANSICHAR Buffer[4096];
+			const size_t Length = fread(Buffer, 1, sizeof(Buffer) - 1, CmdLine);
+			fclose(CmdLine);
+			Buffer[Length] = '\0';
+			for (size_t Offset = 0; Offset < Length; Offset += FCStringAnsi::Strlen(Buffer + Offset) + 1)
+			{
+				CommandLine += UTF8_TO_TCHAR(Buffer + Offset);
+				CommandLine += TEXT(" ");
+			}
+		}
+#endif
+		return CommandLine;
+	}
+}
+
+void FChromiumCEFProcessMemory::Collect(const FString& SubProcessPath, TArray<FChromiumBrowserProcessMemory>& OutProcesses, TMap<int32, uint32>* OutRenderProcessIds)
+{
+	OutProcesses.Reset();
+	if (OutRenderProcessIds != nullptr)
+	{
+		OutRenderProcessIds->Reset();
+	}
+
+	// Take every process once, then walk down from ours: on some platforms CEF's children are started through a zygote
+	TMap<uint32, TArray<TPair<uint32, FString>>> ChildrenByParent;
+	for (FPlatformProcess::FProcEnumerator Enumerator; Enumerator.MoveNext();)
+	{
+		FPlatformProcess::FProcEnumInfo Info = Enumerator.GetCurrent();
+		ChildrenByParent.FindOrAdd(Info.GetParentPID()).Emplace(Info.GetPID(), Info.GetName());
+	}
+
+	const FString HelperName = FPaths::GetBaseFilename(SubProcessPath);
+	TArray<uint32> Parents;
+	Parents.Add(FPlatformProcess::GetCurrentProcessId());
+	while (Parents.Num() > 0)
+	{
+		const uint32 Parent = Parents.Pop(false);
+		if (const TArray<TPair<uint32, FString>>* Children = ChildrenByParent.Find(Parent))
+		{
+			for (const TPair<uint32, FString>& Child : *Children)
+			{
+				// Helper bundles on Mac are named after the helper with the process role appended
+				if (FPaths::GetBaseFilename(Child.Value).StartsWith(HelperName))
+				{
+					FChromiumBrowserProcessMemory& Process = OutProcesses.AddDefaulted_GetRef();
+					Process.ProcessId = Child.Key;
+					Process.Name = Child.Value;
+					const FString CommandLine = ReadProcessInfo(Process);
+					FParse::Value(*CommandLine, TEXT("--type="), Process.Type);
+
+					int32 RendererClientId = INDEX_NONE;
+					if (OutRenderProcessIds != nullptr && FParse::Value(*CommandLine, TEXT("--renderer-client-id="), RendererClientId))
+					{
+						OutRenderProcessIds->Add(RendererClientId, Process.ProcessId);
+					}
+					Parents.Add(Child.Key);
+				}
+			}
+		}
+	}
+
+	OutProcesses.Sort([](const FChromiumBrowserProcessMemory& A, const FChromiumBrowserProcessMemory& B)
+	{
+		return A.ProcessId < B.ProcessId;
+	});
+}
+
+#endif
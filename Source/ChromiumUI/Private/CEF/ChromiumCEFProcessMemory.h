@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IChromiumWebBrowserSingleton.h"
+
+#if WITH_CEF3
+
+/**
+ * Finds the processes CEF launched on behalf of this application and reads their memory use from the OS.
+ * Child processes are told apart from other programs the application may have started by their executable, which is the
+ * CEF helper. The Chromium process type and the id Chromium gave render processes come from their command lines.
+ */
+class FChromiumCEFProcessMemory
+{
+public:
+	/**
+	 * Walks the process list and queries each helper process, which takes a few milliseconds. Safe to call from any thread.
+	 *
+	 * @param SubProcessPath The helper executable CEF starts its child processes from.
+	 * @param OutProcesses Receives one entry per child process, sorted by process id.
+	 * @param OutRenderProcessIds If set, receives the process id of each render process keyed by Chromium's id for it.
+	 */
+	static void Collect(const FString& SubProcessPath, TArray<FChromiumBrowserProcessMemory>& OutProcesses, TMap<int32, uint32>* OutRenderProcessIds = nullptr);
+};
+
+#endif
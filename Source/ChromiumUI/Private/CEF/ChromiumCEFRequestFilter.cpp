@@ -0,0 +1,439 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFRequestFilter.h"
+
+#if WITH_CEF3
+
+#include "CEF/ChromiumCEFResourceContextHandler.h"
+#include "ChromiumWebBrowserLog.h"
+#include "Misc/ScopeLock.h"
+
+/** The rules of a FChromiumCEFRequestFilter in the form they are matched in, with their hit counts. */
+class FChromiumCEFRequestFilter::FCompiled
+{
+public:
+	struct FRule
+	{
+		EChromiumRequestFilterAction Action;
+		uint32 ResourceTypeMask;
+		/** Lower case, without a leading *. */
+		FString Host;
+		/** Lower case. */
+		FString PathPrefix;
+		FString RedirectUrl;
+	};
+
+	explicit FCompiled(const TArray<FChromiumRequestFilterRule>& InRules)
+		: Hits(MakeUnique<TAtomic<uint64>[]>(FMath::Max(InRules.Num(), 1)))
+	{
+		HostNodes.AddDefaulted();
+		KeywordNodes.AddDefaulted();
+
+		Rules.Reserve(InRules.Num());
+		for (int32 Index = 0; Index < InRules.Num(); ++Index)
+		{
+			const FChromiumRequestFilterRule& InRule = InRules[Index];
+			FRule& Rule = Rules.AddDefaulted_GetRef();
+			Rule.Action = InRule.Action;
+			Rule.ResourceTypeMask = ChromiumResourceTypesToMask(InRule.ResourceTypes);
+			Rule.Host = InRule.Host.ToLower();
+			Rule.Host.RemoveFromStart(TEXT("*."));
+			Rule.PathPrefix = InRule.PathPrefix.ToLower();
+			Rule.RedirectUrl = InRule.RedirectUrl;
+			if (Rule.Action == EChromiumRequestFilterAction::Redirect && Rule.RedirectUrl.IsEmpty())
+			{
+				UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Request filter rule %d redirects without a RedirectUrl, it blocks instead."), Index);
+				Rule.Action = EChromiumRequestFilterAction::Block;
+			}
+
+			// Each rule is indexed once, by its most selective condition. The others are checked when it comes up as a candidate.
+			if (!InRule.UrlContains.IsEmpty())
+			{
+				AddKeyword(InRule.UrlContains.ToLower(), Index);
+			}
+			else if (!Rule.Host.IsEmpty())
+			{
+				AddHost(Rule.Host, Index);
+			}
+			else
+			{
+				AnyHostRules.Add(Index);
+			}
+		}
+
+		BuildKeywordFailureLinks();
+	}
+
+	/** @return The index of the rule deciding what happens to a request, INDEX_NONE if none matches. Counts the hit. */
+	int32 Evaluate(const FString& Url, CefRequest::ResourceType Type) const
+	{
+		if (Rules.Num() == 0)
+		{
+			return INDEX_NONE;
+		}
+
+		FString Host;
+		FString PathAndQuery;
+		SplitUrl(Url, Host, PathAndQuery);
+		const uint32 TypeBit = ChromiumResourceTypeToMask(Type);
+
+		int32 Decision = INDEX_NONE;
+		int32 Allowed = INDEX_NONE;
+		auto Consider = [this, &Host, &PathAndQuery, TypeBit, &Decision, &Allowed](int32 Index)
+		{
+			const FRule& Rule = Rules[Index];
+			if ((Rule.ResourceTypeMask & TypeBit) == 0
+				|| (!Rule.PathPrefix.IsEmpty() && !PathAndQuery.StartsWith(Rule.PathPrefix, ESearchCase::CaseSensitive))
+				|| (!Rule.Host.IsEmpty() && !IsSameOrSubdomain(Host, Rule.Host)))
+			{
+				return;
+			}
+			int32& Slot = Rule.Action == EChromiumRequestFilterAction::Allow ? Allowed : Decision;
+			Slot = Slot == INDEX_NONE ? Index : FMath::Min(Slot, Index);
+		};
+
+		for (int32 Index : AnyHostRules)
+		{
+			Consider(Index);
+		}
+
+		// Walk the host from the top level domain down, every node passed holds rules for a domain the host is in
+		int32 Node = 0;
+		for (int32 End = Host.Len(); End > 0 && Node != INDEX_NONE;)
+		{
+			int32 Dot = End - 1;
+			while (Dot >= 0 && Host[Dot] != TEXT('.'))
+			{
+				--Dot;
+			}
+			const int32* Child = HostNodes[Node].Children.Find(Host.Mid(Dot + 1, End - Dot - 1));
+			Node = Child != nullptr ? *Child : INDEX_NONE;
+			if (Node != INDEX_NONE)
+			{
+				for (int32 Index : HostNodes[Node].Rules)
+				{
+					Consider(Index);
+				}
+			}
+			End = Dot;
+		}
+
+		// One pass of the path and query through the automaton finds every keyword it contains
+		if (KeywordNodes.Num() > 1)
+		{
+			int32 State = 0;
+			for (TCHAR Char : PathAndQuery)
+			{
+				const int32* Next = KeywordNodes[State].Next.Find(Char);
+				while (Next == nullptr && State != 0)
+				{
+					State = KeywordNodes[State].Fail;
+					Next = KeywordNodes[State].Next.Find(Char);
+				}
+				State = Next != nullptr ? *Next : 0;
+				for (int32 Index : KeywordNodes[State].Rules)
+				{
+					Consider(Index);
+				}
+			}
+		}
+
+		const int32 Result = Allowed != INDEX_NONE ? Allowed : Decision;
+		if (Result != INDEX_NONE)
+		{
+			++Hits[Result];
+		}
+		return Result;
+	}
+
+	const FRule& GetRule(int32 Index) const
+	{
+		return Rules[Index];
+	}
+
+	void GetHits(TArray<uint64>& OutHits) const
+	{
+		OutHits.SetNumUninitialized(Rules.Num());
+		for (int32 Index = 0; Index < Rules.Num(); ++Index)
+		{
+			OutHits[Index] = Hits[Index].Load(EMemoryOrder::Relaxed);
+		}
+	}
+
+private:
+	struct FHostNode
+	{
+		/** Keyed by the next domain label down. */
+		TMap<FString, int32> Children;
+		TArray<int32> Rules;
+	};
+
+	struct FKeywordNode
+	{
+		TMap<TCHAR, int32> Next;
+		/** Node of the longest proper suffix of this node's text that is also a keyword prefix. */
+		int32 Fail = 0;
+		/** Rules whose keyword ends here, including those of the nodes down the failure links. */
+		TArray<int32> Rules;
+	};
+
+	void AddHost(const FString& Host, int32 RuleIndex)
+	{
+		TArray<FString> Labels;
+		Host.ParseIntoArray(Labels, TEXT("."));
+		int32 Node = 0;
+		for (int32 Label = Labels.Num() - 1; Label >= 0; --Label)
+		{
+			const int32* Child = HostNodes[Node].Children.Find(Labels[Label]);
+			if (Child == nullptr)
+			{
+				const int32 NewNode = HostNodes.AddDefaulted();
+				HostNodes[Node].Children.Add(Labels[Label], NewNode);
+				Node = NewNode;
+			}
+			else
+			{
+				Node = *Child;
+			}
+		}
+		HostNodes[Node].Rules.Add(RuleIndex);
+	}
+
+	void AddKeyword(const FString& Keyword, int32 RuleIndex)
+	{
+		int32 Node = 0;
+		for (TCHAR Char : Keyword)
+		{
+			const int32* Next = KeywordNodes[Node].Next.Find(Char);
+			if (Next == nullptr)
+			{
+				const int32 NewNode = KeywordNodes.AddDefaulted();
+				KeywordNodes[Node].Next.Add(Char, NewNode);
+				Node = NewNode;
+			}
+			else
+			{
+				Node = *Next;
+			}
+		}
+		KeywordNodes[Node].Rules.Add(RuleIndex);
+	}
+
+	/** Breadth first, so the failure link of every shorter prefix is known when a node's is computed. */
+	void BuildKeywordFailureLinks()
+	{
+		TArray<int32> Queue;
+		for (const TPair<TCHAR, int32>& Child : KeywordNodes[0].Next)
+		{
+			Queue.Add(Child.Value);
+		}
+
+		for (int32 Head = 0; Head < Queue.Num(); ++Head)
+		{
+			const int32 Node = Queue[Head];
+			for (const TPair<TCHAR, int32>& Child : KeywordNodes[Node].Next)
+			{
+				int32 Fail = KeywordNodes[Node].Fail;
+				const int32* Next = KeywordNodes[Fail].Next.Find(Child.Key);
+				while (Next == nullptr && Fail != 0)
+				{
+					Fail = KeywordNodes[Fail].Fail;
+					Next = KeywordNodes[Fail].Next.Find(Child.Key);
+				}
+				KeywordNodes[Child.Value].Fail = Next != nullptr ? *Next : 0;
+				KeywordNodes[Child.Value].Rules.Append(KeywordNodes[KeywordNodes[Child.Value].Fail].Rules);
+				Queue.Add(Child.Value);
+			}
+		}
+	}
+
+	/** Splits a URL into its lower case host and its lower case path and query, dropping the fragment. */
+	static void SplitUrl(const FString& Url, FString& OutHost, FString& OutPathAndQuery)
+	{
+		int32 HostStart = Url.Find(TEXT("://"), ESearchCase::CaseSensitive);
+		HostStart = HostStart == INDEX_NONE ? 0 : HostStart + 3;
+
+		int32 HostEnd = HostStart;
+		while (HostEnd < Url.Len() && Url[HostEnd] != TEXT('/') && Url[HostEnd] != TEXT('?') && Url[HostEnd] != TEXT('#'))
+		{
+			++HostEnd;
+		}
+
+		int32 PathEnd = INDEX_NONE;
+		Url.FindChar(TEXT('#'), PathEnd);
+		PathEnd = PathEnd == INDEX_NONE || PathEnd < HostEnd ? Url.Len() : PathEnd;
+
+		OutHost = Url.Mid(HostStart, HostEnd - HostStart).ToLower();
+		int32 UserInfoEnd = INDEX_NONE;
+		if (OutHost.FindLastChar(TEXT('@'), UserInfoEnd))
+		{
+			OutHost.RightChopInline(UserInfoEnd + 1, false);
+		}
+		int32 PortStart = INDEX_NONE;
+		if (OutHost.FindLastChar(TEXT(':'), PortStart) && !OutHost.EndsWith(TEXT("]")))
+		{
+			OutHost.LeftInline(PortStart, false);
+		}
+
+		OutPathAndQuery = Url.Mid(HostEnd, PathEnd - HostEnd).ToLower();
+		if (OutPathAndQuery.IsEmpty() || OutPathAndQuery[0] != TEXT('/'))
+		{
+			OutPathAndQuery.InsertAt(0, TEXT('/'));
+		}
+	}
+
+	static bool IsSameOrSubdomain(const FString& Host, const FString& Domain)
+	{
+		return Host.EndsWith(Domain, ESearchCase::CaseSensitive)
+			&& (Host.Len() == Domain.Len() || Host[Host.Len() - Domain.Len() - 1] == TEXT('.'));
+	}
+
+	TArray<FRule> Rules;
+	TArray<FHostNode> HostNodes;
+	TArray<FKeywordNode> KeywordNodes;
+	/** Rules without a host or keyword, checked for every request. */
+	TArray<int32> AnyHostRules;
+	/** Counted on CEF's IO threads, one per rule. */
+	TUniquePtr<TAtomic<uint64>[]> Hits;
+};
+
+/**
+ * Stands in for the handler of a filtered request. Blocked requests are cancelled before they are made. Redirected ones are
+ * pointed at the new URL, which Chromium treats as a redirect, and are then passed to the original handler.
+ */
+class FChromiumCEFFilteredRequestHandler : public CefResourceRequestHandler
+{
+public:
+	FChromiumCEFFilteredRequestHandler(EChromiumRequestFilterAction InAction, const FString& InRedirectUrl, CefRefPtr<CefResourceRequestHandler> InHandler)
+		: Action(InAction)
+		, RedirectUrl(TCHAR_TO_WCHAR(*InRedirectUrl))
+		, Handler(InHandler)
+		, bRedirected(false)
+	{
+	}
+
+	virtual CefRefPtr<CefCookieAccessFilter> GetCookieAccessFilter(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request) override
+	{
+		return Handler.get() != nullptr ? Handler->GetCookieAccessFilter(Browser, Frame, Request) : nullptr;
+	}
+
+	virtual ReturnValue OnBeforeResourceLoad(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, CefRefPtr<CefRequestCallback> Callback) override
+	{
+		if (Action == EChromiumRequestFilterAction::Block)
+		{
+			return RV_CANCEL;
+		}
+		if (!bRedirected)
+		{
+			// Called again for the request to the new URL, which may come back normalized
+			bRedirected = true;
+			Request->SetURL(RedirectUrl);
+			return RV_CONTINUE;
+		}
+		return Handler.get() != nullptr ? Handler->OnBeforeResourceLoad(Browser, Frame, Request, Callback) : RV_CONTINUE;
+	}
+
+	virtual CefRefPtr<CefResourceHandler> GetResourceHandler(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request) override
+	{
+		return Handler.get() != nullptr ? Handler->GetResourceHandler(Browser, Frame, Request) : nullptr;
+	}
+
+	virtual void OnResourceRedirect(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, CefRefPtr<CefResponse> Response, CefString& NewUrl) override
+	{
+		if (Handler.get() != nullptr)
+		{
+			Handler->OnResourceRedirect(Browser, Frame, Request, Response, NewUrl);
+		}
+	}
+
+	virtual bool OnResourceResponse(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, CefRefPtr<CefResponse> Response) override
+	{
+		return Handler.get() != nullptr && Handler->OnResourceResponse(Browser, Frame, Request, Response);
+	}
+
+	virtual CefRefPtr<CefResponseFilter> GetResourceResponseFilter(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, CefRefPtr<CefResponse> Response) override
+	{
+		return Handler.get() != nullptr ? Handler->GetResourceResponseFilter(Browser, Frame, Request, Response) : nullptr;
+	}
+
+	virtual void OnResourceLoadComplete(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, CefRefPtr<CefResponse> Response, URLRequestStatus Status, int64 ReceivedContentLength) override
+	{
+		// Blocked requests never reached the handler's OnBeforeResourceLoad, so it does not hear of them completing either
+		if (Action != EChromiumRequestFilterAction::Block && Handler.get() != nullptr)
+		{
+			Handler->OnResourceLoadComplete(Browser, Frame, Request, Response, Status, ReceivedContentLength);
+		}
+	}
+
+	virtual void OnProtocolExecution(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, bool& bAllowOSExecution) override
+	{
+		if (Handler.get() != nullptr)
+		{
+			Handler->OnProtocolExecution(Browser, Frame, Request, bAllowOSExecution);
+		}
+	}
+
+private:
+	EChromiumRequestFilterAction Action;
+	CefString RedirectUrl;
+	CefRefPtr<CefResourceRequestHandler> Handler;
+	/** Each request gets its own handler, only ever called on the IO thread. */
+	bool bRedirected;
+
+	IMPLEMENT_REFCOUNTING(FChromiumCEFFilteredRequestHandler);
+};
+
+void FChromiumCEFRequestFilter::SetRules(const TArray<FChromiumRequestFilterRule>& Rules)
+{
+	TSharedPtr<const FCompiled, ESPMode::ThreadSafe> NewCompiled;
+	if (Rules.Num() > 0)
+	{
+		NewCompiled = MakeShared<FCompiled, ESPMode::ThreadSafe>(Rules);
+	}
+
+	FScopeLock Lock(&CompiledLock);
+	Compiled = NewCompiled;
+}
+
+TSharedPtr<const FChromiumCEFRequestFilter::FCompiled, ESPMode::ThreadSafe> FChromiumCEFRequestFilter::GetCompiled() const
+{
+	FScopeLock Lock(&CompiledLock);
+	return Compiled;
+}
+
+CefRefPtr<CefResourceRequestHandler> FChromiumCEFRequestFilter::Filter(CefRefPtr<CefRequest> Request, CefRefPtr<CefResourceRequestHandler> Handler) const
+{
+	const TSharedPtr<const FCompiled, ESPMode::ThreadSafe> Current = GetCompiled();
+	if (!Current.IsValid())
+	{
+		return Handler;
+	}
+
+	const int32 RuleIndex = Current->Evaluate(WCHAR_TO_TCHAR(Request->GetURL().ToWString().c_str()), Request->GetResourceType());
+	if (RuleIndex == INDEX_NONE)
+	{
+		return Handler;
+	}
+
+	const FCompiled::FRule& Rule = Current->GetRule(RuleIndex);
+	if (Rule.Action == EChromiumRequestFilterAction::Allow)
+	{
+		return Handler;
+	}
+	return new FChromiumCEFFilteredRequestHandler(Rule.Action, Rule.RedirectUrl, Handler);
+}
+
+void FChromiumCEFRequestFilter::GetHits(TArray<uint64>& OutHits) const
+{
+	const TSharedPtr<const FCompiled, ESPMode::ThreadSafe> Current = GetCompiled();
+	if (Current.IsValid())
+	{
+		Current->GetHits(OutHits);
+	}
+	else
+	{
+		OutHits.Reset();
+	}
+}
+
+#endif
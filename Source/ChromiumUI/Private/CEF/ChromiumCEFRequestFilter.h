@@ -0,0 +1,47 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IChromiumWebBrowserResourceLoader.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFLibCefIncludes.h"
+
+/**
+ * Blocks and redirects the requests of a browser context on CEF's IO thread, from GetResourceRequestHandler, so filtered
+ * requests never reach OnBeforeResourceLoad or the game thread.
+ *
+ * The rules are compiled so a request is checked against the few rules that can match it rather than every rule: hosts
+ * go into a trie keyed by domain labels from the top level domain down, UrlContains texts into an Aho-Corasick automaton
+ * the path and query are run through once. The compiled rules are replaced as a whole by SetRules.
+ */
+class FChromiumCEFRequestFilter
+{
+public:
+	/** Compiles and installs new rules, resetting the hit counts. Safe to call from any thread. */
+	void SetRules(const TArray<FChromiumRequestFilterRule>& Rules);
+
+	/**
+	 * Decides what happens to a request. Safe to call from any thread.
+	 *
+	 * @param Request The request about to be made.
+	 * @param Handler The handler the request goes to if it is not filtered.
+	 * @return Handler, or a handler that cancels or redirects the request.
+	 */
+	CefRefPtr<CefResourceRequestHandler> Filter(CefRefPtr<CefRequest> Request, CefRefPtr<CefResourceRequestHandler> Handler) const;
+
+	/** @return How many requests each rule decided, in the order the rules were set. */
+	void GetHits(TArray<uint64>& OutHits) const;
+
+private:
+	class FCompiled;
+
+	TSharedPtr<const FCompiled, ESPMode::ThreadSafe> GetCompiled() const;
+
+	TSharedPtr<const FCompiled, ESPMode::ThreadSafe> Compiled;
+	mutable FCriticalSection CompiledLock;
+};
+
+#endif
@@ -0,0 +1,178 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFRequestRules.h"
+
+#if WITH_CEF3
+
+#include "CEF/ChromiumCEFResourceContextHandler.h"
+#include "ChromiumWebBrowserStats.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resource Requests Without Hop"), STAT_ChromiumResourceFastPath, STATGROUP_ChromiumUI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resource Request Hops"), STAT_ChromiumResourceHops, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Resource Request Hop Total (ms)"), STAT_ChromiumResourceHopTime, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Resource Request Hop Max (ms)"), STAT_ChromiumResourceHopMax, STATGROUP_ChromiumUI);
+
+namespace
+{
+	FCriticalSection& GetGlobalLock()
+	{
+		static FCriticalSection Lock;
+		return Lock;
+	}
+
+	TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& GetGlobalRules()
+	{
+		static TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe> Rules;
+		return Rules;
+	}
+
+	TAtomic<uint32> FastPathRequests(0);
+
+	/** Longest hop of the frame, the stat is reset every frame. */
+	double FrameMaxHopSeconds = 0.0;
+	uint64 FrameMaxHopFrame = 0;
+
+	/** Header names are case insensitive, a request may have been given one in any case. */
+	void RemoveHeader(CefRequest::HeaderMap& HeaderMap, const FString& Name)
+	{
+		for (auto It = HeaderMap.begin(); It != HeaderMap.end();)
+		{
+			if (Name.Equals(WCHAR_TO_TCHAR(It->first.ToWString().c_str()), ESearchCase::IgnoreCase))
+			{
+				It = HeaderMap.erase(It);
+			}
+			else
+			{
+				++It;
+			}
+		}
+	}
+
+	void SetHeader(CefRequest::HeaderMap& HeaderMap, const FString& Name, const FString& Value)
+	{
+		RemoveHeader(HeaderMap, Name);
+		HeaderMap.insert(std::pair<CefString, CefString>(TCHAR_TO_WCHAR(*Name), TCHAR_TO_WCHAR(*Value)));
+	}
+}
+
+FChromiumCEFRequestRules::FChromiumCEFRequestRules(const FString& InAcceptLanguage, const TArray<FChromiumResourceRequestRule>& InRules)
+	: AcceptLanguage(InAcceptLanguage)
+	, bHasUrlPatterns(false)
+	, bHasDelegateRules(false)
+{
+	Rules.Reserve(InRules.Num());
+	for (const FChromiumResourceRequestRule& Rule : InRules)
+	{
+		FCompiledRule& Compiled = Rules.AddDefaulted_GetRef();
+		Compiled.UrlPattern = Rule.UrlPattern == TEXT("*") ? FString() : Rule.UrlPattern;
+		Compiled.ResourceTypeMask = ChromiumResourceTypesToMask(Rule.ResourceTypes);
+		for (const TPair<FString, FString>& Header : Rule.SetHeaders)
+		{
+			Compiled.SetHeaders.Emplace(Header.Key, Header.Value);
+		}
+		Compiled.RemoveHeaders = Rule.RemoveHeaders;
+		Compiled.bRunDelegates = Rule.bRunDelegates;
+
+		bHasUrlPatterns |= !Compiled.UrlPattern.IsEmpty();
+		bHasDelegateRules |= Compiled.bRunDelegates;
+	}
+}
+
+bool FChromiumCEFRequestRules::Apply(CefRefPtr<CefRequest> Request, CefRequest::HeaderMap& HeaderMap) const
+{
+	if (!AcceptLanguage.IsEmpty())
+	{
+		SetHeader(HeaderMap, TEXT("Accept-Language"), AcceptLanguage);
+	}
+
+	if (Rules.Num() == 0)
+	{
+		return false;
+	}
+
+	const uint32 TypeBit = ChromiumResourceTypeToMask(Request->GetResourceType());
+	const FString Url = bHasUrlPatterns ? FString(WCHAR_TO_TCHAR(Request->GetURL().ToWString().c_str())) : FString();
+
+	bool bRunDelegates = false;
+	for (const FCompiledRule& Rule : Rules)
+	{
+		if ((Rule.ResourceTypeMask & TypeBit) == 0 || (!Rule.UrlPattern.IsEmpty() && !Url.MatchesWildcard(Rule.UrlPattern)))
+		{
+			continue;
+		}
+
+		for (const FString& Header : Rule.RemoveHeaders)
+		{
+			RemoveHeader(HeaderMap, Header);
+		}
+		for (const TPair<FString, FString>& Header : Rule.SetHeaders)
+		{
+			SetHeader(HeaderMap, Header.Key, Header.Value);
+		}
+		bRunDelegates |= Rule.bRunDelegates;
+	}
+	return bRunDelegates;
+}
+
+bool FChromiumCEFRequestRules::ApplyToRequest(CefRefPtr<CefRequest> Request, const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& ContextRules)
+{
+	CefRequest::HeaderMap HeaderMap;
+	Request->GetHeaderMap(HeaderMap);
+
+	bool bHasDelegateRules = false;
+	bool bDelegateRuleMatched = false;
+	const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe> RuleSets[] = { GetGlobal(), ContextRules };
+	for (const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& RuleSet : RuleSets)
+	{
+		if (RuleSet.IsValid())
+		{
+			bHasDelegateRules |= RuleSet->HasDelegateRules();
+			bDelegateRuleMatched |= RuleSet->Apply(Request, HeaderMap);
+		}
+	}
+
+	Request->SetHeaderMap(HeaderMap);
+	return !bHasDelegateRules || bDelegateRuleMatched;
+}
+
+void FChromiumCEFRequestRules::SetGlobal(const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& InRules)
+{
+	FScopeLock Lock(&GetGlobalLock());
+	GetGlobalRules() = InRules;
+}
+
+TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe> FChromiumCEFRequestRules::GetGlobal()
+{
+	FScopeLock Lock(&GetGlobalLock());
+	return GetGlobalRules();
+}
+
+void FChromiumCEFRequestRules::CountFastPath()
+{
+	++FastPathRequests;
+}
+
+double FChromiumCEFRequestRules::CountHop(double PostTime)
+{
+	check(IsInGameThread());
+	const double HopSeconds = FPlatformTime::Seconds() - PostTime;
+	if (FrameMaxHopFrame != GFrameCounter)
+	{
+		FrameMaxHopFrame = GFrameCounter;
+		FrameMaxHopSeconds = 0.0;
+	}
+	FrameMaxHopSeconds = FMath::Max(FrameMaxHopSeconds, HopSeconds);
+
+	INC_DWORD_STAT(STAT_ChromiumResourceHops);
+	INC_FLOAT_STAT_BY(STAT_ChromiumResourceHopTime, HopSeconds * 1000.0);
+	SET_FLOAT_STAT(STAT_ChromiumResourceHopMax, FrameMaxHopSeconds * 1000.0);
+	return HopSeconds;
+}
+
+void FChromiumCEFRequestRules::UpdateStats()
+{
+	SET_DWORD_STAT(STAT_ChromiumResourceFastPath, FastPathRequests.Exchange(0));
+}
+
+#endif
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IChromiumWebBrowserResourceLoader.h"
+
+#if WITH_CEF3
+
+#include "ChromiumCEFLibCefIncludes.h"
+
+/**
+ * A compiled, immutable set of FChromiumResourceRequestRule, applied to requests on CEF's IO thread in OnBeforeResourceLoad.
+ * Requests that only need their headers changed continue right away, instead of waiting for the game thread to run the
+ * OnBeforeResourceLoad delegates. Rule sets are shared between threads and replaced as a whole, never modified.
+ */
+class FChromiumCEFRequestRules
+{
+public:
+	/**
+	 * @param InAcceptLanguage Value the Accept-Language header of every request is set to, empty to leave it alone.
+	 * @param InRules The rules, applied in order.
+	 */
+	FChromiumCEFRequestRules(const FString& InAcceptLanguage, const TArray<FChromiumResourceRequestRule>& InRules);
+
+	/**
+	 * Applies the header changes of the rules matching a request. Safe to call from any thread.
+	 *
+	 * @return Whether a matching rule asks for the request to be passed to the OnBeforeResourceLoad delegates.
+	 */
+	bool Apply(CefRefPtr<CefRequest> Request, CefRequest::HeaderMap& HeaderMap) const;
+
+	/** @return Whether any rule asks for requests to be passed to the delegates, which are then skipped for the others. */
+	bool HasDelegateRules() const
+	{
+		return bHasDelegateRules;
+	}
+
+	/**
+	 * Applies the global rules, then those of the request's context, to a request. Safe to call from any thread.
+	 *
+	 * @param Request The request, its headers are replaced.
+	 * @param ContextRules Rules of the request's context, if any.
+	 * @return Whether the request should be passed to the OnBeforeResourceLoad delegates, if they are bound.
+	 */
+	static bool ApplyToRequest(CefRefPtr<CefRequest> Request, const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& ContextRules);
+
+	/** Replaces the rule set applied to every browser's requests, along with the rules of their context. */
+	static void SetGlobal(const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& InRules);
+
+	/** @return The rule set applied to every browser's requests, if any. Safe to call from any thread. */
+	static TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe> GetGlobal();
+
+	/** Counts a request that continued on the IO thread. */
+	static void CountFastPath();
+
+	/**
+	 * Counts a request that waited for the game thread and updates the hop stats. Game thread only.
+	 *
+	 * @param PostTime When the request was posted to the game thread, in FPlatformTime::Seconds.
+	 * @return How long the request waited, in seconds.
+	 */
+	static double CountHop(double PostTime);
+
+	/** Publishes the requests that continued on the IO thread since the last call to the stats. Game thread only. */
+	static void UpdateStats();
+
+private:
+	struct FCompiledRule
+	{
+		FString UrlPattern;
+		/** Bit per CefRequest::ResourceType, all set to match every type. */
+		uint32 ResourceTypeMask;
+		TArray<TPair<FString, FString>> SetHeaders;
+		TArray<FString> RemoveHeaders;
+		bool bRunDelegates;
+	};
+
+	FString AcceptLanguage;
+	TArray<FCompiledRule> Rules;
+	/** Whether any rule has a URL pattern, the URL is only converted for matching if so. */
+	bool bHasUrlPatterns;
+	bool bHasDelegateRules;
+};
+
+#endif
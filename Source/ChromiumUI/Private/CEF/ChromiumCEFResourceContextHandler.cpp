@@ -8,11 +8,16 @@
 //#define DEBUG_ONBEFORELOAD // Debug print beforebrowse steps, used in CEFBrowserHandler.h so define early 
 
 #include "ChromiumCEFBrowserClosureTask.h"
+#include "ChromiumCEFGameThreadQueue.h"
+#include "ChromiumCEFRequestRules.h"
+#include "ChromiumCEFRequestFilter.h"
 #include "ChromiumWebBrowserSingleton.h"
+#include "ChromiumWebBrowserLog.h"
 
 #define LOCTEXT_NAMESPACE "WebBrowserHandler"
 
 FChromiumCEFResourceContextHandler::FChromiumCEFResourceContextHandler()
+	: RequestFilter(MakeShared<FChromiumCEFRequestFilter, ESPMode::ThreadSafe>())
 { }
 
 
@@ -102,6 +107,33 @@ FString ChromiumResourceTypeToString(const CefRequest::ResourceType& Type)
 	return TypeStr;
 }
 
+uint32 ChromiumResourceTypesToMask(const TArray<FString>& Types)
+{
+	if (Types.Num() == 0)
+	{
+		return MAX_uint32;
+	}
+
+	uint32 Mask = 0;
+	for (const FString& Name : Types)
+	{
+		bool bFound = false;
+		for (int32 Type = 0; Type < 32 && !bFound; ++Type)
+		{
+			if (Name.Equals(ChromiumResourceTypeToString((CefRequest::ResourceType)Type), ESearchCase::IgnoreCase))
+			{
+				Mask |= ChromiumResourceTypeToMask((CefRequest::ResourceType)Type);
+				bFound = true;
+			}
+		}
+		if (!bFound)
+		{
+			UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Unknown resource type '%s'."), *Name);
+		}
+	}
+	return Mask;
+}
+
 CefResourceRequestHandler::ReturnValue FChromiumCEFResourceContextHandler::OnBeforeResourceLoad(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, CefRefPtr<CefRequestCallback> Callback)
 {
 #ifdef DEBUG_ONBEFORELOAD
@@ -115,22 +147,19 @@ CefResourceRequestHandler::ReturnValue FChromiumCEFResourceContextHandler::OnBef
 
 
 
-	// Current thread is IO thread. We need to invoke BrowserWindow->GetResourceContent on the UI (aka Game) thread:
-	CefPostTask(TID_UI, new FChromiumCEFBrowserClosureTask(this, [=]()
+	// Current thread is IO thread. Header rules are applied here, the game thread is only waited for when the delegate needs it
+	if (!FChromiumCEFRequestRules::ApplyToRequest(Request, RequestRules) || !BeforeResourceLoadDelegate.IsBound())
+	{
+		FChromiumCEFRequestRules::CountFastPath();
+		return RV_CONTINUE;
+	}
+
+	const double PostTime = FPlatformTime::Seconds();
+	FChromiumCEFGameThreadQueue::Post(this, [=]()
 	{
-		const FString LanguageHeaderText(TEXT("Accept-Language"));
-		const FString LocaleCode = FChromiumWebBrowserSingleton::GetCurrentLocaleCode();
+		FChromiumCEFRequestRules::CountHop(PostTime);
 		CefRequest::HeaderMap HeaderMap;
 		Request->GetHeaderMap(HeaderMap);
-		auto LanguageHeader = HeaderMap.find(TCHAR_TO_WCHAR(*LanguageHeaderText));
-		if (LanguageHeader != HeaderMap.end())
-		{
-			(*LanguageHeader).second = TCHAR_TO_WCHAR(*LocaleCode);
-		}
-		else
-		{
-			HeaderMap.insert(std::pair<CefString, CefString>(TCHAR_TO_WCHAR(*LanguageHeaderText), TCHAR_TO_WCHAR(*LocaleCode)));
-		}
 
 		FChromiumContextRequestHeaders AdditionalHeaders;
 		BeforeResourceLoadDelegate.ExecuteIfBound(WCHAR_TO_TCHAR(Request->GetURL().ToWString().c_str()), ChromiumResourceTypeToString(Request->GetResourceType()), AdditionalHeaders);
@@ -145,7 +174,7 @@ CefResourceRequestHandler::ReturnValue FChromiumCEFResourceContextHandler::OnBef
 		Request->SetHeaderMap(HeaderMap);
 
 		Callback->Continue(true);
-	}));
+	});
 
 	// Tell CEF that we're handling this asynchronously.
 	return RV_CONTINUE_ASYNC;
@@ -164,7 +193,7 @@ CefRefPtr<CefResourceRequestHandler> FChromiumCEFResourceContextHandler::GetReso
 		GLog->Logf(ELogVerbosity::Display, TEXT("FCEFBrowserHandler::GetResourceRequestHandler :%s"), url.c_str());
 	}
 #endif
-	return this;
+	return RequestFilter->Filter(request, this);
 }
 
 /*void FChromiumCEFResourceContextHandler::AddLoadCallback(IWebBrowserOnBeforeResourceLoadHandler* pCallback)
@@ -10,9 +10,21 @@
 
 #include "ChromiumCEFLibCefIncludes.h"
 
+class FChromiumCEFRequestRules;
+class FChromiumCEFRequestFilter;
+
 
 FString ChromiumResourceTypeToString(const CefRequest::ResourceType& Type);
 
+/** @return The bit a resource type has in masks made by ChromiumResourceTypesToMask. */
+inline uint32 ChromiumResourceTypeToMask(CefRequest::ResourceType Type)
+{
+	return (int32)Type >= 0 && (int32)Type < 32 ? 1u << (int32)Type : 0;
+}
+
+/** @return A mask of resource types named as by ChromiumResourceTypeToString, every type if none are named. Unknown names are logged. */
+uint32 ChromiumResourceTypesToMask(const TArray<FString>& Types);
+
 
 
 /**
@@ -53,11 +65,34 @@ public:
 		return BeforeResourceLoadDelegate;
 	}
 
+	/** Sets the context's request rules, before the context is created. */
+	void SetRequestRules(const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& Rules)
+	{
+		RequestRules = Rules;
+	}
+
+	const TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe>& GetRequestRules() const
+	{
+		return RequestRules;
+	}
+
+	/** @return The context's request filter, which the handlers of its browsers share. */
+	const TSharedRef<FChromiumCEFRequestFilter, ESPMode::ThreadSafe>& GetRequestFilter() const
+	{
+		return RequestFilter;
+	}
+
 private:
 
 	/** Delegate for handling resource load requests */
 	FChromiumOnBeforeContextResourceLoadDelegate BeforeResourceLoadDelegate;
 
+	/** Header rules of the context, applied on the IO thread after the global ones. */
+	TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe> RequestRules;
+
+	/** Blocks and redirects requests of the context on the IO thread. */
+	TSharedRef<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> RequestFilter;
+
 	// Include the default reference counting implementation.
 	IMPLEMENT_REFCOUNTING(FChromiumCEFResourceContextHandler);
 };
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "CEF/ChromiumCEFSchemeHandler.h"
+#include "CEF/ChromiumCEFArchiveSchemeHandler.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "IChromiumWebBrowserSchemeHandler.h"
@@ -156,11 +157,6 @@ public:
 	}
 	// End CefSchemeHandlerFactory interface.
 
-	bool IsUsing(IChromiumWebBrowserSchemeHandlerFactory* InWebBrowserSchemeHandlerFactory)
-	{
-		return WebBrowserSchemeHandlerFactory == InWebBrowserSchemeHandlerFactory;
-	}
-
 private:
 	IChromiumWebBrowserSchemeHandlerFactory* WebBrowserSchemeHandlerFactory;
 
@@ -172,8 +168,11 @@ void FChromiumCefSchemeHandlerFactories::AddSchemeHandlerFactory(FString Scheme,
 {
 	checkf(WebBrowserSchemeHandlerFactory != nullptr, TEXT("WebBrowserSchemeHandlerFactory must be provided."));
 	CefRefPtr<CefSchemeHandlerFactory> Factory = new FChromiumCefSchemeHandlerFactory(WebBrowserSchemeHandlerFactory);
-	CefRegisterSchemeHandlerFactory(TCHAR_TO_WCHAR(*Scheme), TCHAR_TO_WCHAR(*Domain), Factory);
-	SchemeHandlerFactories.Emplace(MoveTemp(Scheme), MoveTemp(Domain), MoveTemp(Factory));
+	if (bRegisteredGlobally)
+	{
+		CefRegisterSchemeHandlerFactory(TCHAR_TO_WCHAR(*Scheme), TCHAR_TO_WCHAR(*Domain), Factory);
+	}
+	SchemeHandlerFactories.Emplace(MoveTemp(Scheme), MoveTemp(Domain), MoveTemp(Factory), WebBrowserSchemeHandlerFactory);
 }
 
 void FChromiumCefSchemeHandlerFactories::RemoveSchemeHandlerFactory(IChromiumWebBrowserSchemeHandlerFactory* WebBrowserSchemeHandlerFactory)
@@ -181,10 +180,43 @@ void FChromiumCefSchemeHandlerFactories::RemoveSchemeHandlerFactory(IChromiumWeb
 	checkf(WebBrowserSchemeHandlerFactory != nullptr, TEXT("WebBrowserSchemeHandlerFactory must be provided."));
 	SchemeHandlerFactories.RemoveAll([WebBrowserSchemeHandlerFactory](const FFactory& Element)
 	{
-		return ((FChromiumCefSchemeHandlerFactory*)Element.Factory.get())->IsUsing(WebBrowserSchemeHandlerFactory);
+		return Element.WebBrowserSchemeHandlerFactory == WebBrowserSchemeHandlerFactory;
 	});
 }
 
+bool FChromiumCefSchemeHandlerFactories::AddArchiveSchemeHandlerFactory(FString Scheme, FString Domain, const FString& ArchiveFilename)
+{
+	TSharedPtr<FChromiumCEFArchive, ESPMode::ThreadSafe> Archive = FChromiumCEFArchive::Open(ArchiveFilename);
+	if (!Archive.IsValid())
+	{
+		return false;
+	}
+
+	RemoveArchiveSchemeHandlerFactory(Scheme, Domain);
+	CefRefPtr<CefSchemeHandlerFactory> Factory = FChromiumCEFArchive::CreateSchemeHandlerFactory(Archive.ToSharedRef());
+	if (bRegisteredGlobally)
+	{
+		CefRegisterSchemeHandlerFactory(TCHAR_TO_WCHAR(*Scheme), TCHAR_TO_WCHAR(*Domain), Factory);
+	}
+	SchemeHandlerFactories.Emplace(MoveTemp(Scheme), MoveTemp(Domain), MoveTemp(Factory), nullptr);
+	return true;
+}
+
+bool FChromiumCefSchemeHandlerFactories::RemoveArchiveSchemeHandlerFactory(const FString& Scheme, const FString& Domain)
+{
+	const int32 NumRemoved = SchemeHandlerFactories.RemoveAll([&Scheme, &Domain](const FFactory& Element)
+	{
+		return Element.WebBrowserSchemeHandlerFactory == nullptr && Element.Scheme == Scheme && Element.Domain == Domain;
+	});
+
+	// The archive stays mapped for as long as CEF holds on to its factory
+	if (NumRemoved > 0 && bRegisteredGlobally)
+	{
+		CefRegisterSchemeHandlerFactory(TCHAR_TO_WCHAR(*Scheme), TCHAR_TO_WCHAR(*Domain), nullptr);
+	}
+	return NumRemoved > 0;
+}
+
 void FChromiumCefSchemeHandlerFactories::RegisterFactoriesWith(CefRefPtr<CefRequestContext>& Context)
 {
 	if (Context)
@@ -196,10 +228,20 @@ void FChromiumCefSchemeHandlerFactories::RegisterFactoriesWith(CefRefPtr<CefRequ
 	}
 }
 
-FChromiumCefSchemeHandlerFactories::FFactory::FFactory(FString InScheme, FString InDomain, CefRefPtr<CefSchemeHandlerFactory> InFactory)
+void FChromiumCefSchemeHandlerFactories::RegisterFactoriesGlobally()
+{
+	bRegisteredGlobally = true;
+	for (const FFactory& SchemeHandlerFactory : SchemeHandlerFactories)
+	{
+		CefRegisterSchemeHandlerFactory(TCHAR_TO_WCHAR(*SchemeHandlerFactory.Scheme), TCHAR_TO_WCHAR(*SchemeHandlerFactory.Domain), SchemeHandlerFactory.Factory);
+	}
+}
+
+FChromiumCefSchemeHandlerFactories::FFactory::FFactory(FString InScheme, FString InDomain, CefRefPtr<CefSchemeHandlerFactory> InFactory, IChromiumWebBrowserSchemeHandlerFactory* InWebBrowserSchemeHandlerFactory)
 	: Scheme(MoveTemp(InScheme))
 	, Domain(MoveTemp(InDomain))
 	, Factory(MoveTemp(InFactory))
+	, WebBrowserSchemeHandlerFactory(InWebBrowserSchemeHandlerFactory)
 {
 }
 
@@ -53,12 +53,33 @@ public:
 	 */
 	void RemoveSchemeHandlerFactory(IChromiumWebBrowserSchemeHandlerFactory* WebBrowserSchemeHandlerFactory);
 
+	/**
+	 * Serves a scheme and domain from a packed web UI archive, see FChromiumCEFArchive.
+	 * @param Scheme                            The scheme name to handle.
+	 * @param Domain                            The domain name to handle on the scheme. Ignored if scheme is not a built in scheme.
+	 * @param ArchiveFilename                   The archive to serve.
+	 * @return false if the archive could not be opened.
+	 */
+	bool AddArchiveSchemeHandlerFactory(FString Scheme, FString Domain, const FString& ArchiveFilename);
+
+	/**
+	 * Stops serving a scheme and domain from an archive. Contexts registered before keep serving it until they are unregistered.
+	 * @return false if no archive was served there.
+	 */
+	bool RemoveArchiveSchemeHandlerFactory(const FString& Scheme, const FString& Domain);
+
 	/**
 	 * Register all scheme handler factories with the provided request context.
 	 * @param Context   The context.
 	 */
 	void RegisterFactoriesWith(CefRefPtr<CefRequestContext>& Context);
 
+	/**
+	 * Register all scheme handler factories globally once CEF is initialized. Factories added before then are only stored,
+	 * later ones are registered straight away.
+	 */
+	void RegisterFactoriesGlobally();
+
 private:
 	/**
 	 * A struct to wrap storage of a factory with it's provided scheme and domain, inc ref counting for the cef representation.
@@ -66,14 +87,19 @@ private:
 	struct FFactory
 	{
 	public:
-		FFactory(FString Scheme, FString Domain, CefRefPtr<CefSchemeHandlerFactory> Factory);
+		FFactory(FString Scheme, FString Domain, CefRefPtr<CefSchemeHandlerFactory> Factory, IChromiumWebBrowserSchemeHandlerFactory* WebBrowserSchemeHandlerFactory);
 		FString Scheme;
 		FString Domain;
 		CefRefPtr<CefSchemeHandlerFactory> Factory;
+		// The factory it wraps, null for built in factories such as archives.
+		IChromiumWebBrowserSchemeHandlerFactory* WebBrowserSchemeHandlerFactory;
 	};
 
 	// Array of registered handler factories.
 	TArray<FFactory> SchemeHandlerFactories;
+
+	// Whether factories are registered globally as they are added.
+	bool bRegisteredGlobally = false;
 };
 
 
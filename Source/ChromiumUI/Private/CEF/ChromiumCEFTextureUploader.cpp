@@ -0,0 +1,201 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CEF/ChromiumCEFTextureUploader.h"
+
+#if WITH_CEF3
+
+#include "Textures/SlateUpdatableTexture.h"
+#include "Textures/SlateShaderResource.h"
+
+#if WITH_ENGINE
+#include "RHI.h"
+#include "RenderingThread.h"
+#include "Slate/SlateTextures.h"
+#endif
+
+FChromiumCEFTextureUploader::FChromiumCEFTextureUploader()
+	: NextSequence(1)
+	, SubmittedCount(0)
+	, GameThreadCycles(0)
+{
+}
+
+FChromiumCEFTextureUploader::~FChromiumCEFTextureUploader()
+{
+	// Pending render commands hold a reference to us, so nothing can still be in flight here.
+	for (FStagingBuffer* Buffer : AllBuffers)
+	{
+		delete Buffer;
+	}
+}
+
+bool FChromiumCEFTextureUploader::CanUpdateInPlace(FSlateUpdatableTexture* Texture, int32 Width, int32 Height)
+{
+#if WITH_ENGINE
+	if (GDynamicRHI == nullptr || Texture == nullptr)
+	{
+		return false;
+	}
+
+	// Only textures backed by an RHI texture can be written by the render thread
+	FSlateShaderResource* SlateResource = Texture->GetSlateResource();
+	return SlateResource != nullptr && SlateResource->GetType() == ESlateShaderResource::NativeTexture
+		&& SlateResource->GetWidth() == (uint32)Width && SlateResource->GetHeight() == (uint32)Height;
+#else
+	return false;
+#endif
+}
+
+FChromiumCEFTextureUploader::FStagingBuffer* FChromiumCEFTextureUploader::AcquireStagingBuffer(int32 Width, int32 Height, int32 NumBytes)
+{
+	check(IsInGameThread());
+	ReclaimRecycledBuffers();
+
+	FStagingBuffer* Buffer = nullptr;
+	for (int32 Index = FreeBuffers.Num() - 1; Index >= 0; --Index)
+	{
+		// Prefer a buffer that is already large enough, so a fixed resolution never reallocates
+		if (FreeBuffers[Index]->Pixels.Max() >= NumBytes)
+		{
+			Buffer = FreeBuffers[Index];
+			FreeBuffers.RemoveAtSwap(Index, 1, false);
+			break;
+		}
+	}
+	if (Buffer == nullptr && FreeBuffers.Num() > 0)
+	{
+		Buffer = FreeBuffers.Pop(false);
+	}
+	if (Buffer == nullptr)
+	{
+		Buffer = new FStagingBuffer();
+		AllBuffers.Add(Buffer);
+	}
+
+	Buffer->Texture = nullptr;
+	Buffer->Width = Width;
+	Buffer->Height = Height;
+	Buffer->Rects.Reset();
+	Buffer->Pixels.SetNumUninitialized(NumBytes, false);
+	return Buffer;
+}
+
+void FChromiumCEFTextureUploader::ReleaseStagingBuffer(FStagingBuffer* Buffer)
+{
+	check(IsInGameThread());
+	if (Buffer != nullptr)
+	{
+		FreeBuffers.Add(Buffer);
+	}
+}
+
+void FChromiumCEFTextureUploader::ReserveStagingBuffers(int32 NumBuffers)
+{
+	check(IsInGameThread());
+	ReclaimRecycledBuffers();
+
+	while (AllBuffers.Num() < NumBuffers)
+	{
+		FStagingBuffer* Buffer = new FStagingBuffer();
+		AllBuffers.Add(Buffer);
+		FreeBuffers.Add(Buffer);
+	}
+}
+
+void FChromiumCEFTextureUploader::FreeUnusedBuffers()
+{
+	check(IsInGameThread());
+	ReclaimRecycledBuffers();
+
+	for (FStagingBuffer* Buffer : FreeBuffers)
+	{
+		AllBuffers.RemoveSwap(Buffer);
+		delete Buffer;
+	}
+	FreeBuffers.Reset();
+}
+
+void FChromiumCEFTextureUploader::Submit(FSlateUpdatableTexture* Texture, FStagingBuffer* Buffer)
+{
+	check(IsInGameThread());
+	check(Buffer != nullptr);
+
+#if WITH_ENGINE
+	Buffer->Texture = Texture;
+	Buffer->Sequence = NextSequence++;
+	PendingUploads.Enqueue(Buffer);
+	SubmittedCount++;
+
+	// The queue carries the data, the command only wakes the render thread up. Limiting it to the buffers submitted so far keeps
+	// each upload ordered with texture creation and release commands enqueued around it.
+	TSharedRef<FChromiumCEFTextureUploader, ESPMode::ThreadSafe> Uploader = AsShared();
+	const uint64 MaxSequence = Buffer->Sequence;
+	ENQUEUE_RENDER_COMMAND(ChromiumProcessPendingUploads)(
+		[Uploader, MaxSequence](FRHICommandListImmediate& RHICmdList)
+		{
+			Uploader->ProcessPendingUploads_RenderThread(MaxSequence);
+		});
+#else
+	checkNoEntry();
+	ReleaseStagingBuffer(Buffer);
+#endif
+}
+
+double FChromiumCEFTextureUploader::GetGameThreadSeconds() const
+{
+	return FPlatformTime::ToSeconds64(GameThreadCycles);
+}
+
+void FChromiumCEFTextureUploader::ProcessPendingUploads_RenderThread(uint64 MaxSequence)
+{
+#if WITH_ENGINE
+	check(IsInRenderingThread());
+
+	FStagingBuffer** Next = nullptr;
+	while ((Next = PendingUploads.Peek()) != nullptr && (*Next)->Sequence <= MaxSequence)
+	{
+		FStagingBuffer* Buffer = *Next;
+		PendingUploads.Pop();
+
+		// CanUpdateInPlace checked the type on submission, the texture may have been replaced by one of another kind since
+		FTexture2DRHIRef TextureRHI;
+		FSlateShaderResource* SlateResource = Buffer->Texture->GetSlateResource();
+		if (SlateResource != nullptr && SlateResource->GetType() == ESlateShaderResource::NativeTexture)
+		{
+			TextureRHI = static_cast<TSlateTexture<FTexture2DRHIRef>*>(SlateResource)->GetTypedResource();
+		}
+		if (TextureRHI.IsValid())
+		{
+			if (Buffer->Rects.Num() == 0)
+			{
+				const FUpdateTextureRegion2D Region(0, 0, 0, 0, Buffer->Width, Buffer->Height);
+				RHIUpdateTexture2D(TextureRHI, 0, Region, Buffer->Width * BytesPerPixel, Buffer->Pixels.GetData());
+			}
+			else
+			{
+				const uint8* RectPixels = Buffer->Pixels.GetData();
+				for (const FIntRect& Rect : Buffer->Rects)
+				{
+					const FUpdateTextureRegion2D Region(Rect.Min.X, Rect.Min.Y, 0, 0, Rect.Width(), Rect.Height());
+					RHIUpdateTexture2D(TextureRHI, 0, Region, Rect.Width() * BytesPerPixel, RectPixels);
+					RectPixels += Rect.Width() * Rect.Height() * BytesPerPixel;
+				}
+			}
+		}
+
+		Buffer->Texture = nullptr;
+		RecycledBuffers.Enqueue(Buffer);
+	}
+#endif
+}
+
+void FChromiumCEFTextureUploader::ReclaimRecycledBuffers()
+{
+	FStagingBuffer* Buffer = nullptr;
+	while (RecycledBuffers.Dequeue(Buffer))
+	{
+		FreeBuffers.Add(Buffer);
+	}
+}
+
+#endif
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_CEF3
+
+#include "Containers/Queue.h"
+
+class FSlateUpdatableTexture;
+
+/**
+ * Moves CEF software paint uploads off the paint callback.
+ * Paints are copied into pooled staging buffers which are handed to the render thread through a lock-free single producer,
+ * single consumer queue. The render thread writes them into the texture and passes the buffers back through a second queue
+ * for reuse, so steady state painting at a fixed resolution neither allocates nor waits on the render thread.
+ *
+ * Used on every platform with an RHI renderer, for textures backed by an RHI texture. Programs without the engine, and
+ * renderers whose textures are not RHI textures, go through UpdateTextureThreadSafeRaw instead, see CanUpdateInPlace.
+ */
+class FChromiumCEFTextureUploader
+	: public TSharedFromThis<FChromiumCEFTextureUploader, ESPMode::ThreadSafe>
+{
+public:
+	/** CEF always paints 32 bit BGRA buffers. */
+	static const int32 BytesPerPixel = 4;
+
+	/** Pixels waiting to be uploaded, either a full frame or a set of packed sub-rectangles. */
+	struct FStagingBuffer
+	{
+		FStagingBuffer()
+			: Texture(nullptr)
+			, Width(0)
+			, Height(0)
+			, Sequence(0)
+		{}
+
+		/** The texture the pixels are written into. */
+		FSlateUpdatableTexture* Texture;
+
+		/** Dimensions of the painted frame. */
+		int32 Width;
+		int32 Height;
+
+		/** Rectangles stored back to back in Pixels. Empty for a full frame. */
+		TArray<FIntRect, TInlineAllocator<8>> Rects;
+
+		/** The staged pixel data. Capacity is kept between uses. */
+		TArray<uint8> Pixels;
+
+		/** Submission order, used to keep uploads ordered with other render commands. */
+		uint64 Sequence;
+	};
+
+	FChromiumCEFTextureUploader();
+	~FChromiumCEFTextureUploader();
+
+	/**
+	 * Checks whether a frame of the given size can be written into the texture by the render thread, which needs an RHI texture
+	 * of that size. Resizes and renderers that do not expose the RHI texture have to go through UpdateTextureThreadSafeRaw instead.
+	 */
+	static bool CanUpdateInPlace(FSlateUpdatableTexture* Texture, int32 Width, int32 Height);
+
+	/**
+	 * Gets a staging buffer with room for the given number of bytes, reusing a recycled buffer when possible.
+	 * Must be called on the game thread. The buffer has to be passed to Submit or ReleaseStagingBuffer.
+	 */
+	FStagingBuffer* AcquireStagingBuffer(int32 Width, int32 Height, int32 NumBytes);
+
+	/** Returns a staging buffer that was not submitted to the pool. */
+	void ReleaseStagingBuffer(FStagingBuffer* Buffer);
+
+	/**
+	 * Makes sure the pool holds at least the given number of buffers, so a consumer holding several frames at once does not
+	 * allocate the first time it fills up. Pixel storage is still sized on first use. Game thread only.
+	 */
+	void ReserveStagingBuffers(int32 NumBuffers);
+
+	/** Frees the staging buffers not currently in use. Game thread only. */
+	void FreeUnusedBuffers();
+
+	/**
+	 * Queues a staging buffer for upload to the texture on the render thread and takes ownership of it.
+	 * The caller must have checked CanUpdateInPlace.
+	 */
+	void Submit(FSlateUpdatableTexture* Texture, FStagingBuffer* Buffer);
+
+	/** Adds time spent staging a paint on the game thread to the running total. */
+	void AddGameThreadCycles(uint64 Cycles) { GameThreadCycles += Cycles; }
+
+	/** @return Total time, in seconds, paint callbacks spent staging uploads on the game thread. */
+	double GetGameThreadSeconds() const;
+
+	/** @return Number of uploads handed to the render thread. */
+	uint64 GetSubmittedCount() const { return SubmittedCount; }
+
+private:
+	/** Writes every queued buffer up to and including MaxSequence into its texture and recycles it. */
+	void ProcessPendingUploads_RenderThread(uint64 MaxSequence);
+
+	/** Pulls buffers recycled by the render thread back into the free list. */
+	void ReclaimRecycledBuffers();
+
+	/** Game thread to render thread. */
+	TQueue<FStagingBuffer*, EQueueMode::Spsc> PendingUploads;
+
+	/** Render thread back to game thread. */
+	TQueue<FStagingBuffer*, EQueueMode::Spsc> RecycledBuffers;
+
+	/** Buffers available for reuse, only touched on the game thread. */
+	TArray<FStagingBuffer*> FreeBuffers;
+
+	/** Every buffer this uploader created, only touched on the game thread and on destruction. */
+	TArray<FStagingBuffer*> AllBuffers;
+
+	uint64 NextSequence;
+	uint64 SubmittedCount;
+	uint64 GameThreadCycles;
+};
+
+#endif
@@ -7,7 +7,10 @@
 #include "Textures/SlateUpdatableTexture.h"
 #include "HAL/PlatformApplicationMisc.h"
 #include "Misc/CommandLine.h"
+#include "Misc/App.h"
+#include "HAL/IConsoleManager.h"
 #include "ChromiumWebBrowserLog.h"
+#include "ChromiumWebBrowserStats.h"
 
 #if WITH_CEF3
 
@@ -17,6 +20,9 @@
 #include "ChromiumCEFJSScripting.h"
 #include "ChromiumCEFImeHandler.h"
 #include "ChromiumCEFWebBrowserWindowRHIHelper.h"
+#include "ChromiumCEFTextureUploader.h"
+#include "ChromiumCEFGameThreadQueue.h"
+#include "ChromiumViewStateReporter.h"
 #include "Async/Async.h"
 
 #if PLATFORM_MAC
@@ -240,6 +246,99 @@ enum KeyboardCode {
 #define USE_BUFFERED_VIDEO 0
 #endif
 
+static int32 CEFBufferedVideoDepth = USE_BUFFERED_VIDEO ? 4 : 0;
+static FAutoConsoleVariableRef CVarCEFBufferedVideoDepth(
+	TEXT("r.CEFBufferedVideoDepth"),
+	CEFBufferedVideoDepth,
+	TEXT("Number of CEF frames buffered per browser and uploaded at most once per engine tick. 0 uploads every paint directly.\n")
+	TEXT("Browsers created with an explicit BufferedVideoDepth ignore this value.\n"),
+	ECVF_Default);
+
+static bool bCEFBufferedVideoLatestFrameWins = true;
+static FAutoConsoleVariableRef CVarCEFBufferedVideoLatestFrameWins(
+	TEXT("r.CEFBufferedVideoLatestFrameWins"),
+	bCEFBufferedVideoLatestFrameWins,
+	TEXT("When buffering CEF frames, present the newest frame each tick and drop older ones instead of presenting every frame in order.\n"),
+	ECVF_Default);
+
+/** Upper bound for buffered video depth, beyond this buffering only adds latency and memory. */
+static const int32 MaxBufferedVideoDepth = 16;
+
+static float CEFHideClippedDelay = 0.5f;
+static FAutoConsoleVariableRef CVarCEFHideClippedDelay(
+	TEXT("r.CEFHideClippedDelay"),
+	CEFHideClippedDelay,
+	TEXT("Seconds a browser widget has to stay clipped out of view or fully transparent before the browser stops rendering.\n")
+	TEXT("It resumes as soon as any part of it is painted visible again. Negative values disable hiding clipped browsers.\n"),
+	ECVF_Default);
+
+/** Lowest render scale a browser can be set to, and the number of steps per unit its applied render scale is rounded to. */
+static const float MinRenderScale = 0.1f;
+static const float RenderScaleSteps = 10.0f;
+
+static bool bCEFFrameRateGovernor = false;
+static FAutoConsoleVariableRef CVarCEFFrameRateGovernor(
+	TEXT("r.CEFFrameRateGovernor"),
+	bCEFFrameRateGovernor,
+	TEXT("Lower the windowless frame rate of browsers that are not painting or receiving input, and raise it again on activity.\n")
+	TEXT("When disabled, the default, every browser runs at the frame rate it was created with.\n"),
+	ECVF_Default);
+
+static int32 CEFIdleFrameRate = 5;
+static FAutoConsoleVariableRef CVarCEFIdleFrameRate(
+	TEXT("r.CEFIdleFrameRate"),
+	CEFIdleFrameRate,
+	TEXT("Windowless frame rate idle browsers are throttled to by r.CEFFrameRateGovernor.\n")
+	TEXT("Browsers created with an explicit MinBrowserFrameRate ignore this value.\n"),
+	ECVF_Default);
+
+static bool bCEFCrashRecovery = true;
+static FAutoConsoleVariableRef CVarCEFCrashRecovery(
+	TEXT("r.CEFCrashRecovery"),
+	bCEFCrashRecovery,
+	TEXT("Bring pages back after their render process crashed, retrying with exponential backoff: the page or LoadString contents\n")
+	TEXT("are loaded again, or the navigation requested in the meantime. When disabled a crash reloads once and then reports an error.\n"),
+	ECVF_Default);
+
+static float CEFCrashRecoveryDelay = 0.5f;
+static FAutoConsoleVariableRef CVarCEFCrashRecoveryDelay(
+	TEXT("r.CEFCrashRecoveryDelay"),
+	CEFCrashRecoveryDelay,
+	TEXT("Seconds r.CEFCrashRecovery waits after a first crash, doubled for every further crash until the page stays up.\n"),
+	ECVF_Default);
+
+static float CEFCrashRecoveryMaxDelay = 30.0f;
+static FAutoConsoleVariableRef CVarCEFCrashRecoveryMaxDelay(
+	TEXT("r.CEFCrashRecoveryMaxDelay"),
+	CEFCrashRecoveryMaxDelay,
+	TEXT("Longest wait between r.CEFCrashRecovery attempts, in seconds.\n"),
+	ECVF_Default);
+
+static int32 CEFCrashRecoveryMaxAttempts = 0;
+static FAutoConsoleVariableRef CVarCEFCrashRecoveryMaxAttempts(
+	TEXT("r.CEFCrashRecoveryMaxAttempts"),
+	CEFCrashRecoveryMaxAttempts,
+	TEXT("Consecutive crashes r.CEFCrashRecovery recovers from before reporting a load error instead. 0 never gives up.\n"),
+	ECVF_Default);
+
+/** Seconds a recovered page has to stay up before a crash is no longer counted as consecutive. */
+static const double CrashRecoveryStableSeconds = 60.0;
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Render Process Crashes"), STAT_ChromiumRenderProcessCrashes, STATGROUP_ChromiumUI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Render Process Crash Recoveries"), STAT_ChromiumCrashRecoveries, STATGROUP_ChromiumUI);
+
+/** Adds the game thread time of the enclosing CEF callback to the window's telemetry. */
+#define CHROMIUM_BROWSER_CALLBACK_SCOPE(Callback) FChromiumCEFBrowserTelemetry::FCallbackScope CallbackScope(Telemetry, FChromiumCEFBrowserTelemetry::ECallback::Callback)
+
+/** Name the page finds the UChromiumViewStateReporter under while CaptureViewState waits for its scroll position. */
+static const TCHAR* const ViewStateReporterName = TEXT("ueviewstate");
+
+/** How long a hidden window's browser is kept for the replies to CaptureViewState, before a page not answering is given up on. */
+static const double ViewStateCaptureTimeoutSeconds = 2.0;
+
+/** Changed whenever a window's GetProcessInfo may answer differently, see GetProcessInfoSerial. */
+static uint32 ProcessInfoSerial = 0;
+
 namespace {
 	// Private helper class to post a callback to GetSource.
 	class FChromiumWebBrowserClosureVisitor
@@ -259,26 +358,72 @@ namespace {
 		TFunction<void (const FString&)> Closure;
 		IMPLEMENT_REFCOUNTING(FChromiumWebBrowserClosureVisitor);
 	};
+
+	// Private helper class collecting the urls of a browser's navigation history, passed to the closure after the last entry.
+	class FChromiumWebBrowserNavigationEntryVisitor
+		: public CefNavigationEntryVisitor
+	{
+	public:
+		FChromiumWebBrowserNavigationEntryVisitor(TFunction<void (const TArray<FString>&, int32)> InClosure)
+			: Closure(InClosure)
+			, CurrentIndex(INDEX_NONE)
+		{ }
+
+		virtual bool Visit(CefRefPtr<CefNavigationEntry> Entry, bool bCurrent, int Index, int Total) override
+		{
+			Urls.Add(WCHAR_TO_TCHAR(Entry->GetURL().ToWString().c_str()));
+			if (bCurrent)
+			{
+				CurrentIndex = Index;
+			}
+			if (Index == Total - 1)
+			{
+				Closure(Urls, CurrentIndex);
+			}
+			return true;
+		}
+
+	private:
+		TFunction<void (const TArray<FString>&, int32)> Closure;
+		TArray<FString> Urls;
+		int32 CurrentIndex;
+		IMPLEMENT_REFCOUNTING(FChromiumWebBrowserNavigationEntryVisitor);
+	};
 }
 
 
 // Private helper class to smooth out video buffering, using a ringbuffer
 // (cef sometimes submits multiple frames per engine frame)
+// Frame pixels live in staging buffers of the window's upload pipeline, which recycles them between the CEF paint side
+// and the render thread, so steady state submission at a fixed resolution does not allocate.
 class FChromiumBrowserBufferedVideo
 {
 public:
-	FChromiumBrowserBufferedVideo(uint32 NumFrames) 
-		: FrameWriteIndex(0)
+	typedef FChromiumCEFTextureUploader::FStagingBuffer FStagingBuffer;
+
+	FChromiumBrowserBufferedVideo(uint32 NumFrames, const TSharedRef<FChromiumCEFTextureUploader, ESPMode::ThreadSafe>& InUploader) 
+		: Uploader(InUploader)
+		, FrameWriteIndex(0)
 		, FrameReadIndex(0)
 		, FrameCountThisEngineTick(0)
 		, FrameCount(0)
 		, FrameNumberOfLastRender(-1)
+		, FramesPresented(0)
+		, FramesDropped(0)
 	{
-		Frames.SetNum(NumFrames);
+		Frames.SetNumZeroed(NumFrames);
+
+		// Leave room for a couple of frames the render thread may still be reading from while the ring is full.
+		Uploader->ReserveStagingBuffers(NumFrames + 2);
 	}
 
 	~FChromiumBrowserBufferedVideo()
 	{
+		for (FStagingBuffer*& Frame : Frames)
+		{
+			Uploader->ReleaseStagingBuffer(Frame);
+			Frame = nullptr;
+		}
 	}
 
 	/**
@@ -294,18 +439,19 @@ public:
 		check(IsInGameThread());
 		check(Buffer != nullptr);
 
-		const uint32 NumBytesPerPixel = 4;
-		FChromiumFrame& Frame = Frames[FrameWriteIndex];
+		const uint32 NumBytesPerPixel = FChromiumCEFTextureUploader::BytesPerPixel;
 
 		// If the write buffer catches up to the read buffer, we need to release the read buffer and increment its index
 		if (FrameWriteIndex == FrameReadIndex && FrameCount > 0)
 		{
-			Frame.ReleaseTextureData();
-			FrameReadIndex = (FrameReadIndex + 1) % Frames.Num();
+			DropOldestFrame();
 		}
 
-		check(Frame.SlateTextureData == nullptr);
-		Frame.SlateTextureData = new FSlateTextureData((uint8*)Buffer, InWidth, InHeight, NumBytesPerPixel);
+		// Staging buffers are reused in full, so the whole frame is copied regardless of the dirty area.
+		FStagingBuffer*& Frame = Frames[FrameWriteIndex];
+		check(Frame == nullptr);
+		Frame = Uploader->AcquireStagingBuffer(InWidth, InHeight, InWidth * InHeight * NumBytesPerPixel);
+		FMemory::Memcpy(Frame->Pixels.GetData(), Buffer, Frame->Pixels.Num());
 
 		FrameWriteIndex = (FrameWriteIndex + 1) % Frames.Num();
 		FrameCount = FMath::Min(Frames.Num(), FrameCount + 1);
@@ -314,55 +460,75 @@ public:
 		return FrameCountThisEngineTick == 1;
 	}
 
-    /**
-     * Called once per frame to get the next frame's texturedata
-     * @return The texture data. Can be nullptr if no frame is available
-     */
-	FSlateTextureData* GetNextFrameTextureData()
+	/**
+	 * Called once per frame to upload the next frame to the texture.
+	 * @param bLatestFrameWins Whether to skip straight to the newest submitted frame, dropping any older ones
+	 * @return The number of bytes uploaded, 0 if no frame was available
+	 */
+	int32 UploadNextFrame(FSlateUpdatableTexture* Texture, bool bLatestFrameWins)
 	{
 		// Grab the next available frame if available. Ensure we don't grab more than one frame per engine tick
 		check(IsInGameThread());
-		FSlateTextureData* SlateTextureData = nullptr;
+		int32 UploadedBytes = 0;
+		while (bLatestFrameWins && FrameCount > 1)
+		{
+			DropOldestFrame();
+		}
+
 		if ( FrameCount > 0 )
 		{
 			// Grab the first frame we haven't submitted yet 
-			FChromiumFrame& Frame = Frames[FrameReadIndex];
-			SlateTextureData = Frame.SlateTextureData;
-			
-			// Set this to NULL because the renderthread is taking ownership
-			Frame.SlateTextureData = nullptr; 
+			FStagingBuffer* Frame = Frames[FrameReadIndex];
+			Frames[FrameReadIndex] = nullptr;
 			FrameReadIndex = (FrameReadIndex + 1) % Frames.Num();
 			FrameCount--;
+
+			UploadedBytes = Frame->Pixels.Num();
+			if (FChromiumCEFTextureUploader::CanUpdateInPlace(Texture, Frame->Width, Frame->Height))
+			{
+				// The render thread takes ownership and recycles the buffer once the texture is updated
+				Uploader->Submit(Texture, Frame);
+			}
+			else
+			{
+				// UpdateTextureThreadSafeRaw copies the pixels before returning and handles resizing the texture,
+				// so the buffer can go straight back to the pool.
+				Texture->UpdateTextureThreadSafeRaw(Frame->Width, Frame->Height, Frame->Pixels.GetData());
+				Uploader->ReleaseStagingBuffer(Frame);
+			}
+			FramesPresented++;
 		}
 		FrameCountThisEngineTick = 0;
-		return SlateTextureData;
+		return UploadedBytes;
 	}
 
+	/** @return The number of frames the ring can hold */
+	int32 GetDepth() const { return Frames.Num(); }
+
+	/** @return The number of submitted frames not yet presented */
+	int32 GetQueuedFrameCount() const { return FrameCount; }
+
+	/** @return The number of frames uploaded to the texture */
+	uint64 GetFramesPresented() const { return FramesPresented; }
+
+	/** @return The number of submitted frames that were replaced by newer ones before being uploaded */
+	uint64 GetFramesDropped() const { return FramesDropped; }
+
 private:
-	struct FChromiumFrame
+	void DropOldestFrame()
 	{
-		FChromiumFrame()
-			: SlateTextureData(nullptr) 
-		{}
-		
-		~FChromiumFrame()
-		{
-			ReleaseTextureData();
-		}
-
-		void ReleaseTextureData()
-		{
-			if (SlateTextureData)
-			{
-				delete SlateTextureData;
-			}
-			SlateTextureData = nullptr;
-		}
+		Uploader->ReleaseStagingBuffer(Frames[FrameReadIndex]);
+		Frames[FrameReadIndex] = nullptr;
+		FrameReadIndex = (FrameReadIndex + 1) % Frames.Num();
+		FrameCount--;
+		FramesDropped++;
+	}
 
-		FSlateTextureData* SlateTextureData;
-	};
+	/** The upload pipeline providing and recycling frame buffers */
+	TSharedRef<FChromiumCEFTextureUploader, ESPMode::ThreadSafe> Uploader;
 
-	TArray<FChromiumFrame> Frames;
+	/** Ring of submitted frames waiting to be uploaded */
+	TArray<FStagingBuffer*> Frames;
 
 	// Read/write position in the ringbuffer
 	int32 FrameWriteIndex;
@@ -371,6 +537,9 @@ private:
 	int32 FrameCountThisEngineTick;
 	int32 FrameCount;
 	int32 FrameNumberOfLastRender;
+
+	uint64 FramesPresented;
+	uint64 FramesDropped;
 };
 
 
@@ -394,6 +563,14 @@ FChromiumCEFWebBrowserWindow::FChromiumCEFWebBrowserWindow(CefRefPtr<CefBrowser>
 	, bIsHidden(false)
 	, bTickedLastFrame(true)
 	, bNeedsResize(false)
+	, bVisibilityReported(false)
+	, bPaintedVisibleLastFrame(false)
+	, bIsClipped(false)
+	, SecondsClipped(0.0f)
+	, RenderScale(1.0f)
+	, bAutomaticRenderScale(false)
+	, ScreenCoverage(1.0f)
+	, AppliedRenderScale(1.0f)
 	, bDraggingWindow(false)
 	, PreviousKeyDownEvent()
 	, PreviousKeyUpEvent()
@@ -405,8 +582,34 @@ FChromiumCEFWebBrowserWindow::FChromiumCEFWebBrowserWindow(CefRefPtr<CefBrowser>
 	, bPopupHasFocus(false)
 	, bSupportsMouseWheel(true)
 	, bRecoverFromRenderProcessCrash(false)
+	, RenderProcessCrashCount(0)
+	, ConsecutiveRenderProcessCrashes(0)
+	, CrashRecoveryTime(0.0)
+	, LastCrashRecoveryTime(0.0)
 	, ErrorCode(0)
 	, bDeferNavigations(false)
+	, bPendingCreation(InBrowser.get() == nullptr)
+	, bDiscarded(false)
+	, LastVisibleTime(FPlatformTime::Seconds())
+	, ViewStateCaptureTime(0.0)
+	, bScrollCapturePending(false)
+	, bHistoryCapturePending(false)
+	, FirstHistoryIndex(0)
+	, HistoryIndex(INDEX_NONE)
+	, LastLoadedContents(InContentsToLoad)
+	, LastLoadedContentsUrl(InUrl)
+	, BufferedVideoDepthOverride(INDEX_NONE)
+	, bFrameRateManaged(false)
+	, bUsingExternalBeginFrame(false)
+	, LastBeginFrameCounter(0)
+	, SecondsSinceBeginFrame(0.0f)
+	, MinFrameRateOverride(INDEX_NONE)
+	, RetiredFramesPresented(0)
+	, RetiredFramesDropped(0)
+	, PaintedBytes(0)
+	, UploadedBytes(0)
+	, ReceivedJSMessageCount(0)
+	, TextureUploader(MakeShared<FChromiumCEFTextureUploader, ESPMode::ThreadSafe>())
 #if PLATFORM_MAC
 	, LastPaintedSharedHandle(nullptr)
 #endif
@@ -416,7 +619,6 @@ FChromiumCEFWebBrowserWindow::FChromiumCEFWebBrowserWindow(CefRefPtr<CefBrowser>
 #endif
 	, RHIRenderHelper(nullptr)
 {
-	check(InBrowser.get() != nullptr);
 	check(!bUsingAcceleratedPaint || CanSupportAcceleratedPaint()); // make sure if accelerated paint is selected we can support it
 
 	UpdatableTextures[0] = nullptr;
@@ -427,9 +629,8 @@ FChromiumCEFWebBrowserWindow::FChromiumCEFWebBrowserWindow(CefRefPtr<CefBrowser>
 		ReleaseTextures();
 	}
 
-#if USE_BUFFERED_VIDEO
-	BufferedVideo = TUniquePtr<FChromiumBrowserBufferedVideo>(new FChromiumBrowserBufferedVideo(4));
-#endif
+	UpdateBufferedVideoDepth();
+	UpdateResourceRouting();
 }
 
 void FChromiumCEFWebBrowserWindow::ReleaseTextures()
@@ -582,7 +783,7 @@ TOptional<FSlateRenderTransform> FChromiumCEFWebBrowserWindow::GetWebBrowserRend
 void FChromiumCEFWebBrowserWindow::SetViewportSize(FIntPoint WindowSize, FIntPoint WindowPos)
 {
 	// SetViewportSize is called from the browser viewport tick method, which means that since we are receiving ticks, we can mark the browser as visible.
-	if (! bIsDisabled)
+	if (! bIsDisabled && !bIsClipped)
 	{
 		SetIsHidden(false);
 	}
@@ -600,6 +801,7 @@ void FChromiumCEFWebBrowserWindow::SetViewportSize(FIntPoint WindowSize, FIntPoi
 		bool bFirstSize = ViewportSize == FIntPoint::ZeroValue;
 		ViewportSize = WindowSize;
 		ViewportDPIScaleFactor = WindowDPIScaleFactor;
+		PublishViewState();
 
 		if (IsValid())
 		{
@@ -1107,6 +1309,7 @@ bool FChromiumCEFWebBrowserWindow::OnKeyDown(const FKeyEvent& InKeyEvent)
 {
 	if (IsValid() && !bIgnoreKeyDownEvent)
 	{
+		FrameRateGovernor.NotifyInput(FPlatformTime::Seconds());
 #if PLATFORM_MAC
 		// Special case for Mac - make sure Cmd+~ is always passed back to the OS
 		if (InKeyEvent.GetKey() == EKeys::Tilde && InKeyEvent.IsControlDown())
@@ -1128,6 +1331,7 @@ bool FChromiumCEFWebBrowserWindow::OnKeyUp(const FKeyEvent& InKeyEvent)
 {
 	if (IsValid() && !bIgnoreKeyUpEvent)
 	{
+		FrameRateGovernor.NotifyInput(FPlatformTime::Seconds());
 #if PLATFORM_MAC
 		// Special case for Mac - make sure Cmd+~ is always passed back to the OS
 		if (InKeyEvent.GetKey() == EKeys::Tilde && InKeyEvent.IsControlDown())
@@ -1149,6 +1353,7 @@ bool FChromiumCEFWebBrowserWindow::OnKeyChar(const FCharacterEvent& InCharacterE
 {
 	if (IsValid() && !bIgnoreCharacterEvent)
 	{
+		FrameRateGovernor.NotifyInput(FPlatformTime::Seconds());
 		PreviousCharacterEvent = InCharacterEvent;
 		CefKeyEvent KeyEvent;
 #if PLATFORM_MAC || PLATFORM_LINUX
@@ -1187,6 +1392,7 @@ FModifierKeysState FChromiumCEFWebBrowserWindow::SlateModifiersFromCefModifiers(
    the widget hierarchy this time around. */
 bool FChromiumCEFWebBrowserWindow::OnUnhandledKeyEvent(const CefKeyEvent& CefEvent)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Other);
 	bool bWasHandled = false;
 	if (IsValid())
 	{
@@ -1277,6 +1483,7 @@ bool FChromiumCEFWebBrowserWindow::OnUnhandledKeyEvent(const CefKeyEvent& CefEve
 
 bool FChromiumCEFWebBrowserWindow::OnJSDialog(CefJSDialogHandler::JSDialogType DialogType, const CefString& MessageText, const CefString& DefaultPromptText, CefRefPtr<CefJSDialogCallback> Callback, bool& OutSuppressMessage)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Other);
 	bool Retval = false;
 	if ( OnShowDialog().IsBound() )
 	{
@@ -1315,6 +1522,7 @@ bool FChromiumCEFWebBrowserWindow::OnJSDialog(CefJSDialogHandler::JSDialogType D
 
 bool FChromiumCEFWebBrowserWindow::OnBeforeUnloadDialog(const CefString& MessageText, bool IsReload, CefRefPtr<CefJSDialogCallback> Callback)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Other);
 	bool Retval = false;
 	if ( OnShowDialog().IsBound() )
 	{
@@ -1349,14 +1557,73 @@ void FChromiumCEFWebBrowserWindow::OnResetDialogState()
 
 void FChromiumCEFWebBrowserWindow::OnRenderProcessTerminated(CefRequestHandler::TerminationStatus Status)
 {
-	if(bRecoverFromRenderProcessCrash)
+	RenderProcessCrashCount++;
+	INC_DWORD_STAT(STAT_ChromiumRenderProcessCrashes);
+
+	if (!bCEFCrashRecovery)
 	{
+		if(bRecoverFromRenderProcessCrash)
+		{
+			bRecoverFromRenderProcessCrash = false;
+			NotifyDocumentError((int)ERR_FAILED); // Only attempt a single recovery at a time
+		}
+
+		bRecoverFromRenderProcessCrash = true;
+		Reload();
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastCrashRecoveryTime >= CrashRecoveryStableSeconds)
+	{
+		ConsecutiveRenderProcessCrashes = 0;
+	}
+	ConsecutiveRenderProcessCrashes++;
+
+	if (CEFCrashRecoveryMaxAttempts > 0 && ConsecutiveRenderProcessCrashes > CEFCrashRecoveryMaxAttempts)
+	{
+		UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Render process for %s terminated (status %d), giving up after %d consecutive crashes"), *CurrentUrl, (int32)Status, ConsecutiveRenderProcessCrashes - 1);
+		CrashRecoveryTime = 0.0;
+		bDeferNavigations = false;
 		bRecoverFromRenderProcessCrash = false;
-		NotifyDocumentError((int)ERR_FAILED); // Only attempt a single recovery at a time
+		NotifyDocumentError((int)ERR_FAILED);
+		return;
+	}
+
+	const float Delay = FMath::Min(FMath::Max(CEFCrashRecoveryDelay, 0.0f) * FMath::Pow(2.0f, ConsecutiveRenderProcessCrashes - 1), CEFCrashRecoveryMaxDelay);
+	CrashRecoveryTime = Now + Delay;
+	UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Render process for %s terminated (status %d, crash %d of this window), recovering in %.1f s"), *CurrentUrl, (int32)Status, RenderProcessCrashCount, Delay);
+
+	// Navigations requested until then are held back and replace the page, an abort in progress will never be confirmed
+	bDeferNavigations = true;
+	PendingAbortUrl.Empty();
+}
+
+void FChromiumCEFWebBrowserWindow::UpdateCrashRecovery()
+{
+	if (CrashRecoveryTime == 0.0 || FPlatformTime::Seconds() < CrashRecoveryTime || !IsValid())
+	{
+		return;
 	}
 
+	CrashRecoveryTime = 0.0;
+	LastCrashRecoveryTime = FPlatformTime::Seconds();
+	bDeferNavigations = false;
 	bRecoverFromRenderProcessCrash = true;
-	Reload();
+	INC_DWORD_STAT(STAT_ChromiumCrashRecoveries);
+
+	// Navigating starts a new render process
+	if (HasPendingNavigation())
+	{
+		ProcessPendingNavigation();
+	}
+	else
+	{
+		FString RestoreUrl;
+		FString RestoreContents;
+		GetRestoreNavigation(RestoreUrl, RestoreContents);
+		RequestNavigationInternal(RestoreUrl, RestoreContents);
+	}
 }
 
 FReply FChromiumCEFWebBrowserWindow::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent, bool bIsPopup)
@@ -1364,6 +1631,7 @@ FReply FChromiumCEFWebBrowserWindow::OnMouseButtonDown(const FGeometry& MyGeomet
 	FReply Reply = FReply::Unhandled();
 	if (IsValid())
 	{
+		FrameRateGovernor.NotifyInput(FPlatformTime::Seconds());
 		FKey Button = MouseEvent.GetEffectingButton();
 		// CEF only supports left, right, and middle mouse buttons
 		bool bIsCefSupportedButton = (Button == EKeys::LeftMouseButton || Button == EKeys::RightMouseButton || Button == EKeys::MiddleMouseButton);
@@ -1394,6 +1662,7 @@ FReply FChromiumCEFWebBrowserWindow::OnMouseButtonUp(const FGeometry& MyGeometry
 	FReply Reply = FReply::Unhandled();
 	if (IsValid())
 	{
+		FrameRateGovernor.NotifyInput(FPlatformTime::Seconds());
 		FKey Button = MouseEvent.GetEffectingButton();
 		// CEF only supports left, right, and middle mouse buttons
 		bool bIsCefSupportedButton = (Button == EKeys::LeftMouseButton || Button == EKeys::RightMouseButton || Button == EKeys::MiddleMouseButton);
@@ -1440,6 +1709,7 @@ FReply FChromiumCEFWebBrowserWindow::OnMouseButtonDoubleClick(const FGeometry& M
 	FReply Reply = FReply::Unhandled();
 	if (IsValid())
 	{
+		FrameRateGovernor.NotifyInput(FPlatformTime::Seconds());
 		FKey Button = MouseEvent.GetEffectingButton();
 		// CEF only supports left, right, and middle mouse buttons
 		bool bIsCefSupportedButton = (Button == EKeys::LeftMouseButton || Button == EKeys::RightMouseButton || Button == EKeys::MiddleMouseButton);
@@ -1463,6 +1733,7 @@ FReply FChromiumCEFWebBrowserWindow::OnMouseMove(const FGeometry& MyGeometry, co
 	FReply Reply = FReply::Unhandled();
 	if (IsValid())
 	{
+		FrameRateGovernor.NotifyInput(FPlatformTime::Seconds());
 		CefMouseEvent Event = GetCefMouseEvent(MyGeometry, MouseEvent, bIsPopup);
 
 		bool bEventConsumedByDragCallback = false;
@@ -1517,6 +1788,7 @@ FReply FChromiumCEFWebBrowserWindow::OnMouseWheel(const FGeometry& MyGeometry, c
 	FReply Reply = FReply::Unhandled();
 	if(IsValid() && bSupportsMouseWheel)
 	{
+		FrameRateGovernor.NotifyInput(FPlatformTime::Seconds());
 		// The original delta is reduced so this should bring it back to what CEF expects
 		// see WindowsApplication.cpp , case WM_MOUSEWHEEL:
 		const float SpinFactor = 120.0f; 
@@ -1567,7 +1839,7 @@ bool FChromiumCEFWebBrowserWindow::CanGoBack() const
 {
 	if (IsValid())
 	{
-		return InternalCefBrowser->CanGoBack();
+		return CanGoBackInBrowser() || RestoredBackUrls.Num() > 0;
 	}
 	return false;
 }
@@ -1576,7 +1848,15 @@ void FChromiumCEFWebBrowserWindow::GoBack()
 {
 	if (IsValid())
 	{
-		InternalCefBrowser->GoBack();
+		if (CanGoBackInBrowser())
+		{
+			InternalCefBrowser->GoBack();
+		}
+		else if (RestoredBackUrls.Num() > 0)
+		{
+			RestoredForwardUrls.Insert(CurrentUrl, 0);
+			ReplaceCurrentEntry(RestoredBackUrls.Pop(false));
+		}
 	}
 }
 
@@ -1584,7 +1864,8 @@ bool FChromiumCEFWebBrowserWindow::CanGoForward() const
 {
 	if (IsValid())
 	{
-		return InternalCefBrowser->CanGoForward();
+		// Forward entries kept from a discarded browser only follow its first page, until the browser has history of its own
+		return InternalCefBrowser->CanGoForward() || (!CanGoBackInBrowser() && RestoredForwardUrls.Num() > 0);
 	}
 	return false;
 }
@@ -1593,7 +1874,16 @@ void FChromiumCEFWebBrowserWindow::GoForward()
 {
 	if (IsValid())
 	{
-		InternalCefBrowser->GoForward();
+		if (InternalCefBrowser->CanGoForward())
+		{
+			InternalCefBrowser->GoForward();
+		}
+		else if (!CanGoBackInBrowser() && RestoredForwardUrls.Num() > 0)
+		{
+			RestoredBackUrls.Add(CurrentUrl);
+			ReplaceCurrentEntry(RestoredForwardUrls[0]);
+			RestoredForwardUrls.RemoveAt(0);
+		}
 	}
 }
 
@@ -1624,7 +1914,11 @@ void FChromiumCEFWebBrowserWindow::StopLoad()
 
 void FChromiumCEFWebBrowserWindow::ExecuteJavascript(const FString& Script)
 {
-	if (IsValid())
+	if (bPendingCreation)
+	{
+		PendingCreationCalls.Add([this, Script]() { ExecuteJavascript(Script); });
+	}
+	else if (IsValid())
 	{
 		CefRefPtr<CefFrame> frame = InternalCefBrowser->GetMainFrame();
 		frame->ExecuteJavaScript(TCHAR_TO_UTF8(*Script), frame->GetURL(), 0);
@@ -1653,18 +1947,21 @@ CefRefPtr<CefBrowser> FChromiumCEFWebBrowserWindow::GetCefBrowser()
 
 void FChromiumCEFWebBrowserWindow::SetTitle(const CefString& InTitle)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Navigation);
 	Title = WCHAR_TO_TCHAR(InTitle.ToWString().c_str());
 	TitleChangedEvent.Broadcast(Title);
 }
 
 void FChromiumCEFWebBrowserWindow::SetUrl(const CefString& Url)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Navigation);
 	CurrentUrl = WCHAR_TO_TCHAR(Url.ToWString().c_str());
 	OnUrlChanged().Broadcast(CurrentUrl);
 }
 
 void FChromiumCEFWebBrowserWindow::SetToolTip(const CefString& CefToolTip)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Other);
 	FString NewToolTipText = WCHAR_TO_TCHAR(CefToolTip.ToWString().c_str());
 	if (ToolTipText != NewToolTipText)
 	{
@@ -1698,6 +1995,7 @@ void FChromiumCEFWebBrowserWindow::NotifyDocumentError(
 	const CefString& ErrorText,
 	const CefString& FailedUrl)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Navigation);
 	FString Url = WCHAR_TO_TCHAR(FailedUrl.ToWString().c_str());
 
 	if (InErrorCode == ERR_ABORTED)
@@ -1743,10 +2041,22 @@ void FChromiumCEFWebBrowserWindow::NotifyDocumentError(int InErrorCode)
 
 void FChromiumCEFWebBrowserWindow::NotifyDocumentLoadingStateChange(bool IsLoading)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Navigation);
+	if (IsLoading && bRecoverFromRenderProcessCrash)
+	{
+		// The page is coming back in a new render process, which may not have been given the permanent bindings yet
+		Scripting->ResendPermanentBindings();
+	}
+
 	if (! IsLoading)
 	{
 		bIsInitialized = true;
 
+		if (FirstHistoryIndex > 0)
+		{
+			UpdateHistoryIndex();
+		}
+
 		if (bRecoverFromRenderProcessCrash)
 		{
 			bRecoverFromRenderProcessCrash = false;
@@ -1757,6 +2067,13 @@ void FChromiumCEFWebBrowserWindow::NotifyDocumentLoadingStateChange(bool IsLoadi
 
 		// Compatibility with Android script bindings: dispatch a custom ue:ready event when the document is fully loaded
 		ExecuteJavascript(TEXT("document.dispatchEvent(new CustomEvent('ue:ready', {details: window.ue}));"));
+
+		if (PendingScrollPosition.IsSet())
+		{
+			// The page of a recreated browser, put it back where it was left
+			ExecuteJavascript(FString::Printf(TEXT("window.scrollTo(%d, %d);"), PendingScrollPosition->X, PendingScrollPosition->Y));
+			PendingScrollPosition.Reset();
+		}
 	}
 
 	// Ignore a load completed notification if there was an error.
@@ -1796,7 +2113,15 @@ void FChromiumCEFWebBrowserWindow::HandleRenderingError()
 
 void FChromiumCEFWebBrowserWindow::OnPaint(CefRenderHandler::PaintElementType Type, const CefRenderHandler::RectList& DirtyRects, const void* Buffer, int Width, int Height)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Paint);
+	Telemetry.NotifyPaint();
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FChromiumCEFWebBrowserWindow_OnPaint);
 	bool bNeedsRedraw = false;
+	if (Type == PET_VIEW)
+	{
+		FrameRateGovernor.NotifyPaint();
+	}
+
 	if (bUsingAcceleratedPaint)
 	{
 		UE_LOG(ChromiumLogWebBrowser, Error, TEXT("Accelerated CEF rendering selected but OnPaint called. Disabling accelerated rendering for this browser window."));
@@ -1823,18 +2148,30 @@ void FChromiumCEFWebBrowserWindow::OnPaint(CefRenderHandler::PaintElementType Ty
 
 	if (UpdatableTextures[Type] != nullptr)
 	{
-		// Note that with more recent versions of CEF, the DirtyRects will always contain a single element, as it merges all dirty areas into a single rectangle before calling OnPaint
-		// In case that should change in the future, we'll simply update the entire area if DirtyRects is not a single element.
-		FIntRect Dirty = (DirtyRects.size() == 1) ? FIntRect(DirtyRects[0].x, DirtyRects[0].y, DirtyRects[0].x + DirtyRects[0].width, DirtyRects[0].y + DirtyRects[0].height) : FIntRect();
+		PaintedBytes += (uint64)Width * Height * 4;
+
+		// CEF may report several disjoint dirty rects (e.g. small animated elements in opposite corners of the page),
+		// so merge them into a bounded set and upload only those instead of the whole frame.
+		DirtyRegion.Build(DirtyRects, Width, Height);
+
+		if (Type == PET_VIEW)
+		{
+			HitTestAlphaMask.Update(DirtyRegion, Width, Height, Buffer);
+		}
 
 		if (Type == PET_VIEW && BufferedVideo.IsValid() )
 		{
 			// If we're using bufferedVideo, submit the frame to it
+			const FIntRect Dirty = (DirtyRegion.GetRects().Num() == 1) ? DirtyRegion.GetRects()[0] : FIntRect();
+			const uint64 StartCycles = FPlatformTime::Cycles64();
 			bNeedsRedraw = BufferedVideo->SubmitFrame(Width, Height, Buffer, Dirty);
+			TextureUploader->AddGameThreadCycles(FPlatformTime::Cycles64() - StartCycles);
 		}
 		else
 		{
-			UpdatableTextures[Type]->UpdateTextureThreadSafeRaw(Width, Height, Buffer, Dirty);
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			UploadedBytes += DirtyRegion.Upload(*TextureUploader, UpdatableTextures[Type], Width, Height, Buffer);
+			TextureUploader->AddGameThreadCycles(FPlatformTime::Cycles64() - StartCycles);
 			HandleRenderingError();
 
 		    if (Type == PET_POPUP && bShowPopupRequested)
@@ -1843,7 +2180,7 @@ void FChromiumCEFWebBrowserWindow::OnPaint(CefRenderHandler::PaintElementType Ty
 			    bPopupHasFocus = true;
 
 				const float DPIScale = FPlatformApplicationMisc::GetDPIScaleFactorAtPoint(PopupPosition.X, PopupPosition.Y);
-			    FIntPoint PopupSize = FIntPoint(Width / DPIScale, Height / DPIScale);
+			    FIntPoint PopupSize = FIntPoint(Width / (DPIScale * AppliedRenderScale), Height / (DPIScale * AppliedRenderScale));
 
 			    FIntRect PopupRect = FIntRect(PopupPosition, PopupPosition + PopupSize);
 			    OnShowPopup().Broadcast(PopupRect);
@@ -1861,7 +2198,14 @@ void FChromiumCEFWebBrowserWindow::OnPaint(CefRenderHandler::PaintElementType Ty
 
 void FChromiumCEFWebBrowserWindow::OnAcceleratedPaint(CefRenderHandler::PaintElementType Type, const CefRenderHandler::RectList& DirtyRects, void* SharedHandle)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Paint);
+	Telemetry.NotifyPaint();
 	bool bNeedsRedraw = false;
+	if (Type == PET_VIEW)
+	{
+		FrameRateGovernor.NotifyPaint();
+	}
+
 	if (!bUsingAcceleratedPaint)
 	{
 		UE_LOG(ChromiumLogWebBrowser, Error, TEXT("Accelerated CEF rendering NOT selected but OnAcceleratedPaint called. Enabling accelerated rendering for this browser window."));
@@ -1906,14 +2250,14 @@ void FChromiumCEFWebBrowserWindow::OnAcceleratedPaint(CefRenderHandler::PaintEle
 #if PLATFORM_WINDOWS
 		if (RHIRenderHelper)
 		{
-			RHIRenderHelper->UpdateSharedHandleTexture(SharedHandle, UpdatableTextures[Type], Dirty.Scale(ViewportDPIScaleFactor));
+			RHIRenderHelper->UpdateSharedHandleTexture(SharedHandle, UpdatableTextures[Type], Dirty.Scale(ViewportDPIScaleFactor * AppliedRenderScale));
 		}
 		else
 		{
-			//UpdatableTextures[Type]->UpdateTextureThreadSafeWithKeyedTextureHandle(SharedHandle, 1, 0, Dirty.Scale(ViewportDPIScaleFactor));
+			//UpdatableTextures[Type]->UpdateTextureThreadSafeWithKeyedTextureHandle(SharedHandle, 1, 0, Dirty.Scale(ViewportDPIScaleFactor * AppliedRenderScale));
 		}
 #else
-		UpdatableTextures[Type]->UpdateTextureThreadSafeWithKeyedTextureHandle(SharedHandle, 1, 0, Dirty.Scale(ViewportDPIScaleFactor));
+		UpdatableTextures[Type]->UpdateTextureThreadSafeWithKeyedTextureHandle(SharedHandle, 1, 0, Dirty.Scale(ViewportDPIScaleFactor * AppliedRenderScale));
 #endif
 
 		bNeedsRedraw = true;
@@ -1923,7 +2267,7 @@ void FChromiumCEFWebBrowserWindow::OnAcceleratedPaint(CefRenderHandler::PaintEle
 			bPopupHasFocus = true;
 
 			const float DPIScale = FPlatformApplicationMisc::GetDPIScaleFactorAtPoint(PopupPosition.X, PopupPosition.Y);
-			FIntPoint PopupSize = FIntPoint(UpdatableTextures[Type]->GetSlateResource()->GetWidth() / DPIScale, UpdatableTextures[Type]->GetSlateResource()->GetHeight() / DPIScale);
+			FIntPoint PopupSize = FIntPoint(UpdatableTextures[Type]->GetSlateResource()->GetWidth() / (DPIScale * AppliedRenderScale), UpdatableTextures[Type]->GetSlateResource()->GetHeight() / (DPIScale * AppliedRenderScale));
 
 			FIntRect PopupRect = FIntRect(PopupPosition, PopupPosition + PopupSize);
 			OnShowPopup().Broadcast(PopupRect);
@@ -1939,21 +2283,135 @@ void FChromiumCEFWebBrowserWindow::OnAcceleratedPaint(CefRenderHandler::PaintEle
 }
 
 
+void FChromiumCEFWebBrowserWindow::SetBufferedVideoDepth(int32 Depth)
+{
+	BufferedVideoDepthOverride = (Depth < 0) ? INDEX_NONE : Depth;
+	UpdateBufferedVideoDepth();
+}
+
+uint64 FChromiumCEFWebBrowserWindow::GetBufferedVideoFramesPresented() const
+{
+	return RetiredFramesPresented + (BufferedVideo.IsValid() ? BufferedVideo->GetFramesPresented() : 0);
+}
+
+uint64 FChromiumCEFWebBrowserWindow::GetBufferedVideoFramesDropped() const
+{
+	return RetiredFramesDropped + (BufferedVideo.IsValid() ? BufferedVideo->GetFramesDropped() : 0);
+}
+
+void FChromiumCEFWebBrowserWindow::UpdateBufferedVideoDepth()
+{
+	const int32 DesiredDepth = FMath::Clamp(BufferedVideoDepthOverride != INDEX_NONE ? BufferedVideoDepthOverride : CEFBufferedVideoDepth, 0, MaxBufferedVideoDepth);
+	const int32 CurrentDepth = BufferedVideo.IsValid() ? BufferedVideo->GetDepth() : 0;
+	if (DesiredDepth == CurrentDepth)
+	{
+		return;
+	}
+
+	if (BufferedVideo.IsValid())
+	{
+		// Present the newest pending frame so the page doesn't stay stale until CEF paints again
+		if (UpdatableTextures[PET_VIEW] != nullptr)
+		{
+			UploadedBytes += BufferedVideo->UploadNextFrame(UpdatableTextures[PET_VIEW], true);
+		}
+		RetiredFramesPresented += BufferedVideo->GetFramesPresented();
+		RetiredFramesDropped += BufferedVideo->GetFramesDropped() + BufferedVideo->GetQueuedFrameCount();
+		BufferedVideo.Reset();
+	}
+
+	if (DesiredDepth > 0)
+	{
+		BufferedVideo = MakeUnique<FChromiumBrowserBufferedVideo>(DesiredDepth, TextureUploader);
+	}
+}
+
 void FChromiumCEFWebBrowserWindow::UpdateVideoBuffering()
 {
+	UpdateBufferedVideoDepth();
+
 	if (BufferedVideo.IsValid() && UpdatableTextures[PET_VIEW] != nullptr )
 	{
-		FSlateTextureData* SlateTextureData = BufferedVideo->GetNextFrameTextureData();
-		if (SlateTextureData != nullptr )
+		const int32 FrameBytes = BufferedVideo->UploadNextFrame(UpdatableTextures[PET_VIEW], bCEFBufferedVideoLatestFrameWins);
+		if (FrameBytes > 0)
 		{
-			UpdatableTextures[PET_VIEW]->UpdateTextureThreadSafeWithTextureData(SlateTextureData);
+			UploadedBytes += FrameBytes;
 			HandleRenderingError();
 		}
 	}
 }
 
-void FChromiumCEFWebBrowserWindow::OnCursorChange(CefCursorHandle CefCursor, CefRenderHandler::CursorType Type, const CefCursorInfo& CustomCursorInfo)
+void FChromiumCEFWebBrowserWindow::SetFrameRateLimits(int32 MinFrameRate, int32 MaxFrameRate)
 {
+	bFrameRateManaged = MaxFrameRate > 0;
+	MinFrameRateOverride = (MinFrameRate <= 0) ? INDEX_NONE : MinFrameRate;
+	if (!bFrameRateManaged)
+	{
+		return;
+	}
+
+	FrameRateGovernor.SetLimits(MinFrameRateOverride != INDEX_NONE ? MinFrameRateOverride : CEFIdleFrameRate, MaxFrameRate);
+	if (IsValid())
+	{
+		InternalCefBrowser->GetHost()->SetWindowlessFrameRate(FrameRateGovernor.GetFrameRate());
+	}
+}
+
+void FChromiumCEFWebBrowserWindow::UpdateFrameRate()
+{
+	if (!bFrameRateManaged || !IsValid())
+	{
+		return;
+	}
+
+	// Follow changes to r.CEFIdleFrameRate
+	const int32 MaxFrameRate = FrameRateGovernor.GetMaxFrameRate();
+	const int32 MinFrameRate = FMath::Clamp(MinFrameRateOverride != INDEX_NONE ? MinFrameRateOverride : CEFIdleFrameRate, 1, MaxFrameRate);
+	if (MinFrameRate != FrameRateGovernor.GetMinFrameRate())
+	{
+		FrameRateGovernor.SetLimits(MinFrameRate, MaxFrameRate);
+		InternalCefBrowser->GetHost()->SetWindowlessFrameRate(FrameRateGovernor.GetFrameRate());
+		return;
+	}
+
+	const int32 NewFrameRate = FrameRateGovernor.Update(FPlatformTime::Seconds(), bCEFFrameRateGovernor);
+	if (NewFrameRate != INDEX_NONE)
+	{
+		InternalCefBrowser->GetHost()->SetWindowlessFrameRate(NewFrameRate);
+	}
+}
+
+void FChromiumCEFWebBrowserWindow::SendExternalBeginFrame(float DeltaTime)
+{
+	if (!bUsingExternalBeginFrame || bIsHidden || !IsValid())
+	{
+		// Start the next visible period with a frame straight away, one second covers the interval of any frame rate
+		SecondsSinceBeginFrame = 1.0f;
+		return;
+	}
+
+	if (LastBeginFrameCounter == GFrameCounter)
+	{
+		return;
+	}
+
+	// CEF ignores the windowless frame rate once frames are driven externally, so pace them here. Half an engine frame of slack
+	// keeps a browser running at the engine's frame rate from skipping frames because of timing jitter.
+	SecondsSinceBeginFrame += DeltaTime;
+	const float FrameInterval = 1.0f / FMath::Max(FrameRateGovernor.GetFrameRate(), 1);
+	if (bFrameRateManaged && SecondsSinceBeginFrame < FrameInterval - DeltaTime * 0.5f)
+	{
+		return;
+	}
+
+	LastBeginFrameCounter = GFrameCounter;
+	SecondsSinceBeginFrame = 0.0f;
+	InternalCefBrowser->GetHost()->SendExternalBeginFrame();
+}
+
+void FChromiumCEFWebBrowserWindow::OnCursorChange(CefCursorHandle CefCursor, CefRenderHandler::CursorType Type, const CefCursorInfo& CustomCursorInfo, const TSharedPtr<void, ESPMode::ThreadSafe>& CursorOwner)
+{
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Other);
 	switch (Type) {
 		// Map the basic 3 cursor types directly to Slate types on all platforms
 		case CT_NONE:
@@ -2038,13 +2496,38 @@ void FChromiumCEFWebBrowserWindow::OnCursorChange(CefCursorHandle CefCursor, Cef
 			break;
 		#endif
 	}
+	// Only let go of the previous copy once the platform cursor no longer shows it
+	CursorCopy = CursorOwner;
+
 	// Tell Slate to update the cursor now
 	FSlateApplication::Get().QueryCursor();
 }
 
+TSharedPtr<void, ESPMode::ThreadSafe> FChromiumCEFWebBrowserWindow::CopyCursor(CefCursorHandle Cursor, CefRenderHandler::CursorType Type)
+{
+#if PLATFORM_WINDOWS
+	// Other cursor types are shared system cursors, which are never destroyed
+	if (Type == CT_CUSTOM && Cursor != nullptr)
+	{
+		HCURSOR Copy = (HCURSOR)::CopyIcon(Cursor);
+		if (Copy != nullptr)
+		{
+			return MakeShareable<void>(Copy, [](void* Owned)
+			{
+				::DestroyIcon((HICON)Owned);
+			});
+		}
+	}
+#endif
+	return nullptr;
+}
+
 
 bool FChromiumCEFWebBrowserWindow::OnBeforeBrowse( CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, bool user_gesture, bool bIsRedirect )
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Navigation);
+	// Delegates handed out since the last navigation have been bound by now, or are not going to be
+	UpdateResourceRouting();
 	if (InternalCefBrowser != nullptr && InternalCefBrowser->IsSame(Browser))
 	{
 		CefRefPtr<CefFrame> MainFrame = InternalCefBrowser->GetMainFrame();
@@ -2122,13 +2605,25 @@ FString ChromiumURLRequestSTatusToString(const CefResourceRequestHandler::URLReq
 	return StatusStr;
 }
 
+void FChromiumCEFWebBrowserWindow::UpdateResourceRouting(bool bMayBindBeforeResourceLoad, bool bMayBindLoadUrl)
+{
+	if (WebBrowserHandler.get() != nullptr)
+	{
+		WebBrowserHandler->SetResourceRouting(
+			bMayBindBeforeResourceLoad || BeforeResourceLoadDelegate.IsBound(),
+			bMayBindLoadUrl || ContentsToLoad.IsSet() || LoadUrlDelegate.IsBound());
+	}
+}
+
 void FChromiumCEFWebBrowserWindow::HandleOnBeforeResourceLoad(const CefString& URL, CefRequest::ResourceType Type, FRequestHeaders& AdditionalHeaders)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(ResourceLoad);
 	BeforeResourceLoadDelegate.ExecuteIfBound(WCHAR_TO_TCHAR(URL.ToWString().c_str()), ChromiumResourceTypeToString(Type), AdditionalHeaders);
 }
 
 void FChromiumCEFWebBrowserWindow::HandleOnResourceLoadComplete(const CefString& URL, CefRequest::ResourceType Type, CefResourceRequestHandler::URLRequestStatus Status, int64 ContentLength)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(ResourceLoad);
 	ResourceLoadCompleteDelegate.ExecuteIfBound(WCHAR_TO_TCHAR(URL.ToWString().c_str()), ChromiumResourceTypeToString(Type), ChromiumURLRequestSTatusToString(Status), ContentLength);
 }
 
@@ -2156,23 +2651,26 @@ EChromiumWebBrowserConsoleLogSeverity CefLogSeverityToWebBrowser(cef_log_severit
 
 void FChromiumCEFWebBrowserWindow::HandleOnConsoleMessage(CefRefPtr<CefBrowser> Browser, cef_log_severity_t Level, const CefString& Message, const CefString& Source, int Line)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Console);
 	ConsoleMessageDelegate.ExecuteIfBound(WCHAR_TO_TCHAR(Message.ToWString().c_str()), WCHAR_TO_TCHAR(Source.ToWString().c_str()), Line, CefLogSeverityToWebBrowser(Level));
 }
 
 TOptional<FString> FChromiumCEFWebBrowserWindow::GetResourceContent( CefRefPtr< CefFrame > Frame, CefRefPtr< CefRequest > Request)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(ResourceLoad);
 	if (ContentsToLoad.IsSet())
 	{
 		FString Contents = ContentsToLoad.GetValue();
 		ContentsToLoad.Reset();
+		UpdateResourceRouting();
 		return Contents;
 	}
-	if (OnLoadUrl().IsBound())
+	if (LoadUrlDelegate.IsBound())
 	{
 		FString Method = WCHAR_TO_TCHAR(Request->GetMethod().ToWString().c_str());
 		FString Url = WCHAR_TO_TCHAR(Request->GetURL().ToWString().c_str());
 		FString Response;
-		if ( OnLoadUrl().Execute(Method, Url, Response))
+		if (LoadUrlDelegate.Execute(Method, Url, Response))
 		{
 			return Response;
 		}
@@ -2379,6 +2877,9 @@ void FChromiumCEFWebBrowserWindow::UpdateCachedGeometry(const FGeometry& Allotte
 
 void FChromiumCEFWebBrowserWindow::CheckTickActivity()
 {
+	// Keeps what the context menu and navigation decisions depend on current, along with the view
+	PublishViewState();
+
 	// Early out if we're currently hidden, not initialized or currently loading.
 	if (bIsHidden || !IsValid() || IsLoading() || ViewportSize == FIntPoint::ZeroValue)
 	{
@@ -2393,17 +2894,110 @@ void FChromiumCEFWebBrowserWindow::CheckTickActivity()
 	{
 		SetIsHidden(true);
 	}
-	else if(bNeedsResize)
+	else
 	{
-		bNeedsResize = false;
-		InternalCefBrowser->GetHost()->WasResized();
+		UpdateRenderScale();
+
+		if (bNeedsResize)
+		{
+			bNeedsResize = false;
+			InternalCefBrowser->GetHost()->WasResized();
+		}
+
+		// Still ticking, but a widget that stays clipped away or transparent doesn't need the browser to render either.
+		// Only hiding after a delay keeps browsers flickering in and out of view from constantly switching.
+		if (bVisibilityReported && CEFHideClippedDelay >= 0.0f)
+		{
+			SecondsClipped = bPaintedVisibleLastFrame ? 0.0f : SecondsClipped + FApp::GetDeltaTime();
+			if (SecondsClipped > CEFHideClippedDelay)
+			{
+				bIsClipped = true;
+				SetIsHidden(true);
+			}
+		}
 	}
 
 	bTickedLastFrame = false;
+	bPaintedVisibleLastFrame = false;
+}
+
+void FChromiumCEFWebBrowserWindow::SetRenderScale(float Scale, bool bAutomatic)
+{
+	RenderScale = FMath::Clamp(Scale, MinRenderScale, 1.0f);
+	bAutomaticRenderScale = bAutomatic;
+}
+
+void FChromiumCEFWebBrowserWindow::PublishViewState()
+{
+	if (WebBrowserHandler.get() != nullptr)
+	{
+		WebBrowserHandler->PublishViewState();
+	}
+}
+
+void FChromiumCEFWebBrowserWindow::UpdateRenderScale()
+{
+	float DesiredRenderScale = RenderScale * (bAutomaticRenderScale ? FMath::Min(ScreenCoverage, 1.0f) : 1.0f);
+
+	// Every change makes CEF re-raster the whole page, so only move in coarse steps
+	DesiredRenderScale = FMath::Clamp(FMath::RoundToFloat(DesiredRenderScale * RenderScaleSteps) / RenderScaleSteps, MinRenderScale, 1.0f);
+	if (DesiredRenderScale == AppliedRenderScale)
+	{
+		return;
+	}
+
+	AppliedRenderScale = DesiredRenderScale;
+	PublishViewState();
+	InternalCefBrowser->GetHost()->NotifyScreenInfoChanged();
+	bNeedsResize = true;
+}
+
+void FChromiumCEFWebBrowserWindow::ReportVisibleArea(float VisibleArea)
+{
+	bVisibilityReported = true;
+	if (VisibleArea <= 0.0f)
+	{
+		return;
+	}
+
+	bPaintedVisibleLastFrame = true;
+	if (bIsClipped)
+	{
+		// Resume straight away, the texture is already on screen
+		bIsClipped = false;
+		SecondsClipped = 0.0f;
+		if (!bIsDisabled)
+		{
+			SetIsHidden(false);
+		}
+	}
+}
+
+void FChromiumCEFWebBrowserWindow::SetHitTestAlphaEnabled(bool bEnable)
+{
+	const bool bWasEnabled = HitTestAlphaMask.IsEnabled();
+	HitTestAlphaMask.SetEnabled(bEnable);
+
+	// The mask is only built from paints, so ask for a full one to seed it.
+	if (bEnable && !bWasEnabled && IsValid())
+	{
+		InternalCefBrowser->GetHost()->Invalidate(PET_VIEW);
+	}
+}
+
+bool FChromiumCEFWebBrowserWindow::GetHitTestAlpha(FIntPoint Pixel, uint8& OutAlpha) const
+{
+	return HitTestAlphaMask.GetAlpha(Pixel.X, Pixel.Y, OutAlpha);
 }
 
 void FChromiumCEFWebBrowserWindow::RequestNavigationInternal(FString Url, FString Contents)
 {
+	if (bPendingCreation)
+	{
+		PendingCreationCalls.Add([this, Url, Contents]() { RequestNavigationInternal(Url, Contents); });
+		return;
+	}
+
 	if (!IsValid())
 	{
 		return;
@@ -2413,7 +3007,10 @@ void FChromiumCEFWebBrowserWindow::RequestNavigationInternal(FString Url, FStrin
 	if (MainFrame.get() != nullptr)
 	{
 		ContentsToLoad = Contents.IsEmpty() ? TOptional<FString>() : Contents;
+		UpdateResourceRouting();
 		PendingLoadUrl = Url;
+		LastLoadedContents = ContentsToLoad;
+		LastLoadedContentsUrl = Url;
 
 		if (!bDeferNavigations)
 		{
@@ -2456,6 +3053,22 @@ void FChromiumCEFWebBrowserWindow::SetIsHidden(bool bValue)
 		return;
 	}
 	bIsHidden = bValue;
+	if (bIsHidden)
+	{
+		// Hidden windows are not ticked, start the next visible period with a frame straight away
+		SecondsSinceBeginFrame = 1.0f;
+		LastVisibleTime = FPlatformTime::Seconds();
+	}
+	else
+	{
+		// What was captured while hidden goes stale once the page is shown
+		ViewStateCaptureTime = 0.0;
+		if (bDiscarded)
+		{
+			RecreateDiscardedBrowser();
+		}
+	}
+	TickActiveChangedDelegate.ExecuteIfBound(IsTickActive());
 	if ( IsValid() )
 	{
 		CefRefPtr<CefBrowserHost> BrowserHost = InternalCefBrowser->GetHost();
@@ -2537,11 +3150,59 @@ CefRefPtr<CefDictionaryValue> FChromiumCEFWebBrowserWindow::GetProcessInfo()
 	return Retval;
 }
 
+uint32 FChromiumCEFWebBrowserWindow::GetProcessInfoSerial()
+{
+	return ProcessInfoSerial;
+}
+
+void FChromiumCEFWebBrowserWindow::UpdateTelemetry(double Now)
+{
+	Telemetry.SetUploadedBytes(UploadedBytes);
+	Telemetry.SetJSMessages(ReceivedJSMessageCount + Scripting->GetSentMessageCount());
+	Telemetry.Sample(Now);
+}
+
+int32 FChromiumCEFWebBrowserWindow::GetRenderProcessClientId() const
+{
+	if (IsValid())
+	{
+		// CEF builds frame identifiers from the id Chromium gave the render process hosting the frame and the frame's routing id
+		CefRefPtr<CefFrame> MainFrame = InternalCefBrowser->GetMainFrame();
+		if (MainFrame.get() != nullptr)
+		{
+			return (int32)(MainFrame->GetIdentifier() >> 32);
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FChromiumCEFWebBrowserWindow::GetStats(FChromiumWebBrowserWindowStats& OutStats) const
+{
+	Telemetry.GetStats(OutStats);
+
+	OutStats.TextureMemoryBytes = 0;
+	for (FSlateUpdatableTexture* Texture : UpdatableTextures)
+	{
+		if (Texture != nullptr && Texture->GetSlateResource() != nullptr)
+		{
+			OutStats.TextureMemoryBytes += (uint64)Texture->GetSlateResource()->GetWidth() * Texture->GetSlateResource()->GetHeight() * FChromiumCEFTextureUploader::BytesPerPixel;
+		}
+	}
+
+	OutStats.ResourceRequestsInFlight = WebBrowserHandler.get() != nullptr ? WebBrowserHandler->GetResourceRequestsInFlight() : 0;
+	return true;
+}
+
 bool FChromiumCEFWebBrowserWindow::OnProcessMessageReceived(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> frame, CefProcessId SourceProcess, CefRefPtr<CefProcessMessage> Message)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(JSBridge);
 	bool bHandled = Scripting->OnProcessMessageReceived(Browser, SourceProcess, Message);
 
-	if (!bHandled)
+	if (bHandled)
+	{
+		++ReceivedJSMessageCount;
+	}
+	else
 	{
 #if !PLATFORM_LINUX
 		bHandled = Ime->OnProcessMessageReceived(Browser, SourceProcess, Message);
@@ -2551,14 +3212,63 @@ bool FChromiumCEFWebBrowserWindow::OnProcessMessageReceived(CefRefPtr<CefBrowser
 	return bHandled;
 }
 
+bool FChromiumCEFWebBrowserWindow::HandlesProcessMessage(CefRefPtr<CefProcessMessage> Message)
+{
+	const FString MessageName = WCHAR_TO_TCHAR(Message->GetName().ToWString().c_str());
+#if !PLATFORM_LINUX
+	if (FChromiumCEFImeHandler::HandlesProcessMessage(MessageName))
+	{
+		return true;
+	}
+#endif
+	return FChromiumCEFJSScripting::HandlesProcessMessage(MessageName);
+}
+
 void FChromiumCEFWebBrowserWindow::BindUObject(const FString& Name, UObject* Object, bool bIsPermanent)
 {
+	if (bPendingCreation)
+	{
+		// The renderer can only be told about the binding once the browser exists
+		TWeakObjectPtr<UObject> WeakObject(Object);
+		PendingCreationCalls.Add([this, Name, WeakObject, bIsPermanent]()
+		{
+			if (UObject* PendingObject = WeakObject.Get())
+			{
+				BindUObject(Name, PendingObject, bIsPermanent);
+			}
+		});
+		return;
+	}
+
 	Scripting->BindUObject(Name, Object, bIsPermanent);
+	if (bIsPermanent)
+	{
+		++ProcessInfoSerial;
+	}
 }
 
 void FChromiumCEFWebBrowserWindow::UnbindUObject(const FString& Name, UObject* Object, bool bIsPermanent)
 {
+	if (bPendingCreation)
+	{
+		const bool bHasObject = Object != nullptr;
+		TWeakObjectPtr<UObject> WeakObject(Object);
+		PendingCreationCalls.Add([this, Name, bHasObject, WeakObject, bIsPermanent]()
+		{
+			UObject* PendingObject = WeakObject.Get();
+			if (!bHasObject || PendingObject != nullptr)
+			{
+				UnbindUObject(Name, PendingObject, bIsPermanent);
+			}
+		});
+		return;
+	}
+
 	Scripting->UnbindUObject(Name, Object, bIsPermanent);
+	if (bIsPermanent)
+	{
+		++ProcessInfoSerial;
+	}
 }
 
 void FChromiumCEFWebBrowserWindow::BindInputMethodSystem(ITextInputMethodSystem* TextInputMethodSystem)
@@ -2592,6 +3302,254 @@ void FChromiumCEFWebBrowserWindow::OnBrowserClosed()
 	Ime->UnbindCefBrowser();
 #endif
 	InternalCefBrowser = nullptr;
+	++ProcessInfoSerial;
+}
+
+void FChromiumCEFWebBrowserWindow::OnBrowserCreated(CefRefPtr<CefBrowser> Browser)
+{
+	check(bPendingCreation && Browser.get() != nullptr);
+	bPendingCreation = false;
+
+	InternalCefBrowser = Browser;
+	Scripting->BindCefBrowser(Browser);
+#if !PLATFORM_LINUX
+	Ime->BindCefBrowser(Browser);
+#endif
+
+	++ProcessInfoSerial;
+
+	// Catch the browser up with the state the widget set while it was being created
+	CefRefPtr<CefBrowserHost> BrowserHost = Browser->GetHost();
+	SetParentWindow(ParentWindow.Pin());
+	PublishViewState();
+	if (ViewportSize != FIntPoint::ZeroValue)
+	{
+		BrowserHost->WasResized();
+	}
+	if (bIsHidden)
+	{
+		// SetIsHidden only talks to CEF on a change
+		bIsHidden = false;
+		SetIsHidden(true);
+	}
+	if (bFrameRateManaged)
+	{
+		BrowserHost->SetWindowlessFrameRate(FrameRateGovernor.GetFrameRate());
+	}
+	if (bMainHasFocus && !bPopupHasFocus)
+	{
+		BrowserHost->SendFocusEvent(true);
+	}
+
+	TArray<TFunction<void()>> Calls = MoveTemp(PendingCreationCalls);
+	for (TFunction<void()>& Call : Calls)
+	{
+		Call();
+	}
+}
+
+bool FChromiumCEFWebBrowserWindow::CanDiscard() const
+{
+	return IsValid() && bIsHidden && !bPendingCreation && !bIsClosing && !bRecoverFromRenderProcessCrash && CrashRecoveryTime == 0.0 && RecreateBrowserDelegate.IsBound();
+}
+
+bool FChromiumCEFWebBrowserWindow::IsViewStateCapturePending() const
+{
+	return (bScrollCapturePending || bHistoryCapturePending) && FPlatformTime::Seconds() - ViewStateCaptureTime < ViewStateCaptureTimeoutSeconds;
+}
+
+bool FChromiumCEFWebBrowserWindow::HasCapturedViewState() const
+{
+	return ViewStateCaptureTime != 0.0 && !IsViewStateCapturePending();
+}
+
+void FChromiumCEFWebBrowserWindow::Discard()
+{
+	check(CanDiscard());
+
+	// The page comes back first once the window is shown, ahead of any calls made while discarded.
+	// Permanent bindings are resent as the new browser may share a render process that never had them.
+	FString RestoreUrl;
+	FString RestoreContents;
+	GetRestoreNavigation(RestoreUrl, RestoreContents);
+	PendingCreationCalls.Insert([this, RestoreUrl, RestoreContents]()
+	{
+		Scripting->ResendPermanentBindings();
+		RequestNavigationInternal(RestoreUrl, RestoreContents);
+	}, 0);
+
+	CefRefPtr<CefBrowserHost> Host = InternalCefBrowser->GetHost();
+	Scripting->UnbindCefBrowser();
+#if !PLATFORM_LINUX
+	Ime->UnbindCefBrowser();
+#endif
+	InternalCefBrowser = nullptr;
+	++ProcessInfoSerial;
+	// The browser recreated for the window starts without the pooled about:blank entry
+	FirstHistoryIndex = 0;
+	HistoryIndex = INDEX_NONE;
+	bDiscarded = true;
+	bPendingCreation = true;
+	bIsInitialized = false;
+
+	ReleaseTextures();
+	if (BufferedVideo.IsValid())
+	{
+		RetiredFramesPresented += BufferedVideo->GetFramesPresented();
+		RetiredFramesDropped += BufferedVideo->GetFramesDropped() + BufferedVideo->GetQueuedFrameCount();
+		BufferedVideo.Reset();
+	}
+	TextureUploader->FreeUnusedBuffers();
+
+	// The handler only passes on the close of the browser this window currently shows, so this does not close the window
+	CefPostTask(TID_UI, new FChromiumCEFBrowserClosureTask(nullptr, [=]()
+	{
+		Host->CloseBrowser(true);
+	}));
+}
+
+void FChromiumCEFWebBrowserWindow::RecreateDiscardedBrowser()
+{
+	check(bDiscarded && !IsValid());
+
+	if (!CreateInitialTextures())
+	{
+		ReleaseTextures();
+	}
+
+	TWeakPtr<FChromiumCEFWebBrowserWindow> WeakThis = SharedThis(this);
+	WebBrowserHandler->OnBrowserCreated().BindLambda([WeakThis](CefRefPtr<CefBrowser> CreatedBrowser)
+	{
+		TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = WeakThis.Pin();
+		if (!BrowserWindow.IsValid())
+		{
+			CreatedBrowser->GetHost()->CloseBrowser(true);
+			return;
+		}
+		BrowserWindow->OnBrowserCreated(CreatedBrowser);
+	});
+
+	if (!RecreateBrowserDelegate.Execute(WebBrowserHandler))
+	{
+		// Stay discarded, the next time the window is shown tries again
+		UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Failed to recreate the discarded browser for %s"), *CurrentUrl);
+		WebBrowserHandler->OnBrowserCreated().Unbind();
+		return;
+	}
+
+	bDiscarded = false;
+	RestoredBackUrls = MoveTemp(SavedBackUrls);
+	RestoredForwardUrls = MoveTemp(SavedForwardUrls);
+	PendingScrollPosition = SavedScrollPosition;
+	SavedScrollPosition.Reset();
+}
+
+void FChromiumCEFWebBrowserWindow::CaptureViewState()
+{
+	if (!IsValid() || !RecreateBrowserDelegate.IsBound())
+	{
+		return;
+	}
+
+	// The page answers through the JS bridge. The binding and the script go to the page's frame in order, so the script finds it.
+	if (!ViewStateReporter.IsValid())
+	{
+		ViewStateReporter.Reset(NewObject<UChromiumViewStateReporter>());
+		ViewStateReporter->OnScrollPositionReported.BindSP(this, &FChromiumCEFWebBrowserWindow::HandleScrollPositionReported);
+	}
+	Scripting->BindUObject(ViewStateReporterName, ViewStateReporter.Get(), false);
+	const FString ReporterName = Scripting->GetBindingName(ViewStateReporterName, ViewStateReporter.Get());
+	const FString MethodName = Scripting->GetBindingName(ViewStateReporter->FindFunction(GET_FUNCTION_NAME_CHECKED(UChromiumViewStateReporter, ReportScrollPosition)));
+	ExecuteJavascript(FString::Printf(TEXT("window.ue['%s']['%s'](Math.round(window.scrollX), Math.round(window.scrollY));"), *ReporterName, *MethodName));
+	ViewStateCaptureTime = FPlatformTime::Seconds();
+	bScrollCapturePending = true;
+	bHistoryCapturePending = true;
+
+	TWeakPtr<FChromiumCEFWebBrowserWindow> WeakThis = SharedThis(this);
+	InternalCefBrowser->GetHost()->GetNavigationEntries(new FChromiumWebBrowserNavigationEntryVisitor([WeakThis](const TArray<FString>& Urls, int32 CurrentIndex)
+	{
+		FChromiumCEFGameThreadQueue::Run([WeakThis, Urls, CurrentIndex]()
+		{
+			TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = WeakThis.Pin();
+			if (BrowserWindow.IsValid())
+			{
+				BrowserWindow->HandleNavigationEntries(Urls, CurrentIndex);
+			}
+		});
+	}), false);
+}
+
+void FChromiumCEFWebBrowserWindow::HandleScrollPositionReported(int32 X, int32 Y)
+{
+	SavedScrollPosition = FIntPoint(X, Y);
+	bScrollCapturePending = false;
+	Scripting->UnbindUObject(ViewStateReporterName, ViewStateReporter.Get(), false);
+}
+
+void FChromiumCEFWebBrowserWindow::HandleNavigationEntries(const TArray<FString>& Urls, int32 CurrentIndex)
+{
+	bHistoryCapturePending = false;
+	if (!Urls.IsValidIndex(CurrentIndex))
+	{
+		return;
+	}
+
+	// History this browser inherited from a discarded one continues before its own
+	SavedBackUrls = RestoredBackUrls;
+	for (int32 Index = FirstHistoryIndex; Index < CurrentIndex; ++Index)
+	{
+		SavedBackUrls.Add(Urls[Index]);
+	}
+
+	SavedForwardUrls.Reset();
+	for (int32 Index = CurrentIndex + 1; Index < Urls.Num(); ++Index)
+	{
+		SavedForwardUrls.Add(Urls[Index]);
+	}
+	if (Urls.Num() - FirstHistoryIndex <= 1)
+	{
+		SavedForwardUrls.Append(RestoredForwardUrls);
+	}
+}
+
+void FChromiumCEFWebBrowserWindow::UpdateHistoryIndex()
+{
+	TWeakPtr<FChromiumCEFWebBrowserWindow> WeakThis = SharedThis(this);
+	InternalCefBrowser->GetHost()->GetNavigationEntries(new FChromiumWebBrowserNavigationEntryVisitor([WeakThis](const TArray<FString>& Urls, int32 CurrentIndex)
+	{
+		FChromiumCEFGameThreadQueue::Run([WeakThis, CurrentIndex]()
+		{
+			TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = WeakThis.Pin();
+			if (BrowserWindow.IsValid())
+			{
+				BrowserWindow->HistoryIndex = CurrentIndex;
+			}
+		});
+	}), false);
+}
+
+bool FChromiumCEFWebBrowserWindow::CanGoBackInBrowser() const
+{
+	return InternalCefBrowser->CanGoBack() && (FirstHistoryIndex == 0 || HistoryIndex > FirstHistoryIndex);
+}
+
+void FChromiumCEFWebBrowserWindow::GetRestoreNavigation(FString& OutUrl, FString& OutContents) const
+{
+	if (LastLoadedContents.IsSet() && LastLoadedContentsUrl == CurrentUrl)
+	{
+		OutUrl = LastLoadedContentsUrl;
+		OutContents = LastLoadedContents.GetValue();
+	}
+	else
+	{
+		OutUrl = CurrentUrl;
+		OutContents.Reset();
+	}
+}
+
+void FChromiumCEFWebBrowserWindow::ReplaceCurrentEntry(const FString& Url)
+{
+	ExecuteJavascript(FString::Printf(TEXT("window.location.replace(\"%s\");"), *Url.ReplaceCharWithEscapedChar()));
 }
 
 void FChromiumCEFWebBrowserWindow::SetPopupMenuPosition(CefRect CefPopupSize)
@@ -2629,6 +3587,7 @@ void FChromiumCEFWebBrowserWindow::OnImeCompositionRangeChanged(
 
 void FChromiumCEFWebBrowserWindow::UpdateDragRegions(const TArray<FChromiumWebBrowserDragRegion>& Regions)
 {
+	CHROMIUM_BROWSER_CALLBACK_SCOPE(Other);
 	DragRegions = Regions;
 }
 
@@ -7,12 +7,17 @@
 #include "Input/Events.h"
 #include "Input/Reply.h"
 #include "Widgets/SViewport.h"
+#include "UObject/StrongObjectPtr.h"
 #include "ChromiumWebBrowserSingleton.h"
 
 #if WITH_CEF3
 
 #include "IChromiumWebBrowserWindow.h"
 #include "ChromiumCEFBrowserHandler.h"
+#include "ChromiumCEFDirtyRegion.h"
+#include "ChromiumCEFAlphaMask.h"
+#include "ChromiumCEFFrameRateGovernor.h"
+#include "ChromiumCEFBrowserTelemetry.h"
 
 
 #include "ChromiumCEFLibCefIncludes.h"
@@ -37,6 +42,7 @@ class FChromiumWebJSScripting;
 class FChromiumCEFImeHandler;
 class ITextInputMethodSystem;
 class FChromiumCEFWebBrowserWindowRHIHelper;
+class UChromiumViewStateReporter;
 
 #if WITH_CEF3
 
@@ -87,7 +93,7 @@ private:
 	/**
 	 * Creates and initializes a new instance.
 	 *
-	 * @param Browser The CefBrowser object representing this browser window.
+	 * @param Browser The CefBrowser object representing this browser window, or nullptr when CEF is still creating it asynchronously.
 	 * @param Handler Pointer to the CEF handler for this window.
 	 * @param Url The Initial URL that will be loaded.
 	 * @param ContentsToLoad Optional string to load as a web page.
@@ -111,6 +117,12 @@ public:
 	bool IsThumbMouseButtonNavigationEnabled() const { return bThumbMouseButtonNavigation; }
 	bool UseTransparency() const { return bUseTransparency; }
 	bool UsingAcceleratedPaint() const { return bUsingAcceleratedPaint; }
+
+	/** @return true if the browser was created with external begin frames and is rendered from the engine tick. */
+	bool UsingExternalBeginFrame() const { return bUsingExternalBeginFrame; }
+
+	/** Records whether the browser was created with external begin frames. Must match the CefWindowInfo it was created with. */
+	void SetUsingExternalBeginFrame(bool bValue) { bUsingExternalBeginFrame = bValue; }
 	
 public:
 
@@ -196,6 +208,8 @@ public:
 
 	virtual FOnLoadUrl& OnLoadUrl() override
 	{
+		// The delegate may be bound through the reference
+		UpdateResourceRouting(false, true);
 		return LoadUrlDelegate;
 	}
 
@@ -226,6 +240,8 @@ public:
 			WebBrowserHandler->OnBeforeResourceLoad().BindSP(this, &FChromiumCEFWebBrowserWindow::HandleOnBeforeResourceLoad);
 		}
 
+		// The delegate may be bound through the reference
+		UpdateResourceRouting(true, false);
 		return BeforeResourceLoadDelegate;
 	}
 
@@ -371,8 +387,17 @@ private:
 	 * Called when cursor would change due to web browser interaction.
 	 *
 	 * @param Cursor Handle to CEF mouse cursor.
+	 * @param CursorOwner Keeps Cursor alive if it is a copy made by CopyCursor, held for as long as the cursor is shown.
+	 */
+	void OnCursorChange(CefCursorHandle Cursor, CefRenderHandler::CursorType Type, const CefCursorInfo& CustomCursorInfo, const TSharedPtr<void, ESPMode::ThreadSafe>& CursorOwner = nullptr);
+
+	/**
+	 * Copies a cursor CEF passed to OnCursorChange, for handing it to the game thread. CEF destroys custom cursors once it moves on
+	 * to another, so those are duplicated where the platform hands out cursor handles. Safe to call from any thread.
+	 *
+	 * @return The owner of the copy, which destroys it once released. Null if the cursor can be used as it is.
 	 */
-	void OnCursorChange(CefCursorHandle Cursor, CefRenderHandler::CursorType Type, const CefCursorInfo& CustomCursorInfo);
+	static TSharedPtr<void, ESPMode::ThreadSafe> CopyCursor(CefCursorHandle Cursor, CefRenderHandler::CursorType Type);
 
 	/**
 	 * Called when a message was received from the renderer process.
@@ -384,6 +409,9 @@ private:
 	 */
 	bool OnProcessMessageReceived(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> frame, CefProcessId SourceProcess, CefRefPtr<CefProcessMessage> Message);
 
+	/** @return Whether the message is one OnProcessMessageReceived handles, so it can be claimed before reaching the game thread. Safe to call from any thread. */
+	static bool HandlesProcessMessage(CefRefPtr<CefProcessMessage> Message);
+
 	/**
 	 * Called before browser navigation.
 	 *
@@ -397,6 +425,15 @@ private:
 	bool OnBeforeBrowse(CefRefPtr<CefBrowser> Browser, CefRefPtr<CefFrame> Frame, CefRefPtr<CefRequest> Request, bool user_gesture, bool bIsRedirect);
 
 	void HandleOnBeforeResourceLoad(const CefString& URL, CefRequest::ResourceType Type, FRequestHeaders& AdditionalHeaders);
+
+	/**
+	 * Tells the handler which resource requests have to wait for the game thread, so the others continue on the IO thread.
+	 * Delegates handed out by reference may be bound after the call, so their accessors pass true until the next update.
+	 *
+	 * @param bMayBindBeforeResourceLoad Whether the OnBeforeResourceLoad delegate is being handed out.
+	 * @param bMayBindLoadUrl Whether the OnLoadUrl delegate is being handed out.
+	 */
+	void UpdateResourceRouting(bool bMayBindBeforeResourceLoad = false, bool bMayBindLoadUrl = false);
 	void HandleOnResourceLoadComplete(const CefString& URL, CefRequest::ResourceType Type, CefResourceRequestHandler::URLRequestStatus Status, int64 ContentLength);
 	void HandleOnConsoleMessage(CefRefPtr<CefBrowser> Browser, cef_log_severity_t Level, const CefString& Message, const CefString& Source, int Line);
 
@@ -460,6 +497,66 @@ private:
 	 */
 	void OnBrowserClosed();
 
+	/**
+	 * Called once CEF created the browser of a window that was handed out before its browser existed.
+	 * Binds the browser and replays the navigations and bindings requested in the meantime, in order.
+	 */
+	void OnBrowserCreated(CefRefPtr<CefBrowser> Browser);
+
+	/** @return Whether this window is still waiting for CEF to create its browser. */
+	bool IsPendingCreation() const { return bPendingCreation; }
+
+	/** @return Whether the window needs the per-tick work done by the singleton, which hidden windows skip until shown again. */
+	bool IsTickActive() const { return !bIsHidden; }
+
+	/** Called with the new IsTickActive value whenever it changes. */
+	DECLARE_DELEGATE_OneParam(FOnTickActiveChanged, bool /*bActive*/);
+	FOnTickActiveChanged& OnTickActiveChanged() { return TickActiveChangedDelegate; }
+
+	/** Called to create a new browser for a discarded window, through the window's handler. Bound by the singleton. */
+	DECLARE_DELEGATE_RetVal_OneParam(bool, FOnRecreateBrowser, CefRefPtr<FChromiumCEFBrowserHandler> /*Handler*/);
+	FOnRecreateBrowser& OnRecreateBrowser() { return RecreateBrowserDelegate; }
+
+	/** @return Whether the browser may be discarded: it is hidden, fully created and can be recreated later. */
+	bool CanDiscard() const;
+
+	/**
+	 * Closes the browser and releases the textures to save memory. The page, its scroll position, its navigation history and the
+	 * permanent UObject bindings are kept, and the browser is recreated with them once the window is shown again.
+	 * Calls made in the meantime are queued as they are while a browser is being created.
+	 */
+	void Discard();
+
+	/**
+	 * Asks the page for its scroll position and navigation history, which Discard keeps for the recreated browser. Called by the
+	 * memory governor ahead of discarding a browser, so pages that are never discarded are not asked.
+	 */
+	void CaptureViewState();
+
+	/**
+	 * @return Whether the scroll position or history asked for by CaptureViewState are still on their way. Discarding the
+	 * browser before they arrive would lose them. A page that has not answered within a few seconds is taken not to.
+	 */
+	bool IsViewStateCapturePending() const;
+
+	/** @return Whether CaptureViewState has run since the window was last shown and is done, answered or not. */
+	bool HasCapturedViewState() const;
+
+	/** @return Whether the browser was discarded and has not been recreated since. */
+	bool IsDiscarded() const { return bDiscarded; }
+
+	/**
+	 * Hides the about:blank entry a pooled browser committed before it was handed out, so the first page loaded into it has no
+	 * back entry. Called by the singleton before that page is loaded.
+	 */
+	void HideInitialHistoryEntry() { FirstHistoryIndex = 1; }
+
+	/** @return When the window was last visible, in FPlatformTime::Seconds. */
+	double GetLastVisibleTime() const { return bIsHidden ? LastVisibleTime : FPlatformTime::Seconds(); }
+
+	/** @return Whether Browser is the browser currently shown by this window, as opposed to one it discarded. */
+	bool IsCurrentCefBrowser(CefRefPtr<CefBrowser> Browser) const { return InternalCefBrowser.get() != nullptr && InternalCefBrowser->IsSame(Browser); }
+
 	/**
 	 * Called to set the popup menu location. Note that CEF also passes a size to this method,
 	 * which is ignored as the correct size is usually not known until inside OnPaint.
@@ -534,17 +631,111 @@ public:
 	 */
 	void CheckTickActivity() override;
 
+	// IChromiumWebBrowserWindow visibility
+	void ReportVisibleArea(float VisibleArea) override;
+
+	// IChromiumWebBrowserWindow render scale
+	void SetRenderScale(float Scale, bool bAutomatic) override;
+	void ReportScreenCoverage(float Coverage) override { ScreenCoverage = Coverage; }
+
+	/** @return The fraction of the displayed resolution CEF currently renders at. */
+	float GetRenderScale() const { return AppliedRenderScale; }
+
+	// IChromiumWebBrowserWindow hit testing
+	void SetHitTestAlphaEnabled(bool bEnable) override;
+	bool GetHitTestAlpha(FIntPoint Pixel, uint8& OutAlpha) const override;
+
+	// IChromiumWebBrowserWindow telemetry
+	bool GetStats(FChromiumWebBrowserWindowStats& OutStats) const override;
+
+	/** Called by the singleton about once a second. Turns the counts kept since the last sample into the rates reported by GetStats. */
+	void UpdateTelemetry(double Now);
+
+	/** @return Chromium's id for the render process of the main frame, which its command line carries, or INDEX_NONE. */
+	int32 GetRenderProcessClientId() const;
+
+	/** Stores the render process figures reported by GetStats, found by the singleton's background process scan. */
+	void SetRenderProcessStats(uint32 ProcessId, uint64 MemoryBytes, float CpuPercent) { Telemetry.SetRenderProcess(ProcessId, MemoryBytes, CpuPercent); }
+
+	/** Counts a resource request that waited for the game thread on its way to GetResourceContent. */
+	void NotifyResourceHop(double Seconds) { Telemetry.NotifyResourceHop(Seconds); }
+
+	/** @return Time spent in this window's callbacks on the game thread, in milliseconds per second. */
+	float GetGameThreadMillisecondsPerSecond() const { return Telemetry.GetGameThreadMillisecondsPerSecond(); }
+
 	/**
 	* Called from the engine tick.
 	*/
 	void UpdateVideoBuffering();
 
+	/**
+	 * Sets how many CEF frames are buffered and uploaded at most once per engine tick.
+	 *
+	 * @param Depth Number of buffered frames, 0 to upload every paint directly or INDEX_NONE to follow r.CEFBufferedVideoDepth.
+	 */
+	void SetBufferedVideoDepth(int32 Depth);
+
+	/** @return Number of buffered frames uploaded to the texture. */
+	uint64 GetBufferedVideoFramesPresented() const;
+
+	/** @return Number of buffered frames replaced by newer ones before they were uploaded. */
+	uint64 GetBufferedVideoFramesDropped() const;
+
+	/**
+	 * Sets the range the windowless frame rate adapts in.
+	 *
+	 * @param MinFrameRate Rate used while the page is idle, INDEX_NONE to follow r.CEFIdleFrameRate.
+	 * @param MaxFrameRate Rate used while the page receives input or animates, 0 or less for browsers that are not windowless.
+	 */
+	void SetFrameRateLimits(int32 MinFrameRate, int32 MaxFrameRate);
+
+	/** @return The idle frame rate requested for this window, INDEX_NONE if it follows r.CEFIdleFrameRate. */
+	int32 GetMinFrameRateOverride() const { return MinFrameRateOverride; }
+
+	/** @return The frame rate used while the page is active, 0 if the frame rate is not managed. */
+	int32 GetMaxFrameRate() const { return bFrameRateManaged ? FrameRateGovernor.GetMaxFrameRate() : 0; }
+
+	/** @return The windowless frame rate currently requested from CEF. */
+	int32 GetFrameRate() const { return FrameRateGovernor.GetFrameRate(); }
+
+	/**
+	* Called from the engine tick. Adapts the windowless frame rate to recent paint and input activity.
+	*/
+	void UpdateFrameRate();
+
+	/**
+	 * Called from the engine tick. Asks CEF to produce a frame when using external begin frames.
+	 * Sends at most one begin frame per engine frame, none while hidden, and no more often than the current windowless frame rate.
+	 */
+	void SendExternalBeginFrame(float DeltaTime);
+
+	/**
+	 * Called from the engine tick. Brings the page back once the backoff after a render process crash has passed.
+	 * See r.CEFCrashRecovery.
+	 */
+	void UpdateCrashRecovery();
+
+	/** @return Number of times the render process of this window terminated abnormally. */
+	int32 GetRenderProcessCrashCount() const { return RenderProcessCrashCount; }
+
 	/**
 	 * Called on every browser window when CEF launches a new render process.
 	 * Used to ensure global JS objects are registered as soon as possible.
 	 */
 	CefRefPtr<CefDictionaryValue> GetProcessInfo();
 
+	/** @return A count that changes whenever the process info of any window may have changed. Game thread only. */
+	static uint32 GetProcessInfoSerial();
+
+	/** @return Total number of bytes CEF painted into this window's software buffers. */
+	uint64 GetPaintedBytes() const { return PaintedBytes; }
+
+	/** @return Total number of bytes submitted for texture upload, after restricting uploads to the dirty regions of each paint. */
+	uint64 GetUploadedBytes() const { return UploadedBytes; }
+
+	/** @return Total time, in seconds, paint callbacks spent staging texture uploads on the game thread. */
+	double GetPaintUploadSeconds() const { return TextureUploader->GetGameThreadSeconds(); }
+
 private:
 
 	/** @return the currently valid renderer, if available */
@@ -568,9 +759,42 @@ private:
 	/** Executes navigation on a pending deferred navigation */
 	void ProcessPendingNavigation();
 
+	/** Creates, resizes or removes the frame buffer to match the configured buffered video depth */
+	void UpdateBufferedVideoDepth();
+
 	/** Helper that calls WasHidden on the CEF host object when the value changes */
 	void SetIsHidden(bool bValue);
 
+	/** Called by the page with the scroll position requested by CaptureViewState. */
+	void HandleScrollPositionReported(int32 X, int32 Y);
+
+	/** Called with the navigation history requested by CaptureViewState. */
+	void HandleNavigationEntries(const TArray<FString>& Urls, int32 CurrentIndex);
+
+	/** Hands the handler what CEF's UI thread may ask about the view, see FChromiumCEFBrowserHandler::PublishViewState. */
+	void PublishViewState();
+
+	/** Asks the browser for its current history index, which CanGoBackInBrowser needs once entries are hidden. */
+	void UpdateHistoryIndex();
+
+	/** @return Whether the browser has a back entry of its own that is not hidden. */
+	bool CanGoBackInBrowser() const;
+
+	/** Creates a new browser for a discarded window that is being shown. */
+	void RecreateDiscardedBrowser();
+
+	/**
+	 * Navigates the current history entry to Url without adding an entry, used to walk history kept from a discarded browser.
+	 * This runs location.replace in the page, so it does nothing while the page has not loaded or its script is not running.
+	 */
+	void ReplaceCurrentEntry(const FString& Url);
+
+	/** Gets the page to load to bring the window back: the current url, or the LoadString contents it is showing. */
+	void GetRestoreNavigation(FString& OutUrl, FString& OutContents) const;
+
+	/** Asks CEF to re-render at a new scale factor when the requested render scale or the widget's screen coverage changed */
+	void UpdateRenderScale();
+
 	/** Used by the key down and up handlers to convert Slate key events to the CEF equivalent. */
 	void PopulateCefKeyEvent(const FKeyEvent& InKeyEvent, CefKeyEvent& OutKeyEvent);
 
@@ -696,6 +920,9 @@ private:
 	/** Tracks the current mouse cursor */
 	EMouseCursor::Type Cursor;
 
+	/** Owner of the copy of a custom cursor that is currently shown, see CopyCursor. */
+	TSharedPtr<void, ESPMode::ThreadSafe> CursorCopy;
+
 	/** Tracks whether the widget is currently disabled or not*/
 	bool bIsDisabled;
 
@@ -708,6 +935,28 @@ private:
 	/** Tracks whether the widget has been resized and needs to be refreshed */
 	bool bNeedsResize;
 
+	/** Whether the widget has ever reported its visible area. Browsers displayed some other way are never hidden as clipped. */
+	bool bVisibilityReported;
+
+	/** Whether the widget was painted with a visible area since the last CheckTickActivity. */
+	bool bPaintedVisibleLastFrame;
+
+	/** Whether the browser is hidden because its widget is ticking but has been clipped or transparent for too long. */
+	bool bIsClipped;
+
+	/** How long the widget has been ticking without any visible area. */
+	float SecondsClipped;
+
+	/** Render scale requested through SetRenderScale. */
+	float RenderScale;
+	bool bAutomaticRenderScale;
+
+	/** Last on screen coverage reported by the widget. */
+	float ScreenCoverage;
+
+	/** Render scale CEF was last told about through the screen info. */
+	float AppliedRenderScale;
+
 	/** Tracks whether or not the user initiated a window drag by clicking on a page's drag region. */
 	bool bDraggingWindow;
 
@@ -731,6 +980,16 @@ private:
 	/** This is set to true when reloading after render process crash. */
 	bool bRecoverFromRenderProcessCrash;
 
+	/** Number of abnormal render process terminations, in total and since the page last stayed up. */
+	int32 RenderProcessCrashCount;
+	int32 ConsecutiveRenderProcessCrashes;
+
+	/** When the page is brought back after a render process crash, 0 if no recovery is scheduled. In FPlatformTime::Seconds. */
+	double CrashRecoveryTime;
+
+	/** When the page was last brought back after a crash, in FPlatformTime::Seconds. */
+	double LastCrashRecoveryTime;
+
 	int ErrorCode;
 
 	/** Used to defer navigations */
@@ -742,7 +1001,103 @@ private:
 	/** Used to store the url of pending navigation requests while we need to defer navigations. */
 	FString PendingLoadUrl;
 
+	/** Set while the browser of this window is still being created asynchronously. */
+	bool bPendingCreation;
+
+	/** Navigation, script and binding calls made while the browser was being created, replayed in order once it exists. */
+	TArray<TFunction<void()>> PendingCreationCalls;
+
+	/** Set while the browser is discarded, until it is recreated. */
+	bool bDiscarded;
+
+	/** When the window was last hidden, in FPlatformTime::Seconds. */
+	double LastVisibleTime;
+
+	/** When CaptureViewState last ran, 0 if it has not since the window was shown, and which of its replies have not arrived yet. */
+	double ViewStateCaptureTime;
+	bool bScrollCapturePending;
+	bool bHistoryCapturePending;
+
+	/** Bound to the page while CaptureViewState waits for its scroll position. */
+	TStrongObjectPtr<UChromiumViewStateReporter> ViewStateReporter;
+
+	/** Index of the first history entry shown, entries before it were committed before the window got its browser from the pool. */
+	int32 FirstHistoryIndex;
+
+	/** The browser's current history index as of the last load, INDEX_NONE until known. Only kept while FirstHistoryIndex is set. */
+	int32 HistoryIndex;
+
+	/** Creates the browser of a discarded window again. */
+	FOnRecreateBrowser RecreateBrowserDelegate;
+
+	/** Contents of the last LoadString and the url they were loaded as, so a discarded page can be loaded again. */
+	TOptional<FString> LastLoadedContents;
+	FString LastLoadedContentsUrl;
+
+	/** Scroll position last reported by the page after CaptureViewState. */
+	TOptional<FIntPoint> SavedScrollPosition;
+
+	/** Scroll position to apply once the page of a recreated browser has loaded. */
+	TOptional<FIntPoint> PendingScrollPosition;
+
+	/** Navigation history around the current entry, as of the last CaptureViewState. Back entries are oldest first, forward entries nearest first. */
+	TArray<FString> SavedBackUrls;
+	TArray<FString> SavedForwardUrls;
+
+	/**
+	 * History of a discarded browser, which its replacement cannot be given. GoBack and GoForward walk it once the browser runs out
+	 * of its own entries. Back entries are oldest first, forward entries nearest first.
+	 */
+	TArray<FString> RestoredBackUrls;
+	TArray<FString> RestoredForwardUrls;
+
 	TUniquePtr<FChromiumBrowserBufferedVideo> BufferedVideo;
+
+	/** Tells the singleton when the window is hidden or shown. */
+	FOnTickActiveChanged TickActiveChangedDelegate;
+
+	/** Buffered video depth requested for this window, INDEX_NONE to follow r.CEFBufferedVideoDepth. */
+	int32 BufferedVideoDepthOverride;
+
+	/** Picks the windowless frame rate from recent activity. */
+	FChromiumCEFFrameRateGovernor FrameRateGovernor;
+
+	/** Whether SetFrameRateLimits gave this window a frame rate to manage. */
+	bool bFrameRateManaged;
+
+	/** Whether CEF waits for SendExternalBeginFrame before producing frames. */
+	bool bUsingExternalBeginFrame;
+
+	/** Engine frame the last begin frame was sent on, and time accumulated since. */
+	uint64 LastBeginFrameCounter;
+	float SecondsSinceBeginFrame;
+
+	/** Idle frame rate requested for this window, INDEX_NONE to follow r.CEFIdleFrameRate. */
+	int32 MinFrameRateOverride;
+
+	/** Frame statistics of buffered video rings that have since been resized or removed. */
+	uint64 RetiredFramesPresented;
+	uint64 RetiredFramesDropped;
+
+	/** Merged dirty rectangles of the last software paint, reused between paints to avoid allocating. */
+	FChromiumCEFDirtyRegion DirtyRegion;
+
+	/** Downsampled alpha of the view, maintained from software paints for mouse transparency hit tests. */
+	FChromiumCEFAlphaMask HitTestAlphaMask;
+
+	/** Running totals of painted versus uploaded bytes, see GetPaintedBytes and GetUploadedBytes. */
+	uint64 PaintedBytes;
+	uint64 UploadedBytes;
+
+	/** Number of JS bridge messages received from the renderer, the sent ones are counted by Scripting. */
+	uint64 ReceivedJSMessageCount;
+
+	/** Paint, upload, JS bridge and callback time rates reported by GetStats. */
+	FChromiumCEFBrowserTelemetry Telemetry;
+
+	/** Pipeline handing software paints to the render thread for upload. */
+	TSharedRef<FChromiumCEFTextureUploader, ESPMode::ThreadSafe> TextureUploader;
+
 #if PLATFORM_MAC
 	void *LastPaintedSharedHandle;
 #endif
@@ -92,6 +92,36 @@ FSlateUpdatableTexture *FChromiumCEFWebBrowserWindowRHIHelper::CreateTexture(voi
 #endif
 }
 
+TSharedPtr<void, ESPMode::ThreadSafe> FChromiumCEFWebBrowserWindowRHIHelper::RetainSharedHandle(void* SharedHandle)
+{
+#if WITH_ENGINE && PLATFORM_WINDOWS
+	if (!BUseRHIRenderer())
+	{
+		return nullptr;
+	}
+
+	// The device is free threaded, unlike its immediate context
+	TRefCountPtr<ID3D11Device1> Device1;
+	ID3D11Device* D3D11Device = static_cast<ID3D11Device*>(GDynamicRHI->RHIGetNativeDevice());
+	if (FAILED(D3D11Device->QueryInterface(__uuidof(ID3D11Device1), (void**)Device1.GetInitReference())))
+	{
+		return nullptr;
+	}
+
+	ID3D11Texture2D* Texture = nullptr;
+	if (FAILED(Device1->OpenSharedResource1(SharedHandle, __uuidof(ID3D11Texture2D), (void**)&Texture)))
+	{
+		return nullptr;
+	}
+	return MakeShareable<void>(Texture, [](void* Retained)
+	{
+		static_cast<ID3D11Texture2D*>(Retained)->Release();
+	});
+#else
+	return nullptr;
+#endif
+}
+
 void FChromiumCEFWebBrowserWindowRHIHelper::UpdateSharedHandleTexture(void *SharedHandle, FSlateUpdatableTexture* SlateTexture, const FIntRect& DirtyIn)
 {
 #if WITH_ENGINE
@@ -26,6 +26,14 @@ public:
 	static bool BUseRHIRenderer();
 	FSlateUpdatableTexture* CreateTexture(void *ShareHandle);
 	void UpdateSharedHandleTexture(void* SharedHandle, FSlateUpdatableTexture* SlateTexture, const FIntRect& DirtyIn);
+
+	/**
+	 * Takes a reference to the texture behind a handle passed to OnAcceleratedPaint, which keeps the handle valid after CEF's
+	 * callback has returned. Safe to call from any thread.
+	 *
+	 * @return The reference, released along with the returned pointer. Null if the texture could not be opened.
+	 */
+	static TSharedPtr<void, ESPMode::ThreadSafe> RetainSharedHandle(void* SharedHandle);
 	void UpdateCachedGeometry(const FGeometry& AllottedGeometry);
 	TOptional<FSlateRenderTransform> GetWebBrowserRenderTransform() const;
 
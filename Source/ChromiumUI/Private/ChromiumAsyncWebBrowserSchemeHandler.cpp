@@ -0,0 +1,318 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ChromiumAsyncWebBrowserSchemeHandler.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "Misc/ScopeLock.h"
+
+/** What a FChromiumAsyncWebBrowserSchemeHandler shares with its task, which may outlive it. */
+class FChromiumAsyncSchemeState
+{
+public:
+	FChromiumAsyncSchemeState(int32 InMaxQueuedBytes, float InStallTimeoutSeconds)
+		: MaxQueuedBytes(FMath::Max(InMaxQueuedBytes, 1))
+		, StallTimeoutSeconds(FMath::Max(InStallTimeoutSeconds, 0.0f))
+		, SpaceAvailable(FPlatformProcess::GetSynchEventFromPool(false))
+	{
+	}
+
+	~FChromiumAsyncSchemeState()
+	{
+		FPlatformProcess::ReturnSynchEventToPool(SpaceAvailable);
+	}
+
+	void SendHeaders()
+	{
+		FSimpleDelegate Ready;
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (bHeadersSent)
+			{
+				return;
+			}
+			bHeadersSent = true;
+			Ready = MoveTemp(OnHeadersReady);
+			OnHeadersReady.Unbind();
+		}
+		Ready.ExecuteIfBound();
+	}
+
+	/**
+	 * Queues a chunk of the body, waiting for the browser to read while the queue is full. A browser that reads nothing for
+	 * the stall timeout has stopped on the request, which is then canceled.
+	 */
+	bool Write(TArray<uint8>&& Chunk)
+	{
+		SendHeaders();
+		if (Chunk.Num() == 0)
+		{
+			return !bCanceled;
+		}
+
+		FSimpleDelegate Ready;
+		double StallDeadline = FPlatformTime::Seconds() + StallTimeoutSeconds;
+		for (;;)
+		{
+			{
+				FScopeLock ScopeLock(&Lock);
+				if (bCanceled)
+				{
+					return false;
+				}
+				// A chunk larger than the queue still goes in once the queue is empty
+				if (QueuedBytes == 0 || QueuedBytes + Chunk.Num() <= MaxQueuedBytes)
+				{
+					QueuedBytes += Chunk.Num();
+					Chunks.Add(MoveTemp(Chunk));
+					Ready = MoveTemp(OnMoreDataReady);
+					OnMoreDataReady.Unbind();
+					break;
+				}
+			}
+
+			const double WaitSeconds = StallDeadline - FPlatformTime::Seconds();
+			if (WaitSeconds <= 0.0)
+			{
+				Cancel();
+				return false;
+			}
+			if (SpaceAvailable->Wait(FTimespan::FromSeconds(WaitSeconds)))
+			{
+				// The browser read something, it gets a whole timeout to read again
+				StallDeadline = FPlatformTime::Seconds() + StallTimeoutSeconds;
+			}
+		}
+		Ready.ExecuteIfBound();
+		return true;
+	}
+
+	bool Read(uint8* OutBytes, int32 BytesToRead, int32& BytesRead, const FSimpleDelegate& InOnMoreDataReady)
+	{
+		FScopeLock ScopeLock(&Lock);
+		BytesRead = 0;
+		while (BytesRead < BytesToRead && Chunks.Num() > 0)
+		{
+			const TArray<uint8>& Chunk = Chunks[0];
+			const int32 Num = FMath::Min(BytesToRead - BytesRead, Chunk.Num() - ChunkOffset);
+			FMemory::Memcpy(OutBytes + BytesRead, Chunk.GetData() + ChunkOffset, Num);
+			BytesRead += Num;
+			ChunkOffset += Num;
+			if (ChunkOffset == Chunk.Num())
+			{
+				Chunks.RemoveAt(0, 1, false);
+				ChunkOffset = 0;
+			}
+		}
+
+		if (BytesRead > 0)
+		{
+			QueuedBytes -= BytesRead;
+			SpaceAvailable->Trigger();
+			return true;
+		}
+		if (bFinished || bCanceled)
+		{
+			return false;
+		}
+
+		// Nothing to read yet, the next Write or the end of the task continues the request
+		OnMoreDataReady = InOnMoreDataReady;
+		return true;
+	}
+
+	/** Called once the task has returned. */
+	void Finish()
+	{
+		SendHeaders();
+
+		FSimpleDelegate Ready;
+		{
+			FScopeLock ScopeLock(&Lock);
+			bFinished = true;
+			Ready = MoveTemp(OnMoreDataReady);
+			OnMoreDataReady.Unbind();
+		}
+		Ready.ExecuteIfBound();
+	}
+
+	void Cancel()
+	{
+		bCanceled = true;
+		{
+			FScopeLock ScopeLock(&Lock);
+			OnHeadersReady.Unbind();
+			OnMoreDataReady.Unbind();
+			Chunks.Empty();
+			ChunkOffset = 0;
+			QueuedBytes = 0;
+		}
+		// Lets a task waiting in Write find out
+		SpaceAvailable->Trigger();
+	}
+
+	FCriticalSection Lock;
+
+	int32 StatusCode = 200;
+	FString MimeType;
+	int32 ContentLength = INDEX_NONE;
+	FString RedirectUrl;
+	TArray<TPair<FString, FString>> Headers;
+	bool bHeadersSent = false;
+	FSimpleDelegate OnHeadersReady;
+
+	TAtomic<bool> bCanceled{ false };
+
+private:
+	const int32 MaxQueuedBytes;
+	const float StallTimeoutSeconds;
+	/** Triggered when the browser has read from the queue, or the request is canceled. */
+	FEvent* SpaceAvailable;
+
+	TArray<TArray<uint8>> Chunks;
+	/** How much of the first chunk has been read. */
+	int32 ChunkOffset = 0;
+	int32 QueuedBytes = 0;
+	bool bFinished = false;
+	FSimpleDelegate OnMoreDataReady;
+};
+
+FChromiumAsyncSchemeResponse::FChromiumAsyncSchemeResponse(const TSharedRef<FChromiumAsyncSchemeState, ESPMode::ThreadSafe>& InState)
+	: State(InState)
+{
+}
+
+void FChromiumAsyncSchemeResponse::SetStatusCode(int32 StatusCode)
+{
+	FScopeLock ScopeLock(&State->Lock);
+	if (!State->bHeadersSent)
+	{
+		State->StatusCode = StatusCode;
+	}
+}
+
+void FChromiumAsyncSchemeResponse::SetMimeType(const FString& MimeType)
+{
+	FScopeLock ScopeLock(&State->Lock);
+	if (!State->bHeadersSent)
+	{
+		State->MimeType = MimeType;
+	}
+}
+
+void FChromiumAsyncSchemeResponse::SetContentLength(int32 ContentLength)
+{
+	FScopeLock ScopeLock(&State->Lock);
+	if (!State->bHeadersSent)
+	{
+		State->ContentLength = ContentLength;
+	}
+}
+
+void FChromiumAsyncSchemeResponse::SetRedirect(const FString& Url)
+{
+	FScopeLock ScopeLock(&State->Lock);
+	if (!State->bHeadersSent)
+	{
+		State->RedirectUrl = Url;
+	}
+}
+
+void FChromiumAsyncSchemeResponse::SetHeader(const FString& Key, const FString& Value)
+{
+	FScopeLock ScopeLock(&State->Lock);
+	if (!State->bHeadersSent)
+	{
+		State->Headers.Emplace(Key, Value);
+	}
+}
+
+void FChromiumAsyncSchemeResponse::SendHeaders()
+{
+	State->SendHeaders();
+}
+
+bool FChromiumAsyncSchemeResponse::Write(const uint8* Data, int32 Num)
+{
+	return State->Write(TArray<uint8>(Data, Num));
+}
+
+bool FChromiumAsyncSchemeResponse::Write(TArray<uint8>&& Chunk)
+{
+	return State->Write(MoveTemp(Chunk));
+}
+
+bool FChromiumAsyncSchemeResponse::IsCanceled() const
+{
+	return State->bCanceled;
+}
+
+FChromiumAsyncWebBrowserSchemeHandler::FChromiumAsyncWebBrowserSchemeHandler(int32 MaxQueuedBytes, float StallTimeoutSeconds)
+	: State(MakeShared<FChromiumAsyncSchemeState, ESPMode::ThreadSafe>(MaxQueuedBytes, StallTimeoutSeconds))
+{
+}
+
+FChromiumAsyncWebBrowserSchemeHandler::~FChromiumAsyncWebBrowserSchemeHandler()
+{
+	// The browser may let go of a request without canceling it, a task still running has nothing left to do
+	State->Cancel();
+}
+
+bool FChromiumAsyncWebBrowserSchemeHandler::ProcessRequest(const FString& Verb, const FString& Url, const FSimpleDelegate& OnHeadersReady)
+{
+	FResponseTask Task = CreateResponseTask(Verb, Url);
+	if (!Task)
+	{
+		return false;
+	}
+
+	{
+		FScopeLock ScopeLock(&State->Lock);
+		State->OnHeadersReady = OnHeadersReady;
+	}
+
+	// Writes may wait on the page, which must not tie up the task graph workers the engine's own work runs on
+	Async(EAsyncExecution::ThreadPool, [Task = MoveTemp(Task), TaskState = State]()
+	{
+		if (!TaskState->bCanceled)
+		{
+			FChromiumAsyncSchemeResponse Response(TaskState);
+			Task(Response);
+		}
+		TaskState->Finish();
+	});
+	return true;
+}
+
+void FChromiumAsyncWebBrowserSchemeHandler::GetResponseHeaders(IChromiumHeaders& OutHeaders)
+{
+	FScopeLock ScopeLock(&State->Lock);
+	if (!State->RedirectUrl.IsEmpty())
+	{
+		OutHeaders.SetRedirect(*State->RedirectUrl);
+		return;
+	}
+
+	OutHeaders.SetStatusCode(State->StatusCode);
+	if (!State->MimeType.IsEmpty())
+	{
+		OutHeaders.SetMimeType(*State->MimeType);
+	}
+	if (State->ContentLength != INDEX_NONE)
+	{
+		OutHeaders.SetContentLength(State->ContentLength);
+	}
+	for (const TPair<FString, FString>& Header : State->Headers)
+	{
+		OutHeaders.SetHeader(*Header.Key, *Header.Value);
+	}
+}
+
+bool FChromiumAsyncWebBrowserSchemeHandler::ReadResponse(uint8* OutBytes, int32 BytesToRead, int32& BytesRead, const FSimpleDelegate& OnMoreDataReady)
+{
+	return State->Read(OutBytes, BytesToRead, BytesRead, OnMoreDataReady);
+}
+
+void FChromiumAsyncWebBrowserSchemeHandler::Cancel()
+{
+	State->Cancel();
+}
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/Object.h"
+
+#include "ChromiumViewStateReporter.generated.h"
+
+DECLARE_DELEGATE_TwoParams(FOnChromiumScrollPositionReported, int32 /*X*/, int32 /*Y*/);
+
+/**
+ * Bound to a page while its browser window asks for the page's view state, so the page can answer through the JS bridge.
+ * See FChromiumCEFWebBrowserWindow::CaptureViewState.
+ */
+UCLASS(Transient)
+class UChromiumViewStateReporter : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Called by the page with its scroll position. */
+	UFUNCTION()
+	void ReportScrollPosition(int32 X, int32 Y)
+	{
+		OnScrollPositionReported.ExecuteIfBound(X, Y);
+	}
+
+	FOnChromiumScrollPositionReported OnScrollPositionReported;
+};
@@ -37,6 +37,10 @@ UChromiumWebBrowser::UChromiumWebBrowser(const FObjectInitializer& ObjectInitial
 	Visibility = ESlateVisibility::SelfHitTestInvisible;
 	FrameRate = 60;
 
+	RenderScale = 1.0f;
+	bAutomaticRenderScale = false;
+	bAsyncCreation = false;
+
 	bEnableMouseTransparency = false;
 	MouseTransparencyThreshold = 0.333f;
 	MouseTransparencyDelay = 0.1f;
@@ -316,6 +320,21 @@ TArray<FColor> UChromiumWebBrowser::ReadTexturePixels(int32 X, int32 Y, int32 Wi
 	return TArray<FColor>();
 }
 
+void UChromiumWebBrowser::ReadTexturePixelsAsync(int32 X, int32 Y, int32 Width, int32 Height, FOnTexturePixelsRead OnRead)
+{
+#if !UE_SERVER
+	if (WebBrowserWidget.IsValid())
+	{
+		WebBrowserWidget->ReadTexturePixelsAsync(X, Y, Width, Height, FOnChromiumTexturePixelsRead::CreateLambda([OnRead](const TArray<FColor>& Pixels)
+		{
+			OnRead.ExecuteIfBound(Pixels);
+		}));
+		return;
+	}
+#endif
+	OnRead.ExecuteIfBound(TArray<FColor>());
+}
+
 bool UChromiumWebBrowser::IsMouseTransparencyEnabled() const
 {
 #if !UE_SERVER
@@ -363,6 +382,7 @@ TSharedRef<SWidget> UChromiumWebBrowser::RebuildWidget()
 			.TransparencyDelay(MouseTransparencyDelay)
 			.TransparencyThreshold(MouseTransparencyThreshold)
 			.EnableVirtualPointerTransparency(bEnableVirtualPointerTransparency)
+			.AsyncCreation(bAsyncCreation)
 			.OnUrlChanged(BIND_UOBJECT_DELEGATE(FOnTextChanged, HandleOnUrlChanged))
 			.OnBeforePopup(BIND_UOBJECT_DELEGATE(FOnBeforePopupDelegate, HandleOnBeforePopup));
 
@@ -380,8 +400,20 @@ void UChromiumWebBrowser::SynchronizeProperties()
 
 	if ( WebBrowserWidget.IsValid() )
 	{
+		WebBrowserWidget->SetRenderScale(RenderScale, bAutomaticRenderScale);
+	}
+}
 
+void UChromiumWebBrowser::SetRenderScale(float Scale, bool bAutomatic)
+{
+	RenderScale = FMath::Clamp(Scale, 0.1f, 1.0f);
+	bAutomaticRenderScale = bAutomatic;
+#if !UE_SERVER
+	if (WebBrowserWidget.IsValid())
+	{
+		WebBrowserWidget->SetRenderScale(RenderScale, bAutomaticRenderScale);
 	}
+#endif
 }
 
 void UChromiumWebBrowser::HandleOnUrlChanged(const FText& InText)
@@ -5,6 +5,7 @@
 #include "ChromiumWebBrowserSingleton.h"
 #include "Misc/App.h"
 #include "Misc/EngineVersion.h"
+#include "Misc/ConfigCacheIni.h"
 //#if WITH_CEF3
 //#	include "CEF3Utils.h"
 //#endif
@@ -91,6 +92,40 @@ DEFINE_LOG_CATEGORY(ChromiumLogWebBrowser);
 
 static FChromiumWebBrowserSingleton* WebBrowserSingleton = nullptr;
 
+FChromiumBrowserProcessModelSettings::FChromiumBrowserProcessModelSettings()
+	: bProcessPerSite(false)
+	, RendererProcessLimit(0)
+	, SiteIsolation(EChromiumSiteIsolation::Default)
+{
+	if (GConfig == nullptr)
+	{
+		return;
+	}
+
+	GConfig->GetBool(TEXT("Browser"), TEXT("bProcessPerSite"), bProcessPerSite, GEngineIni);
+	GConfig->GetInt(TEXT("Browser"), TEXT("RendererProcessLimit"), RendererProcessLimit, GEngineIni);
+	RendererProcessLimit = FMath::Max(RendererProcessLimit, 0);
+
+	FString SiteIsolationName;
+	if (GConfig->GetString(TEXT("Browser"), TEXT("SiteIsolation"), SiteIsolationName, GEngineIni))
+	{
+		if (SiteIsolationName == TEXT("Disabled"))
+		{
+			SiteIsolation = EChromiumSiteIsolation::Disabled;
+		}
+		else if (SiteIsolationName == TEXT("SitePerProcess"))
+		{
+			SiteIsolation = EChromiumSiteIsolation::SitePerProcess;
+		}
+		else if (SiteIsolationName != TEXT("Default"))
+		{
+			UE_LOG(ChromiumLogWebBrowser, Warning, TEXT("Unknown [Browser] SiteIsolation %s, expected Default, Disabled or SitePerProcess"), *SiteIsolationName);
+		}
+	}
+
+	GConfig->GetArray(TEXT("Browser"), TEXT("IsolatedOrigins"), IsolatedOrigins, GEngineIni);
+}
+
 FChromiumWebBrowserInitSettings::FChromiumWebBrowserInitSettings()
 	: ProductVersion(FString::Printf(TEXT("%s/%s UnrealEngine/%s Chrome/84.0.4147.38"), FApp::GetProjectName(), FApp::GetBuildVersion(), *FEngineVersion::Current().ToString()))
 {
@@ -0,0 +1,325 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ChromiumWebBrowserReadback.h"
+#include "Containers/Queue.h"
+#include "RHI.h"
+#include "RHICommandList.h"
+#include "RenderingThread.h"
+#include "Textures/SlateShaderResource.h"
+
+/** A coalesced copy of the requests made during one frame. */
+struct FChromiumWebBrowserReadbackBatch
+{
+	FChromiumWebBrowserReadbackBatch()
+		: Id(0)
+		, Format(PF_Unknown)
+	{}
+
+	uint32 Id;
+
+	/** The texture to copy from, invalid if the request could not be served. */
+	FTexture2DRHIRef Source;
+	EPixelFormat Format;
+
+	/** Union of all request rectangles, the area actually copied. */
+	FIntRect Bounds;
+
+	/** The rectangle of each request, in texture space. */
+	TArray<FIntRect> Rects;
+
+	/** Pixels of each request, filled in by the render thread. */
+	TArray<TArray<FColor>> Results;
+};
+
+/**
+ * The render thread side of FChromiumWebBrowserReadback: staging textures, their fences and the batches waiting on them.
+ * Everything except the completion queue is only touched on the render thread.
+ */
+class FChromiumWebBrowserReadbackPool
+{
+public:
+	~FChromiumWebBrowserReadbackPool()
+	{
+		for (FInFlightBatch& Entry : InFlight)
+		{
+			delete Entry.Batch;
+		}
+
+		FChromiumWebBrowserReadbackBatch* Batch = nullptr;
+		while (Completed.Dequeue(Batch))
+		{
+			delete Batch;
+		}
+	}
+
+	/** Copies the batch into a staging texture and fences it. */
+	void Submit_RenderThread(FRHICommandListImmediate& RHICmdList, FChromiumWebBrowserReadbackBatch* Batch)
+	{
+		check(IsInRenderingThread());
+
+		if (!Batch->Source.IsValid())
+		{
+			Completed.Enqueue(Batch);
+			return;
+		}
+
+		const FIntPoint Size = Batch->Bounds.Size();
+		FStagingTexture Staging = AcquireStagingTexture(Size, Batch->Format);
+
+		RHICmdList.Transition(FRHITransitionInfo(Batch->Source, ERHIAccess::Unknown, ERHIAccess::CopySrc));
+		RHICmdList.Transition(FRHITransitionInfo(Staging.Texture, ERHIAccess::Unknown, ERHIAccess::CopyDest));
+
+		FRHICopyTextureInfo CopyInfo;
+		CopyInfo.Size = FIntVector(Size.X, Size.Y, 1);
+		CopyInfo.SourcePosition = FIntVector(Batch->Bounds.Min.X, Batch->Bounds.Min.Y, 0);
+		RHICmdList.CopyTexture(Batch->Source, Staging.Texture, CopyInfo);
+
+		RHICmdList.Transition(FRHITransitionInfo(Batch->Source, ERHIAccess::CopySrc, ERHIAccess::SRVMask));
+
+		Staging.Fence->Clear();
+		RHICmdList.WriteGPUFence(Staging.Fence);
+
+		InFlight.Add({ Batch, Staging });
+	}
+
+	/** Resolves every batch whose copy the GPU has finished, oldest first. */
+	void Poll_RenderThread(FRHICommandListImmediate& RHICmdList)
+	{
+		check(IsInRenderingThread());
+
+		for (int32 Index = 0; Index < InFlight.Num();)
+		{
+			FInFlightBatch& Entry = InFlight[Index];
+			if (!Entry.Staging.Fence->Poll())
+			{
+				++Index;
+				continue;
+			}
+
+			void* Data = nullptr;
+			int32 RowPitchInPixels = 0;
+			int32 MappedHeight = 0;
+			RHICmdList.MapStagingSurface(Entry.Staging.Texture, Entry.Staging.Fence, Data, RowPitchInPixels, MappedHeight);
+			if (Data != nullptr)
+			{
+				CopyResults(*Entry.Batch, static_cast<const uint8*>(Data), RowPitchInPixels);
+			}
+			RHICmdList.UnmapStagingSurface(Entry.Staging.Texture);
+
+			ReleaseStagingTexture(Entry.Staging);
+			Completed.Enqueue(Entry.Batch);
+			InFlight.RemoveAt(Index, 1, false);
+		}
+	}
+
+	/** Pops a batch the render thread is done with. Game thread only. */
+	bool DequeueCompleted(FChromiumWebBrowserReadbackBatch*& OutBatch)
+	{
+		return Completed.Dequeue(OutBatch);
+	}
+
+private:
+	/** Upper bound on idle staging textures kept around for reuse. */
+	static const int32 MaxFreeStagingTextures = 4;
+
+	struct FStagingTexture
+	{
+		FTexture2DRHIRef Texture;
+		FGPUFenceRHIRef Fence;
+	};
+
+	struct FInFlightBatch
+	{
+		FChromiumWebBrowserReadbackBatch* Batch;
+		FStagingTexture Staging;
+	};
+
+	FStagingTexture AcquireStagingTexture(const FIntPoint& Size, EPixelFormat Format)
+	{
+		for (int32 Index = 0; Index < FreeStagingTextures.Num(); ++Index)
+		{
+			const FTexture2DRHIRef& Texture = FreeStagingTextures[Index].Texture;
+			if (Texture->GetFormat() == Format && (int32)Texture->GetSizeX() >= Size.X && (int32)Texture->GetSizeY() >= Size.Y)
+			{
+				FStagingTexture Staging = FreeStagingTextures[Index];
+				FreeStagingTextures.RemoveAtSwap(Index, 1, false);
+				return Staging;
+			}
+		}
+
+		FRHIResourceCreateInfo CreateInfo(TEXT("ChromiumTextureReadback"));
+		FStagingTexture Staging;
+		Staging.Texture = RHICreateTexture2D(Size.X, Size.Y, Format, 1, 1, TexCreate_CPUReadback, CreateInfo);
+		Staging.Fence = RHICreateGPUFence(TEXT("ChromiumTextureReadback"));
+		return Staging;
+	}
+
+	void ReleaseStagingTexture(const FStagingTexture& Staging)
+	{
+		if (FreeStagingTextures.Num() >= MaxFreeStagingTextures)
+		{
+			// Drop the oldest so the pool follows the sizes currently being requested
+			FreeStagingTextures.RemoveAt(0, 1, false);
+		}
+		FreeStagingTextures.Add(Staging);
+	}
+
+	static void CopyResults(FChromiumWebBrowserReadbackBatch& Batch, const uint8* Data, int32 RowPitchInPixels)
+	{
+		const bool bSwapRB = Batch.Format == PF_R8G8B8A8;
+		if (Batch.Format != PF_B8G8R8A8 && !bSwapRB)
+		{
+			return;
+		}
+
+		Batch.Results.SetNum(Batch.Rects.Num());
+		for (int32 RectIndex = 0; RectIndex < Batch.Rects.Num(); ++RectIndex)
+		{
+			const FIntRect& Rect = Batch.Rects[RectIndex];
+			const FIntPoint Offset = Rect.Min - Batch.Bounds.Min;
+			const int32 Width = Rect.Width();
+
+			TArray<FColor>& Pixels = Batch.Results[RectIndex];
+			Pixels.SetNumUninitialized(Width * Rect.Height());
+
+			for (int32 Row = 0; Row < Rect.Height(); ++Row)
+			{
+				const uint8* Src = Data + ((Offset.Y + Row) * RowPitchInPixels + Offset.X) * sizeof(FColor);
+				FColor* Dest = Pixels.GetData() + Row * Width;
+				if (bSwapRB)
+				{
+					for (int32 Column = 0; Column < Width; ++Column, Src += 4)
+					{
+						Dest[Column] = FColor(Src[0], Src[1], Src[2], Src[3]);
+					}
+				}
+				else
+				{
+					// FColor is laid out as BGRA, so rows can be copied as is
+					FMemory::Memcpy(Dest, Src, Width * sizeof(FColor));
+				}
+			}
+		}
+	}
+
+	TArray<FStagingTexture> FreeStagingTextures;
+	TArray<FInFlightBatch> InFlight;
+
+	/** Render thread to game thread. */
+	TQueue<FChromiumWebBrowserReadbackBatch*, EQueueMode::Spsc> Completed;
+};
+
+FChromiumWebBrowserReadback::FChromiumWebBrowserReadback()
+	: NextBatchId(1)
+	, Pool(MakeShared<FChromiumWebBrowserReadbackPool, ESPMode::ThreadSafe>())
+{
+}
+
+FChromiumWebBrowserReadback::~FChromiumWebBrowserReadback()
+{
+	// Outstanding batches are freed along with the pool once the render commands referencing it have run.
+}
+
+void FChromiumWebBrowserReadback::Request(FSlateShaderResource* Resource, const FIntRect& Rect, FOnChromiumTexturePixelsRead Callback)
+{
+	check(IsInGameThread());
+
+	FTexture2DRHIRef Texture;
+	if (Resource != nullptr && Resource->GetType() == ESlateShaderResource::NativeTexture)
+	{
+		Texture = ((TSlateTexture<FTexture2DRHIRef>*)Resource)->GetTypedResource();
+	}
+
+	// Requests against a texture that has been replaced since cannot share its copy.
+	if (QueuedRequests.Num() > 0 && QueuedTexture != Texture)
+	{
+		SubmitQueuedRequests();
+	}
+
+	QueuedTexture = MoveTemp(Texture);
+	QueuedRequests.Add({ Rect, MoveTemp(Callback) });
+}
+
+int32 FChromiumWebBrowserReadback::GetNumPendingRequests() const
+{
+	int32 NumRequests = QueuedRequests.Num();
+	for (const TPair<uint32, TArray<FRequest>>& Pair : SubmittedRequests)
+	{
+		NumRequests += Pair.Value.Num();
+	}
+	return NumRequests;
+}
+
+bool FChromiumWebBrowserReadback::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FChromiumWebBrowserReadback_Tick);
+
+	SubmitQueuedRequests();
+
+	// Collect finished requests first, callbacks are free to issue new reads or destroy the widget owning us.
+	TArray<TPair<FOnChromiumTexturePixelsRead, TArray<FColor>>> Finished;
+	FChromiumWebBrowserReadbackBatch* Batch = nullptr;
+	while (Pool->DequeueCompleted(Batch))
+	{
+		TArray<FRequest> Requests;
+		if (SubmittedRequests.RemoveAndCopyValue(Batch->Id, Requests))
+		{
+			for (int32 Index = 0; Index < Requests.Num(); ++Index)
+			{
+				Finished.Emplace(MoveTemp(Requests[Index].Callback), Batch->Results.IsValidIndex(Index) ? MoveTemp(Batch->Results[Index]) : TArray<FColor>());
+			}
+		}
+		delete Batch;
+	}
+
+	if (SubmittedRequests.Num() > 0)
+	{
+		TSharedRef<FChromiumWebBrowserReadbackPool, ESPMode::ThreadSafe> PoolRef = Pool;
+		ENQUEUE_RENDER_COMMAND(ChromiumPollTextureReadback)(
+			[PoolRef](FRHICommandListImmediate& RHICmdList)
+			{
+				PoolRef->Poll_RenderThread(RHICmdList);
+			});
+	}
+
+	for (TPair<FOnChromiumTexturePixelsRead, TArray<FColor>>& Result : Finished)
+	{
+		Result.Key.ExecuteIfBound(Result.Value);
+	}
+
+	return true;
+}
+
+void FChromiumWebBrowserReadback::SubmitQueuedRequests()
+{
+	if (QueuedRequests.Num() == 0)
+	{
+		return;
+	}
+
+	FChromiumWebBrowserReadbackBatch* Batch = new FChromiumWebBrowserReadbackBatch();
+	Batch->Id = NextBatchId++;
+	Batch->Bounds = QueuedRequests[0].Rect;
+	for (const FRequest& Request : QueuedRequests)
+	{
+		Batch->Bounds.Union(Request.Rect);
+		Batch->Rects.Add(Request.Rect);
+	}
+
+	if (QueuedTexture.IsValid() && !Batch->Bounds.IsEmpty())
+	{
+		Batch->Source = MoveTemp(QueuedTexture);
+		Batch->Format = Batch->Source->GetFormat();
+	}
+
+	SubmittedRequests.Add(Batch->Id, MoveTemp(QueuedRequests));
+	QueuedRequests.Reset();
+	QueuedTexture.SafeRelease();
+
+	TSharedRef<FChromiumWebBrowserReadbackPool, ESPMode::ThreadSafe> PoolRef = Pool;
+	ENQUEUE_RENDER_COMMAND(ChromiumSubmitTextureReadback)(
+		[PoolRef, Batch](FRHICommandListImmediate& RHICmdList)
+		{
+			PoolRef->Submit_RenderThread(RHICmdList, Batch);
+		});
+}
@@ -0,0 +1,66 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "RHI.h"
+#include "SChromiumWebBrowser.h"
+
+class FSlateShaderResource;
+class FChromiumWebBrowserReadbackPool;
+
+/**
+ * Reads pixels back from a browser texture without stalling the game thread.
+ * Requests made during the same frame are coalesced into a single copy of their bounding rectangle, which the render thread
+ * writes into a pooled staging texture and fences. The fences are polled on later frames, and once the GPU is done the pixels
+ * are handed back to the game thread and the request callbacks are invoked. Any number of copies may be in flight at once.
+ */
+class FChromiumWebBrowserReadback
+	: public FTickerObjectBase
+{
+public:
+	FChromiumWebBrowserReadback();
+	virtual ~FChromiumWebBrowserReadback();
+
+	/**
+	 * Queues a read of a rectangle of the texture. Must be called on the game thread.
+	 *
+	 * @param Resource The texture to read from, only used during the call. The window may release it before the read is made.
+	 * @param Rect The pixels to read, already clamped to the texture.
+	 * @param Callback Invoked on the game thread with the pixels, or an empty array if the read failed.
+	 */
+	void Request(FSlateShaderResource* Resource, const FIntRect& Rect, FOnChromiumTexturePixelsRead Callback);
+
+	/** @return Number of requests that have not completed yet. */
+	int32 GetNumPendingRequests() const;
+
+	// FTickerObjectBase interface
+	virtual bool Tick(float DeltaTime) override;
+
+private:
+	/** A read waiting for its batch to complete. */
+	struct FRequest
+	{
+		FIntRect Rect;
+		FOnChromiumTexturePixelsRead Callback;
+	};
+
+	/** Hands the requests queued this frame to the render thread as a single copy. */
+	void SubmitQueuedRequests();
+
+	/**
+	 * Requests made since the last submission, all reading from QueuedTexture. The RHI texture is taken from the Slate resource
+	 * when the request is made and keeps it alive, the resource itself may be released before the next Tick submits the batch.
+	 */
+	TArray<FRequest> QueuedRequests;
+	FTexture2DRHIRef QueuedTexture;
+
+	/** Requests submitted to the render thread, keyed by batch id. */
+	TMap<uint32, TArray<FRequest>> SubmittedRequests;
+
+	uint32 NextBatchId;
+
+	/** State shared with the render thread, kept alive by the render commands referencing it. */
+	TSharedRef<FChromiumWebBrowserReadbackPool, ESPMode::ThreadSafe> Pool;
+};
@@ -5,13 +5,16 @@
 #include "GenericPlatform/GenericPlatformFile.h"
 #include "Misc/CommandLine.h"
 #include "Misc/ConfigCacheIni.h"
+#include "HAL/IConsoleManager.h"
 #include "Internationalization/Culture.h"
 #include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
 #include "ChromiumWebBrowserModule.h"
 #include "Misc/EngineVersion.h"
 #include "Framework/Application/SlateApplication.h"
 #include "IChromiumWebBrowserCookieManager.h"
 #include "ChromiumWebBrowserLog.h"
+#include "ChromiumWebBrowserStats.h"
 
 #if PLATFORM_WINDOWS
 #include "Windows/WindowsHWrapper.h"
@@ -26,6 +29,10 @@
 #include "CEF/ChromiumCEFSchemeHandler.h"
 #include "CEF/ChromiumCEFResourceContextHandler.h"
 #include "CEF/ChromiumCEFBrowserClosureTask.h"
+#include "CEF/ChromiumCEFGameThreadQueue.h"
+#include "CEF/ChromiumCEFBrowserPool.h"
+#include "CEF/ChromiumCEFProcessMemory.h"
+#include "CEF/ChromiumCEFRequestRules.h"
 #	if PLATFORM_WINDOWS
 #		include "Windows/AllowWindowsPlatformTypes.h"
 #	endif
@@ -82,8 +89,42 @@ THIRD_PARTY_INCLUDES_END
 #	ifndef CEF3_DEFAULT_CACHE
 #		define CEF3_DEFAULT_CACHE 1
 #	endif
+
+static bool bCEFExternalBeginFrame = false;
+static FAutoConsoleVariableRef CVarCEFExternalBeginFrame(
+	TEXT("r.CEFExternalBeginFrame"),
+	bCEFExternalBeginFrame,
+	TEXT("Drive rendering of windowless browsers from the engine tick instead of CEF's internal timer, sending at most one begin frame\n")
+	TEXT("per engine frame to each visible browser. Only affects browsers created after it is changed.\n"),
+	ECVF_Default);
+
+static float CEFTelemetryProcessInterval = 2.0f;
+static FAutoConsoleVariableRef CVarCEFTelemetryProcessInterval(
+	TEXT("r.CEFTelemetryProcessInterval"),
+	CEFTelemetryProcessInterval,
+	TEXT("Seconds between background scans of the CEF helper processes, which give each browser the memory and processor use\n")
+	TEXT("of its render process. 0 disables the scans.\n"),
+	ECVF_Default);
 #endif
 
+DECLARE_CYCLE_STAT(TEXT("Game Thread Browser Work"), STAT_ChromiumGameThreadBrowserWork, STATGROUP_ChromiumUI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Threaded Message Loop"), STAT_ChromiumThreadedMessageLoop, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Browser Creation (ms)"), STAT_ChromiumBrowserCreation, STATGROUP_ChromiumUI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Browser Windows"), STAT_ChromiumWindows, STATGROUP_ChromiumUI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Browser Windows"), STAT_ChromiumActiveWindows, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Startup: Locate CEF Files (ms)"), STAT_ChromiumInitLocateFiles, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Startup: CefInitialize (ms)"), STAT_ChromiumInitCefInitialize, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Startup: Setup (ms)"), STAT_ChromiumInitSetup, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Startup: Game Thread Total (ms)"), STAT_ChromiumInitGameThread, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Browser Callbacks (ms/s)"), STAT_ChromiumCallbackTime, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Paints/s"), STAT_ChromiumPaintsPerSecond, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Uploads (MB/s)"), STAT_ChromiumUploadsPerSecond, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("JS Bridge Messages/s"), STAT_ChromiumJSMessagesPerSecond, STATGROUP_ChromiumUI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resource Requests In Flight"), STAT_ChromiumResourceRequestsInFlight, STATGROUP_ChromiumUI);
+DECLARE_MEMORY_STAT(TEXT("Browser Textures"), STAT_ChromiumTextureMemory, STATGROUP_ChromiumUI);
+DECLARE_MEMORY_STAT(TEXT("Render Processes"), STAT_ChromiumRenderProcessMemory, STATGROUP_ChromiumUI);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Render Processes CPU (%)"), STAT_ChromiumRenderProcessCpu, STATGROUP_ChromiumUI);
+
 namespace {
 
 	/**
@@ -236,6 +277,113 @@ FChromiumWebBrowserSingleton::FChromiumWebBrowserSingleton(const FChromiumWebBro
 	// The FChromiumWebBrowserSingleton must be initialized on the game thread
 	check(IsInGameThread());
 
+	ProductVersion = WebBrowserInitSettings.ProductVersion;
+	ProcessModel = WebBrowserInitSettings.ProcessModel;
+	bCEFInitialized = false;
+
+	// The game's packed web UI, served straight out of the archive
+	FString UIArchive;
+	if (GConfig->GetString(TEXT("Browser"), TEXT("UIArchive"), UIArchive, GEngineIni) && !UIArchive.IsEmpty())
+	{
+		FString UIArchiveScheme = TEXT("ui");
+		FString UIArchiveDomain;
+		GConfig->GetString(TEXT("Browser"), TEXT("UIArchiveScheme"), UIArchiveScheme, GEngineIni);
+		GConfig->GetString(TEXT("Browser"), TEXT("UIArchiveDomain"), UIArchiveDomain, GEngineIni);
+		RegisterArchiveSchemeHandler(UIArchiveScheme, UIArchiveDomain, FPaths::IsRelative(UIArchive) ? FPaths::ProjectContentDir() / UIArchive : UIArchive);
+	}
+
+	// Sessions that may never show a browser can leave starting CEF to the first browser or context, or to WarmUp
+	bool bLazyInitialize = false;
+	GConfig->GetBool(TEXT("Browser"), TEXT("bLazyInitialize"), bLazyInitialize, GEngineIni);
+	bLazyInitialize |= FParse::Param(FCommandLine::Get(), TEXT("CefLazyInit"));
+	if (!bLazyInitialize)
+	{
+		EnsureCEFInitialized();
+	}
+#elif PLATFORM_IOS && !BUILD_EMBEDDED_APP
+	DefaultCookieManager = MakeShareable(new FChromiumIOSCookieManager());
+#elif PLATFORM_ANDROID
+	DefaultCookieManager = MakeShareable(new FChromiumAndroidCookieManager());
+#endif
+}
+
+#if WITH_CEF3
+FChromiumWebBrowserSingleton::FCEFStartupPaths FChromiumWebBrowserSingleton::LocateCEFFiles(const FString& LocaleCode, const FString& LanguageCode)
+{
+	// Only touches the file system, so it is safe to run off the game thread
+	const double StartTime = FPlatformTime::Seconds();
+	FCEFStartupPaths Paths;
+	Paths.LocaleCode = LocaleCode;
+
+	// Specify path to resources
+	Paths.ResourcesPath = FPaths::Combine(*FPaths::ProjectPluginsDir(), TEXT("ChromiumUI"), CEF3_RESOURCES_DIR);
+	Paths.ResourcesPath = FPaths::ConvertRelativePathToFull(Paths.ResourcesPath);
+	if (!FPaths::DirectoryExists(Paths.ResourcesPath))
+	{
+		UE_LOG(ChromiumLogWebBrowser, Error, TEXT("Chromium Resources information not found at: %s."), *Paths.ResourcesPath);
+	}
+
+#if !PLATFORM_MAC
+	// On Mac Chromium ignores custom locales dir. Files need to be stored in Resources folder in the app bundle
+	Paths.LocalesPath = FPaths::Combine(*Paths.ResourcesPath, TEXT("locales"));
+	Paths.LocalesPath = FPaths::ConvertRelativePathToFull(Paths.LocalesPath);
+	if (!FPaths::DirectoryExists(Paths.LocalesPath))
+	{
+		UE_LOG(ChromiumLogWebBrowser, Error, TEXT("Chromium Locales information not found at: %s."), *Paths.LocalesPath);
+	}
+#else
+	// LocaleCode may contain region, which for some languages may make CEF unable to find the locale pak files
+	// In that case use the language name for CEF locale
+	FString LocalePakPath = Paths.ResourcesPath + TEXT("/") + LocaleCode.Replace(TEXT("-"), TEXT("_")) + TEXT(".lproj/locale.pak");
+	if (!FPaths::FileExists(LocalePakPath))
+	{
+		LocalePakPath = Paths.ResourcesPath + TEXT("/") + LanguageCode + TEXT(".lproj/locale.pak");
+		if (FPaths::FileExists(LocalePakPath))
+		{
+			Paths.LocaleCode = LanguageCode;
+		}
+	}
+
+	// Let CEF know where we have put the framework bundle as it is non-default
+	Paths.FrameworkPath = FPaths::Combine(*FPaths::ProjectPluginsDir(), TEXT("ChromiumUI"), CEF3_FRAMEWORK_DIR);
+	Paths.FrameworkPath = FPaths::ConvertRelativePathToFull(Paths.FrameworkPath);
+#endif
+
+	// Specify path to sub process exe
+	Paths.SubProcessPath = FPaths::Combine(*FPaths::ProjectPluginsDir(),TEXT("ChromiumUI"), CEF3_SUBPROCES_EXE);
+	Paths.SubProcessPath = FPaths::ConvertRelativePathToFull(Paths.SubProcessPath);
+
+	if (!IPlatformFile::GetPlatformPhysical().FileExists(*Paths.SubProcessPath))
+	{
+		UE_LOG(ChromiumLogWebBrowser, Error, TEXT("UnrealCEFSubProcess.exe not found, check that this program has been built and is placed in: %s."), *Paths.SubProcessPath);
+	}
+
+	Paths.Seconds = FPlatformTime::Seconds() - StartTime;
+	return Paths;
+}
+
+bool FChromiumWebBrowserSingleton::EnsureCEFInitialized()
+{
+	if (!bCEFInitialized)
+	{
+		check(IsInGameThread());
+
+		// Wait for a warm up that is still looking for CEF's files rather than repeating its work
+		const bool bLocatedInBackground = PendingStartupPaths.IsValid();
+		const FCEFStartupPaths Paths = bLocatedInBackground
+			? PendingStartupPaths.Get()
+			: LocateCEFFiles(GetCurrentLocaleCode(), FInternationalization::Get().GetCurrentCulture()->GetTwoLetterISOLanguageName());
+		PendingStartupPaths.Reset();
+
+		InitializeCEF(Paths, bLocatedInBackground);
+	}
+	return bCEFInitialized;
+}
+
+void FChromiumWebBrowserSingleton::InitializeCEF(const FCEFStartupPaths& Paths, bool bLocatedInBackground)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
 	// Provide CEF with command-line arguments.
 #if PLATFORM_WINDOWS
 	CefMainArgs MainArgs(hInstance);
@@ -250,6 +398,8 @@ FChromiumWebBrowserSingleton::FChromiumWebBrowserSingleton(const FChromiumWebBro
 	bool bVerboseLogging = FParse::Param(FCommandLine::Get(), TEXT("cefverbose")) || FParse::Param(FCommandLine::Get(), TEXT("debuglog"));
 	// CEFBrowserApp implements application-level callbacks.
 	CEFBrowserApp = new FChromiumCEFBrowserApp;
+	CEFBrowserApp->SetProcessModel(ProcessModel);
+	SubProcessPath = Paths.SubProcessPath;
 	//CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
 	//command_line->AppendSwitchWithValue("ppapi-flash-path", "pepflashplayer64_29_0_0_171.dll");
 	//command_line->AppendSwitchWithValue("ppapi-flash-version", "29.0.0.171");
@@ -261,9 +411,18 @@ FChromiumWebBrowserSingleton::FChromiumWebBrowserSingleton(const FChromiumWebBro
 	CefSettings Settings;
 	Settings.no_sandbox = true;
 	Settings.command_line_args_disabled = true;
-	Settings.external_message_pump = true;
-	//@todo change to threaded version instead of using external_message_pump & OnScheduleMessagePumpWork
-	Settings.multi_threaded_message_loop = false;
+
+	// By default CEF's UI thread is the game thread and we pump it from Tick, so every CEF callback runs inside our frame.
+	// The threaded message loop gives CEF a thread of its own and marshals the callbacks that touch Slate state back to us instead.
+	// CEF only supports this on Windows and Linux.
+	bool bThreadedMessageLoop = false;
+#if PLATFORM_WINDOWS || PLATFORM_LINUX
+	GConfig->GetBool(TEXT("Browser"), TEXT("bThreadedMessageLoop"), bThreadedMessageLoop, GEngineIni);
+	bThreadedMessageLoop |= FParse::Param(FCommandLine::Get(), TEXT("CefThreadedMessageLoop"));
+#endif
+	FChromiumCEFGameThreadQueue::SetThreadedMessageLoop(bThreadedMessageLoop);
+	Settings.external_message_pump = !bThreadedMessageLoop;
+	Settings.multi_threaded_message_loop = bThreadedMessageLoop;
 	//Set the default background for browsers to be opaque black, this is used for windowed (not OSR) browsers
 	//  setting it black here prevents the white flash on load
 	Settings.background_color = CefColorSetARGB(255, 0, 0, 0);
@@ -281,11 +440,10 @@ FChromiumWebBrowserSingleton::FChromiumWebBrowserSingleton(const FChromiumWebBro
 	}
 
 	// Specify locale from our settings
-	FString LocaleCode = GetCurrentLocaleCode();
-	CefString(&Settings.locale) = TCHAR_TO_WCHAR(*LocaleCode);
+	CefString(&Settings.locale) = TCHAR_TO_WCHAR(*Paths.LocaleCode);
 
 	// Append engine version to the user agent string.
-	CefString(&Settings.product_version) = TCHAR_TO_WCHAR(*WebBrowserInitSettings.ProductVersion);
+	CefString(&Settings.product_version) = TCHAR_TO_WCHAR(*ProductVersion);
 
 #if CEF3_DEFAULT_CACHE
 	// Enable on disk cache
@@ -294,109 +452,200 @@ FChromiumWebBrowserSingleton::FChromiumWebBrowserSingleton(const FChromiumWebBro
 	CefString(&Settings.cache_path) = TCHAR_TO_WCHAR(*CachePath);
 #endif
 
-	// Specify path to resources
-	FString ResourcesPath(FPaths::Combine(*FPaths::ProjectPluginsDir(), TEXT("ChromiumUI"), CEF3_RESOURCES_DIR));
-	ResourcesPath = FPaths::ConvertRelativePathToFull(ResourcesPath);
-	if (!FPaths::DirectoryExists(ResourcesPath))
-	{
-		UE_LOG(ChromiumLogWebBrowser, Error, TEXT("Chromium Resources information not found at: %s."), *ResourcesPath);
-	}
-	CefString(&Settings.resources_dir_path) = TCHAR_TO_WCHAR(*ResourcesPath);
-
+	CefString(&Settings.resources_dir_path) = TCHAR_TO_WCHAR(*Paths.ResourcesPath);
 #if !PLATFORM_MAC
-	// On Mac Chromium ignores custom locales dir. Files need to be stored in Resources folder in the app bundle
-	FString LocalesPath(FPaths::Combine(*ResourcesPath, TEXT("locales")));
-	LocalesPath = FPaths::ConvertRelativePathToFull(LocalesPath);
-	if (!FPaths::DirectoryExists(LocalesPath))
-	{
-		UE_LOG(ChromiumLogWebBrowser, Error, TEXT("Chromium Locales information not found at: %s."), *LocalesPath);
-	}
-	CefString(&Settings.locales_dir_path) = TCHAR_TO_WCHAR(*LocalesPath);
+	CefString(&Settings.locales_dir_path) = TCHAR_TO_WCHAR(*Paths.LocalesPath);
 #else
-	// LocaleCode may contain region, which for some languages may make CEF unable to find the locale pak files
-	// In that case use the language name for CEF locale
-	FString LocalePakPath = ResourcesPath + TEXT("/") + LocaleCode.Replace(TEXT("-"), TEXT("_")) + TEXT(".lproj/locale.pak");
-	if (!FPaths::FileExists(LocalePakPath))
-	{
-		FCultureRef Culture = FInternationalization::Get().GetCurrentCulture();
-		LocaleCode = Culture->GetTwoLetterISOLanguageName();
-		LocalePakPath = ResourcesPath + TEXT("/") + LocaleCode + TEXT(".lproj/locale.pak");
-		if (FPaths::FileExists(LocalePakPath))
-		{
-			CefString(&Settings.locale) = TCHAR_TO_WCHAR(*LocaleCode);
-		}
-	}
-	
-	// Let CEF know where we have put the framework bundle as it is non-default
-	FString CefFrameworkPath(FPaths::Combine(*FPaths::ProjectPluginsDir(), TEXT("ChromiumUI"), CEF3_FRAMEWORK_DIR));
-	CefFrameworkPath = FPaths::ConvertRelativePathToFull(CefFrameworkPath);
-	CefString(&Settings.framework_dir_path) = TCHAR_TO_WCHAR(*CefFrameworkPath);
-	CefString(&Settings.main_bundle_path) = TCHAR_TO_WCHAR(*CefFrameworkPath);
+	CefString(&Settings.framework_dir_path) = TCHAR_TO_WCHAR(*Paths.FrameworkPath);
+	CefString(&Settings.main_bundle_path) = TCHAR_TO_WCHAR(*Paths.FrameworkPath);
 #endif
-
-	// Specify path to sub process exe
-	FString SubProcessPath(FPaths::Combine(*FPaths::ProjectPluginsDir(),TEXT("ChromiumUI"), CEF3_SUBPROCES_EXE));
-	SubProcessPath = FPaths::ConvertRelativePathToFull(SubProcessPath);
-
-	if (!IPlatformFile::GetPlatformPhysical().FileExists(*SubProcessPath))
-	{
-		UE_LOG(ChromiumLogWebBrowser, Error, TEXT("UnrealCEFSubProcess.exe not found, check that this program has been built and is placed in: %s."), *SubProcessPath);
-	}
-	CefString(&Settings.browser_subprocess_path) = TCHAR_TO_WCHAR(*SubProcessPath);
+	CefString(&Settings.browser_subprocess_path) = TCHAR_TO_WCHAR(*Paths.SubProcessPath);
 
 	// Initialize CEF.
+	const double CefInitializeStartTime = FPlatformTime::Seconds();
 	bool bSuccess = CefInitialize(MainArgs, Settings, CEFBrowserApp.get(), nullptr);
 	check(bSuccess);
+	bCEFInitialized = true;
+	const double CefInitializeSeconds = FPlatformTime::Seconds() - CefInitializeStartTime;
 
 	// Set the thread name back to GameThread.
 	SetCurrentThreadName(TCHAR_TO_ANSI( *(FName( NAME_GameThread ).GetPlainNameString()) ));
 
+	if (!bThreadedMessageLoop)
+	{
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FChromiumWebBrowserSingleton::HandleEndFrame);
+	}
+
+	ListBrowsersCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("ChromiumUI.ListBrowsers"),
+		TEXT("Lists every browser window with what it costs, the ones spending the most game thread time first."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateRaw(this, &FChromiumWebBrowserSingleton::ListBrowsers),
+		ECVF_Default);
+
+	// Requests get the game's language from the IO thread, which must not ask FInternationalization itself
+	UpdateGlobalRequestRules();
+	CultureChangedHandle = FInternationalization::Get().OnCultureChanged().AddRaw(this, &FChromiumWebBrowserSingleton::UpdateGlobalRequestRules);
+
+	// Scheme handlers registered before CEF was running have only been stored so far
+	SchemeHandlerFactories.RegisterFactoriesGlobally();
+
+	// Start warming up browsers for the default SChromiumWebBrowser settings, other settings are pooled once first used
+	BrowserPool.LoadConfig();
+	MemoryGovernor.Initialize();
+	BrowserPool.Prewarm(FChromiumCEFBrowserPool::FKey(FString(), true, CefColorSetARGB(0, 255, 255, 255), bCEFExternalBeginFrame), nullptr);
+
 	DefaultCookieManager = FChromiumCefWebBrowserCookieManagerFactory::Create(CefCookieManager::GetGlobalManager(nullptr));
-#elif PLATFORM_IOS && !BUILD_EMBEDDED_APP
-	DefaultCookieManager = MakeShareable(new FChromiumIOSCookieManager());
-#elif PLATFORM_ANDROID
-	DefaultCookieManager = MakeShareable(new FChromiumAndroidCookieManager());
+
+	// Locating the files only held up the game thread if it was not done by WarmUp
+	const double SetupSeconds = FPlatformTime::Seconds() - StartTime - CefInitializeSeconds;
+	const double TotalSeconds = (bLocatedInBackground ? 0.0 : Paths.Seconds) + CefInitializeSeconds + SetupSeconds;
+	SET_FLOAT_STAT(STAT_ChromiumInitLocateFiles, Paths.Seconds * 1000.0);
+	SET_FLOAT_STAT(STAT_ChromiumInitCefInitialize, CefInitializeSeconds * 1000.0);
+	SET_FLOAT_STAT(STAT_ChromiumInitSetup, SetupSeconds * 1000.0);
+	SET_FLOAT_STAT(STAT_ChromiumInitGameThread, TotalSeconds * 1000.0);
+	UE_LOG(ChromiumLogWebBrowser, Log, TEXT("CEF initialized, %.1f ms on the game thread: locating files %.1f ms%s, CefInitialize %.1f ms, setup %.1f ms."),
+		TotalSeconds * 1000.0, Paths.Seconds * 1000.0, bLocatedInBackground ? TEXT(" (in the background)") : TEXT(""), CefInitializeSeconds * 1000.0, SetupSeconds * 1000.0);
+}
+#endif
+
+void FChromiumWebBrowserSingleton::WarmUp()
+{
+#if WITH_CEF3
+	if (bCEFInitialized || PendingStartupPaths.IsValid())
+	{
+		return;
+	}
+
+	// Look for CEF's files on a worker, Tick runs CefInitialize once they have been found
+	const FString LocaleCode = GetCurrentLocaleCode();
+	const FString LanguageCode = FInternationalization::Get().GetCurrentCulture()->GetTwoLetterISOLanguageName();
+	PendingStartupPaths = Async(EAsyncExecution::ThreadPool, [LocaleCode, LanguageCode]()
+	{
+		return LocateCEFFiles(LocaleCode, LanguageCode);
+	});
 #endif
 }
 
 #if WITH_CEF3
+void FChromiumWebBrowserSingleton::HandleEndFrame()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ChromiumGameThreadBrowserWork);
+
+	if (CEFBrowserApp != nullptr)
+	{
+		CEFBrowserApp->GetMessagePump().PumpDueWork();
+	}
+}
+
 void FChromiumWebBrowserSingleton::HandleRenderProcessCreated(CefRefPtr<CefListValue> ExtraInfo)
 {
-	FScopeLock Lock(&WindowInterfacesCS);
-	for (int32 Index = WindowInterfaces.Num() - 1; Index >= 0; --Index)
+	if (!IsInGameThread())
 	{
-		TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = WindowInterfaces[Index].Pin();
+		// CEF calls this on its IO thread whichever way it is pumped. The windows and their registry belong to the game thread,
+		// which publishes their bindings every tick they change.
+		FScopeLock Lock(&ProcessInfoLock);
+		if (PublishedProcessInfo.get() != nullptr)
+		{
+			for (size_t Index = 0; Index < PublishedProcessInfo->GetSize(); ++Index)
+			{
+				ExtraInfo->SetDictionary(ExtraInfo->GetSize(), PublishedProcessInfo->GetDictionary(Index)->Copy(false));
+			}
+		}
+		return;
+	}
+
+	CollectProcessInfo(ExtraInfo);
+}
+
+void FChromiumWebBrowserSingleton::CollectProcessInfo(CefRefPtr<CefListValue> ProcessInfo)
+{
+	for (const TWeakPtr<FChromiumCEFWebBrowserWindow>& WeakBrowserWindow : *WindowInterfaces.GetSnapshot())
+	{
+		TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = WeakBrowserWindow.Pin();
 		if (BrowserWindow.IsValid())
 		{
 			CefRefPtr<CefDictionaryValue> Bindings = BrowserWindow->GetProcessInfo();
 			if (Bindings.get())
 			{
-				ExtraInfo->SetDictionary(ExtraInfo->GetSize(), Bindings);
+				ProcessInfo->SetDictionary(ProcessInfo->GetSize(), Bindings);
 			}
 		}
 	}
 }
+
+void FChromiumWebBrowserSingleton::PublishProcessInfo()
+{
+	const uint32 Serial = FChromiumCEFWebBrowserWindow::GetProcessInfoSerial();
+	if (Serial == PublishedProcessInfoSerial)
+	{
+		return;
+	}
+	PublishedProcessInfoSerial = Serial;
+
+	CefRefPtr<CefListValue> ProcessInfo = CefListValue::Create();
+	CollectProcessInfo(ProcessInfo);
+
+	FScopeLock Lock(&ProcessInfoLock);
+	PublishedProcessInfo = ProcessInfo;
+}
+
+FChromiumWebBrowserWindowHandle FChromiumWebBrowserSingleton::RegisterWindow(const TSharedPtr<FChromiumCEFWebBrowserWindow>& Window)
+{
+	const FChromiumWebBrowserWindowHandle Handle = WindowInterfaces.Add(Window, Window->IsTickActive());
+	Window->OnTickActiveChanged().BindRaw(this, &FChromiumWebBrowserSingleton::HandleWindowTickActiveChanged, Handle);
+	return Handle;
+}
+
+void FChromiumWebBrowserSingleton::HandleWindowTickActiveChanged(bool bActive, FChromiumWebBrowserWindowHandle Handle)
+{
+	WindowInterfaces.SetActive(Handle, bActive);
+}
 #endif
 
 FChromiumWebBrowserSingleton::~FChromiumWebBrowserSingleton()
 {
 #if WITH_CEF3
+	if (!bCEFInitialized)
+	{
+		// Lazy initialization never got as far as starting CEF, a pending WarmUp only holds on to its own results
+		return;
+	}
+
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	IConsoleManager::Get().UnregisterConsoleObject(ListBrowsersCommand);
+	FInternationalization::Get().OnCultureChanged().Remove(CultureChangedHandle);
+	FChromiumCEFRequestRules::SetGlobal(nullptr);
+	// CEF's UI thread must not be left waiting on a game thread that is tearing everything down
+	FChromiumCEFGameThreadQueue::Shutdown();
+
 	{
-		FScopeLock Lock(&WindowInterfacesCS);
 		// Force all existing browsers to close in case any haven't been deleted
-		for (int32 Index = 0; Index < WindowInterfaces.Num(); ++Index)
+		for (const TWeakPtr<FChromiumCEFWebBrowserWindow>& WeakBrowserWindow : *WindowInterfaces.GetSnapshot())
 		{
-			auto BrowserWindow = WindowInterfaces[Index].Pin();
-			if (BrowserWindow.IsValid() && BrowserWindow->IsValid())
+			auto BrowserWindow = WeakBrowserWindow.Pin();
+			if (BrowserWindow.IsValid())
 			{
-				// Call CloseBrowser directly on the Host object as FWebBrowserWindow::CloseBrowser is delayed
-				BrowserWindow->InternalCefBrowser->GetHost()->CloseBrowser(true);
+				// Windows outliving us must not report back
+				BrowserWindow->OnTickActiveChanged().Unbind();
+				if (BrowserWindow->IsValid())
+				{
+					// Call CloseBrowser directly on the Host object as FWebBrowserWindow::CloseBrowser is delayed
+					BrowserWindow->InternalCefBrowser->GetHost()->CloseBrowser(true);
+				}
 			}
 		}
 		// Clear this before CefShutdown() below
 		WindowInterfaces.Reset();
 	}
 
+	BrowserPool.Shutdown();
+	MemoryGovernor.Shutdown();
+	{
+		// Clear this before CefShutdown() below
+		FScopeLock Lock(&ProcessInfoLock);
+		PublishedProcessInfo = nullptr;
+	}
+
 	// Remove references to the scheme handler factories
 	CefClearSchemeHandlerFactories();
 	for (const TPair<FString, CefRefPtr<CefRequestContext>>& RequestContextPair : RequestContexts)
@@ -417,8 +666,17 @@ FChromiumWebBrowserSingleton::~FChromiumWebBrowserSingleton()
 	CEFBrowserApp->OnRenderProcessThreadCreated().Unbind();
 	// CefRefPtr takes care of delete
 	CEFBrowserApp = nullptr;
-	// Ensure we run the message pump
-	CefDoMessageLoopWork();
+
+	const bool bThreadedMessageLoop = FChromiumCEFGameThreadQueue::IsThreadedMessageLoop();
+	// Ensure we run the message pump, or let the CEF thread hand over whatever it has for us
+	if (bThreadedMessageLoop)
+	{
+		FChromiumCEFGameThreadQueue::Drain();
+	}
+	else
+	{
+		CefDoMessageLoopWork();
+	}
 
 	// Keep pumping messages until we see the one below clear the queue
 	bTaskFinished = false;
@@ -430,7 +688,16 @@ FChromiumWebBrowserSingleton::~FChromiumWebBrowserSingleton()
 	const double StartWaitAppTime = FPlatformTime::Seconds();
 	while (!bTaskFinished)
 	{
-		CefDoMessageLoopWork();
+		if (bThreadedMessageLoop)
+		{
+			// CEF's own thread runs the task, but may be waiting on us in the meantime
+			FChromiumCEFGameThreadQueue::Drain();
+			FPlatformProcess::Sleep(0.0f);
+		}
+		else
+		{
+			CefDoMessageLoopWork();
+		}
 		// Wait at most 1 second for tasks to clear, in case CEF crashes/hangs during process lifetime
 		if (FPlatformTime::Seconds() - StartWaitAppTime > 1.0f)
 		{
@@ -441,11 +708,8 @@ FChromiumWebBrowserSingleton::~FChromiumWebBrowserSingleton()
 	// Shut down CEF.
 	CefShutdown();
 #elif PLATFORM_IOS || PLATFORM_PS4 || (PLATFORM_ANDROID && USE_ANDROID_JNI)
-	{
-		FScopeLock Lock(&WindowInterfacesCS);
-		// Clear this before CefShutdown() below
-		WindowInterfaces.Reset();
-	}
+	// Clear this before CefShutdown() below
+	WindowInterfaces.Reset();
 #endif
 }
 
@@ -470,11 +734,10 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 	FString InitialURL = WCHAR_TO_TCHAR(BrowserWindowInfo->Browser->GetMainFrame()->GetURL().ToWString().c_str());
 	TSharedPtr<FChromiumCEFWebBrowserWindow> NewBrowserWindow(new FChromiumCEFWebBrowserWindow(BrowserWindowInfo->Browser, BrowserWindowInfo->Handler, InitialURL, ContentsToLoad, bShowErrorMessage, bThumbMouseButtonNavigation, bUseTransparency, bJSBindingsToLoweringEnabled, bUsingAcceleratedPaint));
 	BrowserWindowInfo->Handler->SetBrowserWindow(NewBrowserWindow);
-	{
-		FScopeLock Lock(&WindowInterfacesCS);
-		WindowInterfaces.Add(NewBrowserWindow);
-	}
-	NewBrowserWindow->GetCefBrowser()->GetHost()->SetWindowlessFrameRate(BrowserWindowParent->GetCefBrowser()->GetHost()->GetWindowlessFrameRate());
+	RegisterWindow(NewBrowserWindow);
+	NewBrowserWindow->SetUsingExternalBeginFrame(BrowserWindowParent->UsingExternalBeginFrame());
+	const int32 ParentMaxFrameRate = BrowserWindowParent->GetMaxFrameRate();
+	NewBrowserWindow->SetFrameRateLimits(BrowserWindowParent->GetMinFrameRateOverride(), ParentMaxFrameRate > 0 ? ParentMaxFrameRate : BrowserWindowParent->GetCefBrowser()->GetHost()->GetWindowlessFrameRate());
 	return NewBrowserWindow;
 #endif
 	return nullptr;
@@ -506,6 +769,16 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 }
 
 TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowserWindow(const FChromiumCreateBrowserWindowSettings& WindowSettings)
+{
+	return CreateBrowserWindowInternal(WindowSettings, false);
+}
+
+TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowserWindowAsync(const FChromiumCreateBrowserWindowSettings& WindowSettings)
+{
+	return CreateBrowserWindowInternal(WindowSettings, true);
+}
+
+TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowserWindowInternal(const FChromiumCreateBrowserWindowSettings& WindowSettings, bool bAsync)
 {
 	bool bBrowserEnabled = true;
 	GConfig->GetBool(TEXT("Browser"), TEXT("bEnabled"), bBrowserEnabled, GEngineIni);
@@ -516,7 +789,7 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 
 #if WITH_CEF3
 	static bool AllowCEF = !FParse::Param(FCommandLine::Get(), TEXT("nocef"));
-	if (AllowCEF)
+	if (AllowCEF && EnsureCEFInitialized())
 	{
 		// Information used when creating the native window.
 		CefWindowInfo WindowInfo;
@@ -547,6 +820,7 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 			// Use off screen rendering so we can integrate with our windows
 			WindowInfo.SetAsWindowless(kNullWindowHandle);
 			WindowInfo.shared_texture_enabled = FChromiumCEFWebBrowserWindow::CanSupportAcceleratedPaint() ? 1 : 0;
+			WindowInfo.external_begin_frame_enabled = bCEFExternalBeginFrame ? 1 : 0;
 			int BrowserFrameRate = WindowSettings.BrowserFrameRate;
 			if (FChromiumCEFWebBrowserWindow::CanSupportAcceleratedPaint() && BrowserFrameRate == 24)
 			{
@@ -557,10 +831,9 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 		}
 
 
-		// WebBrowserHandler implements browser-level callbacks.
-		CefRefPtr<FChromiumCEFBrowserHandler> NewHandler(new FChromiumCEFBrowserHandler(WindowSettings.bUseTransparency, WindowSettings.AltRetryDomains));
-
 		CefRefPtr<CefRequestContext> RequestContext = nullptr;
+		TSharedPtr<const FChromiumCEFRequestRules, ESPMode::ThreadSafe> ContextRequestRules;
+		TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> RequestFilter = DefaultRequestFilter;
 		if (WindowSettings.Context.IsSet())
 		{
 			const FChromiumBrowserContextSettings Context = WindowSettings.Context.GetValue();
@@ -568,30 +841,65 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 
 			if (ExistingRequestContext == nullptr)
 			{
-				CefRequestContextSettings RequestContextSettings;
-				CefString(&RequestContextSettings.accept_language_list) = Context.AcceptLanguageList.IsEmpty() ? TCHAR_TO_WCHAR(*GetCurrentLocaleCode()) : TCHAR_TO_WCHAR(*Context.AcceptLanguageList);
-				CefString(&RequestContextSettings.cache_path) = TCHAR_TO_WCHAR(*GenerateWebCacheFolderName(Context.CookieStorageLocation));
-				RequestContextSettings.persist_session_cookies = Context.bPersistSessionCookies;
-				RequestContextSettings.ignore_certificate_errors = Context.bIgnoreCertificateErrors;
-
-				CefRefPtr<FChromiumCEFResourceContextHandler> ResourceContextHandler = new FChromiumCEFResourceContextHandler();
-				ResourceContextHandler->OnBeforeLoad() = Context.OnBeforeContextResourceLoad;
-				RequestResourceHandlers.Add(Context.Id, ResourceContextHandler);
-
 				//Create a new one
-				RequestContext = CefRequestContext::CreateContext(RequestContextSettings, ResourceContextHandler);
-				RequestContexts.Add(Context.Id, RequestContext);
+				RequestContext = CreateRequestContext(Context);
 			}
 			else
 			{
 				RequestContext = *ExistingRequestContext;
 			}
 			SchemeHandlerFactories.RegisterFactoriesWith(RequestContext);
+
+			// The browser's own handler sees its requests, it applies the context's rules and filter too
+			if (const CefRefPtr<FChromiumCEFResourceContextHandler>* ContextHandler = RequestResourceHandlers.Find(Context.Id))
+			{
+				ContextRequestRules = (*ContextHandler)->GetRequestRules();
+				RequestFilter = (*ContextHandler)->GetRequestFilter();
+			}
 		}
 
-		// Create the CEF browser window.
-		CefRefPtr<CefBrowser> Browser = CefBrowserHost::CreateBrowserSync(WindowInfo, NewHandler.get(), TCHAR_TO_WCHAR(*WindowSettings.InitialURL), BrowserSettings, nullptr, RequestContext);
-		if (Browser.get())
+		const double CreateStartTime = FPlatformTime::Seconds();
+
+		// Take a browser that is already up and running if a windowless one with these settings has been prewarmed
+		CefRefPtr<CefBrowser> Browser;
+		CefRefPtr<FChromiumCEFBrowserHandler> NewHandler;
+		bool bFromPool = false;
+		if (WindowInfo.windowless_rendering_enabled)
+		{
+			const FChromiumCEFBrowserPool::FKey PoolKey(WindowSettings.Context.IsSet() ? WindowSettings.Context->Id : FString(), WindowSettings.bUseTransparency, BrowserSettings.background_color, WindowInfo.external_begin_frame_enabled != 0);
+			bFromPool = BrowserPool.Acquire(PoolKey, RequestContext, Browser, NewHandler);
+		}
+
+		// A render process started for the new browser is handed the published bindings, bring them up to date first
+		PublishProcessInfo();
+
+		if (bFromPool)
+		{
+			NewHandler->SetAltRetryDomains(WindowSettings.AltRetryDomains);
+			NewHandler->SetContextRequestRules(ContextRequestRules);
+			NewHandler->SetRequestFilter(RequestFilter);
+		}
+		else if (bAsync)
+		{
+			// The window is handed out without a browser, CEF creates it below once the window can receive it
+			NewHandler = new FChromiumCEFBrowserHandler(WindowSettings.bUseTransparency, WindowSettings.AltRetryDomains);
+			NewHandler->SetContextRequestRules(ContextRequestRules);
+			NewHandler->SetRequestFilter(RequestFilter);
+		}
+		else
+		{
+			// WebBrowserHandler implements browser-level callbacks.
+			NewHandler = new FChromiumCEFBrowserHandler(WindowSettings.bUseTransparency, WindowSettings.AltRetryDomains);
+			NewHandler->SetContextRequestRules(ContextRequestRules);
+			NewHandler->SetRequestFilter(RequestFilter);
+
+			// Create the CEF browser window. This has to happen on CEF's UI thread, which is only the game thread when we pump it.
+			FChromiumCEFGameThreadQueue::RunOnUIThreadAndWait([&]()
+			{
+				Browser = CefBrowserHost::CreateBrowserSync(WindowInfo, NewHandler.get(), TCHAR_TO_WCHAR(*WindowSettings.InitialURL), BrowserSettings, nullptr, RequestContext);
+			});
+		}
+		if (Browser.get() || bAsync)
 		{
 			// Create new window
 			TSharedPtr<FChromiumCEFWebBrowserWindow> NewBrowserWindow = MakeShareable(new FChromiumCEFWebBrowserWindow(
@@ -604,12 +912,68 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 				WindowSettings.bUseTransparency,
 				bJSBindingsToLoweringEnabled,
 				false));
+			NewBrowserWindow->SetBufferedVideoDepth(WindowSettings.BufferedVideoDepth);
+			NewBrowserWindow->SetFrameRateLimits(WindowSettings.MinBrowserFrameRate, BrowserSettings.windowless_frame_rate);
+			NewBrowserWindow->SetUsingExternalBeginFrame(WindowInfo.external_begin_frame_enabled != 0);
 			NewHandler->SetBrowserWindow(NewBrowserWindow);
+			const FChromiumWebBrowserWindowHandle WindowHandle = RegisterWindow(NewBrowserWindow);
+
+			// Lets the memory governor discard the browser while it is hidden, it comes back with the same settings once shown
+			NewBrowserWindow->OnRecreateBrowser().BindLambda([WindowInfo, BrowserSettings, RequestContext](CefRefPtr<FChromiumCEFBrowserHandler> Handler)
 			{
-				FScopeLock Lock(&WindowInterfacesCS);
-				WindowInterfaces.Add(NewBrowserWindow);
+				return CefBrowserHost::CreateBrowser(WindowInfo, Handler.get(), CefString(), BrowserSettings, nullptr, RequestContext);
+			});
+
+			if (!Browser.get())
+			{
+				TWeakPtr<FChromiumCEFWebBrowserWindow> WeakBrowserWindow = NewBrowserWindow;
+				NewHandler->OnBrowserCreated().BindLambda([WeakBrowserWindow, CreateStartTime](CefRefPtr<CefBrowser> CreatedBrowser)
+				{
+					TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = WeakBrowserWindow.Pin();
+					if (!BrowserWindow.IsValid())
+					{
+						// Nobody is waiting for this browser any more
+						CreatedBrowser->GetHost()->CloseBrowser(true);
+						return;
+					}
+
+					BrowserWindow->OnBrowserCreated(CreatedBrowser);
+
+					const float CreateMs = (FPlatformTime::Seconds() - CreateStartTime) * 1000.0;
+					SET_FLOAT_STAT(STAT_ChromiumBrowserCreation, CreateMs);
+					UE_LOG(ChromiumLogWebBrowser, Verbose, TEXT("Created browser window in %.1f ms (async)"), CreateMs);
+				});
+
+				// Unlike CreateBrowserSync this may be called from any browser process thread and returns straight away
+				if (!CefBrowserHost::CreateBrowser(WindowInfo, NewHandler.get(), TCHAR_TO_WCHAR(*WindowSettings.InitialURL), BrowserSettings, nullptr, RequestContext))
+				{
+					NewHandler->OnBrowserCreated().Unbind();
+					NewBrowserWindow->OnTickActiveChanged().Unbind();
+					WindowInterfaces.Remove(WindowHandle);
+					return nullptr;
+				}
+
+				return NewBrowserWindow;
 			}
 
+			// Pooled browsers are still on about:blank, which is kept out of the window's history
+			if (bFromPool)
+			{
+				NewBrowserWindow->HideInitialHistoryEntry();
+				if (WindowSettings.ContentsToLoad.IsSet())
+				{
+					NewBrowserWindow->LoadString(WindowSettings.ContentsToLoad.GetValue(), WindowSettings.InitialURL);
+				}
+				else if (!WindowSettings.InitialURL.IsEmpty())
+				{
+					NewBrowserWindow->LoadURL(WindowSettings.InitialURL);
+				}
+			}
+
+			const float CreateMs = (FPlatformTime::Seconds() - CreateStartTime) * 1000.0;
+			SET_FLOAT_STAT(STAT_ChromiumBrowserCreation, CreateMs);
+			UE_LOG(ChromiumLogWebBrowser, Verbose, TEXT("Created browser window in %.1f ms (%s)"), CreateMs, bFromPool ? TEXT("pooled") : TEXT("new"));
+
 			return NewBrowserWindow;
 		}
 	}
@@ -623,10 +987,7 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 		WindowSettings.bUseTransparency,
 		bJSBindingsToLoweringEnabled));
 
-	{
-		FScopeLock Lock(&WindowInterfacesCS);
-		WindowInterfaces.Add(NewBrowserWindow);
-	}
+	WindowInterfaces.Add(NewBrowserWindow);
 	return NewBrowserWindow;
 #elif PLATFORM_IOS
 	// Create new window
@@ -638,10 +999,7 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 		WindowSettings.bUseTransparency,
 		bJSBindingsToLoweringEnabled));
 
-	{
-		FScopeLock Lock(&WindowInterfacesCS);
-		WindowInterfaces.Add(NewBrowserWindow);
-	}
+	WindowInterfaces.Add(NewBrowserWindow);
 	return NewBrowserWindow;
 #elif PLATFORM_PS4
 	// Create new window
@@ -652,10 +1010,7 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateBrowse
 		WindowSettings.bThumbMouseButtonNavigation,
 		WindowSettings.bUseTransparency));
 
-	{
-		FScopeLock Lock(&WindowInterfacesCS);
-		WindowInterfaces.Add(NewBrowserWindow);
-	}
+	WindowInterfaces.Add(NewBrowserWindow);
 	return NewBrowserWindow;
 #endif
 	return nullptr;
@@ -675,110 +1030,241 @@ TSharedPtr<IChromiumWebBrowserWindow> FChromiumWebBrowserSingleton::CreateNative
 bool FChromiumWebBrowserSingleton::Tick(float DeltaTime)
 {
     QUICK_SCOPE_CYCLE_COUNTER(STAT_FChromiumWebBrowserSingleton_Tick);
+	SCOPE_CYCLE_COUNTER(STAT_ChromiumGameThreadBrowserWork);
 
 #if WITH_CEF3
+	if (!bCEFInitialized)
 	{
-		FScopeLock Lock(&WindowInterfacesCS);
-		bool bIsSlateAwake = FSlateApplication::IsInitialized() && !FSlateApplication::Get().IsSlateAsleep();
-		// Remove any windows that have been deleted and check whether it's currently visible
-		for (int32 Index = WindowInterfaces.Num() - 1; Index >= 0; --Index)
+		// Finish a warm up once its files have been found
+		if (PendingStartupPaths.IsValid() && PendingStartupPaths.IsReady())
 		{
-			if (!WindowInterfaces[Index].IsValid())
-			{
-				WindowInterfaces.RemoveAt(Index);
-			}
-			else if (bIsSlateAwake) // only check for Tick activity if Slate is currently ticking
-			{
-				TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = WindowInterfaces[Index].Pin();
-				if(BrowserWindow.IsValid())
-				{
-					// Test if we've ticked recently. If not assume the browser window has become hidden.
-					BrowserWindow->CheckTickActivity();
-				}
-			}
+			EnsureCEFInitialized();
 		}
+		return true;
 	}
 
-	if (CEFBrowserApp != nullptr)
+	// One pass over the windows that are showing: hidden ones have nothing to do until Slate shows them again.
+	// Running it ahead of the pump lets CEF act on resizes and begin frames within the same tick.
+	const bool bIsSlateAwake = FSlateApplication::IsInitialized() && !FSlateApplication::Get().IsSlateAsleep();
+	WindowInterfaces.ForEachActive([bIsSlateAwake, DeltaTime](FChromiumCEFWebBrowserWindow& BrowserWindow)
 	{
-		bool bForceMessageLoop = false;
-		GConfig->GetBool(TEXT("Browser"), TEXT("bForceMessageLoop"), bForceMessageLoop, GEngineIni);
+		// Only check for Tick activity if Slate is currently ticking. If we've not ticked recently assume the browser window has become hidden.
+		if (bIsSlateAwake)
+		{
+			BrowserWindow.CheckTickActivity();
+		}
 
-		// Get the configured minimum hertz and make sure the value is within a reasonable range
-		int32 MinMessageLoopHz = 1;
-		GConfig->GetInt(TEXT("Browser"), TEXT("MinMessageLoopHertz"), MinMessageLoopHz, GEngineIni);
-		MinMessageLoopHz = FMath::Clamp(MinMessageLoopHz, 1, 60);
+		// Update video buffering, adapt the frame rate and drive rendering
+		BrowserWindow.UpdateVideoBuffering();
+		BrowserWindow.UpdateFrameRate();
+		BrowserWindow.SendExternalBeginFrame(DeltaTime);
 
-		// Get the configured forced maximum hertz and make sure the value is within a reasonable range
-		int32 MaxForcedMessageLoopHz = 15;
-		GConfig->GetInt(TEXT("Browser"), TEXT("MaxForcedMessageLoopHertz"), MaxForcedMessageLoopHz, GEngineIni);
-		MaxForcedMessageLoopHz = FMath::Clamp(MaxForcedMessageLoopHz, MinMessageLoopHz, 60);
+		// Crashed pages come back while they are showing, hidden ones once they are shown again
+		BrowserWindow.UpdateCrashRecovery();
+	});
+	SET_DWORD_STAT(STAT_ChromiumWindows, WindowInterfaces.Num());
+	SET_DWORD_STAT(STAT_ChromiumActiveWindows, WindowInterfaces.NumActive());
 
-		// @todo: Hack: We rely on OnScheduleMessagePumpWork() which tells us to drive the CEF message pump, 
-		//  there appear to be some edge cases where we might not be getting a signal from it so for the time being 
-		//  we force a minimum rates here and let it run at a configurable maximum rate when we have any WindowInterfaces.
+	SET_DWORD_STAT(STAT_ChromiumThreadedMessageLoop, FChromiumCEFGameThreadQueue::IsThreadedMessageLoop() ? 1 : 0);
+	if (FChromiumCEFGameThreadQueue::IsThreadedMessageLoop())
+	{
+		// CEF pumps itself, we only pick up the callbacks it handed over since the last tick
+		FChromiumCEFGameThreadQueue::Drain();
+	}
+	else if (CEFBrowserApp != nullptr)
+	{
+		CEFBrowserApp->GetMessagePump().Tick(WindowInterfaces.Num() > 0);
+	}
+	PublishProcessInfo();
 
-		// Convert to seconds which we'll use to compare against the time we accumulated since last pump / left till next pump
-		float MinMessageLoopSeconds = 1.0f / MinMessageLoopHz;
-		float MaxForcedMessageLoopSeconds = 1.0f / MaxForcedMessageLoopHz;
+	if (BrowserPool.IsEnabled())
+	{
+		BrowserPool.Refill();
+	}
 
-		static float SecondsSinceLastPump = 0;
-		static float SecondsToNextForcedPump = MaxForcedMessageLoopSeconds;
+	MemoryGovernor.Update(*WindowInterfaces.GetSnapshot());
+	FChromiumCEFRequestRules::UpdateStats();
 
-		// Accumulate time since last pump by adding DeltaTime which gives us the amount of time that has passed since last tick in seconds
-		SecondsSinceLastPump += DeltaTime;
-		// Time left till next pump
-		SecondsToNextForcedPump -= DeltaTime;
+	UpdateTelemetry();
 
-		bool bWantForce = bForceMessageLoop || WindowInterfaces.Num() > 0;    // True if we wish to force message pump
-		bool bCanForce = SecondsToNextForcedPump <= 0;                        // But can we?
-		bool bMustForce = SecondsSinceLastPump >= MinMessageLoopSeconds;      // Absolutely must force (Min frequency rate hit)
+#elif PLATFORM_IOS || PLATFORM_PS4 || (PLATFORM_ANDROID && USE_ANDROID_JNI)
+	bool bIsSlateAwake = FSlateApplication::IsInitialized() && !FSlateApplication::Get().IsSlateAsleep();
+	// Remove any windows that have been deleted and check whether it's currently visible
+	WindowInterfaces.ForEachActive([bIsSlateAwake](IChromiumWebBrowserWindow& BrowserWindow)
+	{
+		if (bIsSlateAwake) // only check for Tick activity if Slate is currently ticking
+		{
+			// Test if we've ticked recently. If not assume the browser window has become hidden.
+			BrowserWindow.CheckTickActivity();
+		}
+	});
+
+#endif
+	return true;
+}
+
+#if WITH_CEF3
+void FChromiumWebBrowserSingleton::UpdateTelemetry()
+{
+	const double Now = FPlatformTime::Seconds();
+	const TSharedRef<const TChromiumWebBrowserWindowRegistry<FChromiumCEFWebBrowserWindow>::FSnapshot> Windows = WindowInterfaces.GetSnapshot();
+
+	if (PendingProcessScan.IsValid() && PendingProcessScan.IsReady())
+	{
+		ApplyProcessScan(PendingProcessScan.Get(), *Windows);
+		PendingProcessScan.Reset();
+	}
 
-		// tick the CEF app to determine when to run CefDoMessageLoopWork
-		if (CEFBrowserApp->TickMessagePump(DeltaTime, (bWantForce && bCanForce) || bMustForce))
+	// The windows sample their rates about once a second, hidden ones included since they may still run scripts and requests
+	if (Now < NextTelemetryTime)
+	{
+		return;
+	}
+	NextTelemetryTime = Now + 1.0;
+
+	float CallbackMilliseconds = 0.0f;
+	float PaintsPerSecond = 0.0f;
+	float UploadedBytesPerSecond = 0.0f;
+	float JSMessagesPerSecond = 0.0f;
+	int32 ResourceRequestsInFlight = 0;
+	uint64 TextureMemoryBytes = 0;
+	FChromiumWebBrowserWindowStats Stats;
+	for (const TWeakPtr<FChromiumCEFWebBrowserWindow>& WeakWindow : *Windows)
+	{
+		TSharedPtr<FChromiumCEFWebBrowserWindow> Window = WeakWindow.Pin();
+		if (Window.IsValid())
 		{
-			SecondsSinceLastPump = 0;
-			SecondsToNextForcedPump = MaxForcedMessageLoopSeconds;
+			Window->UpdateTelemetry(Now);
+			Window->GetStats(Stats);
+			CallbackMilliseconds += Stats.GameThreadMillisecondsPerSecond;
+			PaintsPerSecond += Stats.PaintsPerSecond;
+			UploadedBytesPerSecond += Stats.UploadedBytesPerSecond;
+			JSMessagesPerSecond += Stats.JSMessagesPerSecond;
+			ResourceRequestsInFlight += Stats.ResourceRequestsInFlight;
+			TextureMemoryBytes += Stats.TextureMemoryBytes;
 		}
 	}
+	SET_FLOAT_STAT(STAT_ChromiumCallbackTime, CallbackMilliseconds);
+	SET_FLOAT_STAT(STAT_ChromiumPaintsPerSecond, PaintsPerSecond);
+	SET_FLOAT_STAT(STAT_ChromiumUploadsPerSecond, UploadedBytesPerSecond / (1024.0f * 1024.0f));
+	SET_FLOAT_STAT(STAT_ChromiumJSMessagesPerSecond, JSMessagesPerSecond);
+	SET_DWORD_STAT(STAT_ChromiumResourceRequestsInFlight, ResourceRequestsInFlight);
+	SET_MEMORY_STAT(STAT_ChromiumTextureMemory, TextureMemoryBytes);
+
+	// Walking the process list takes a few milliseconds, so it is done on a worker thread and picked up by a later tick
+	if (CEFTelemetryProcessInterval > 0.0f && Windows->Num() > 0 && !PendingProcessScan.IsValid() && Now >= NextProcessScanTime)
+	{
+		NextProcessScanTime = Now + CEFTelemetryProcessInterval;
+		PendingProcessScan = Async(EAsyncExecution::ThreadPool, [HelperPath = SubProcessPath]()
+		{
+			FProcessScan Scan;
+			FChromiumCEFProcessMemory::Collect(HelperPath, Scan.Processes, &Scan.RenderProcessIds);
+			Scan.Time = FPlatformTime::Seconds();
+			return Scan;
+		});
+	}
+}
 
-	// Update video buffering for any windows that need it
-	for (int32 Index = 0; Index < WindowInterfaces.Num(); Index++)
+void FChromiumWebBrowserSingleton::ApplyProcessScan(const FProcessScan& Scan, const TArray<TWeakPtr<FChromiumCEFWebBrowserWindow>>& Windows)
+{
+	// Processor use is the processor time used since the previous scan over the time between them
+	TMap<uint32, float> CpuPercent;
+	TMap<uint32, double> CpuSeconds;
+	uint64 RenderProcessBytes = 0;
+	float RenderProcessCpu = 0.0f;
+	for (const FChromiumBrowserProcessMemory& Process : Scan.Processes)
 	{
-		if (WindowInterfaces[Index].IsValid())
+		CpuSeconds.Add(Process.ProcessId, Process.CpuSeconds);
+		const double* PreviousCpuSeconds = ProcessCpuSeconds.Find(Process.ProcessId);
+		const float Percent = (PreviousCpuSeconds != nullptr && Scan.Time > ProcessScanTime)
+			? (float)(FMath::Max(Process.CpuSeconds - *PreviousCpuSeconds, 0.0) / (Scan.Time - ProcessScanTime) * 100.0)
+			: 0.0f;
+		CpuPercent.Add(Process.ProcessId, Percent);
+
+		if (Process.Type == TEXT("renderer"))
 		{
-			TSharedPtr<FChromiumCEFWebBrowserWindow> BrowserWindow = WindowInterfaces[Index].Pin();
-			if (BrowserWindow.IsValid())
-			{
-				BrowserWindow->UpdateVideoBuffering();
-			}
+			RenderProcessBytes += Process.WorkingSetBytes;
+			RenderProcessCpu += Percent;
 		}
 	}
+	ProcessCpuSeconds = MoveTemp(CpuSeconds);
+	ProcessScanTime = Scan.Time;
+	SET_MEMORY_STAT(STAT_ChromiumRenderProcessMemory, RenderProcessBytes);
+	SET_FLOAT_STAT(STAT_ChromiumRenderProcessCpu, RenderProcessCpu);
 
-#elif PLATFORM_IOS || PLATFORM_PS4 || (PLATFORM_ANDROID && USE_ANDROID_JNI)
-	FScopeLock Lock(&WindowInterfacesCS);
-	bool bIsSlateAwake = FSlateApplication::IsInitialized() && !FSlateApplication::Get().IsSlateAsleep();
-	// Remove any windows that have been deleted and check whether it's currently visible
-	for (int32 Index = WindowInterfaces.Num() - 1; Index >= 0; --Index)
+	for (const TWeakPtr<FChromiumCEFWebBrowserWindow>& WeakWindow : Windows)
 	{
-		if (!WindowInterfaces[Index].IsValid())
+		TSharedPtr<FChromiumCEFWebBrowserWindow> Window = WeakWindow.Pin();
+		if (!Window.IsValid())
 		{
-			WindowInterfaces.RemoveAt(Index);
+			continue;
 		}
-		else if (bIsSlateAwake) // only check for Tick activity if Slate is currently ticking
+
+		const uint32* ProcessId = Scan.RenderProcessIds.Find(Window->GetRenderProcessClientId());
+		const FChromiumBrowserProcessMemory* Process = ProcessId != nullptr
+			? Scan.Processes.FindByPredicate([ProcessId](const FChromiumBrowserProcessMemory& Candidate) { return Candidate.ProcessId == *ProcessId; })
+			: nullptr;
+		if (Process != nullptr)
 		{
-			TSharedPtr<IChromiumWebBrowserWindow> BrowserWindow = WindowInterfaces[Index].Pin();
-			if (BrowserWindow.IsValid())
+			Window->SetRenderProcessStats(Process->ProcessId, Process->WorkingSetBytes, CpuPercent.FindRef(Process->ProcessId));
+		}
+		else
+		{
+			Window->SetRenderProcessStats(0, 0, 0.0f);
+		}
+	}
+}
+
+void FChromiumWebBrowserSingleton::ListBrowsers(FOutputDevice& Ar)
+{
+	struct FEntry
+	{
+		TSharedPtr<FChromiumCEFWebBrowserWindow> Window;
+		FChromiumWebBrowserWindowStats Stats;
+	};
+
+	TArray<FEntry> Entries;
+	for (const TWeakPtr<FChromiumCEFWebBrowserWindow>& WeakWindow : *WindowInterfaces.GetSnapshot())
+	{
+		TSharedPtr<FChromiumCEFWebBrowserWindow> Window = WeakWindow.Pin();
+		if (Window.IsValid())
+		{
+			FEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.Window = Window;
+			Window->GetStats(Entry.Stats);
+		}
+	}
+	Entries.Sort([](const FEntry& A, const FEntry& B)
+	{
+		return A.Stats.GameThreadMillisecondsPerSecond > B.Stats.GameThreadMillisecondsPerSecond;
+	});
+
+	Ar.Logf(TEXT("%d browser windows, rates per second:"), Entries.Num());
+	Ar.Logf(TEXT("%-9s %9s %-12s %7s %7s %9s %7s %8s %8s %6s %6s %5s  %s"),
+		TEXT("State"), TEXT("Size"), TEXT("Busiest"), TEXT("GT ms"), TEXT("Paints"), TEXT("Upload KB"), TEXT("Tex MB"),
+		TEXT("Renderer"), TEXT("RSS MB"), TEXT("CPU %"), TEXT("JS"), TEXT("Reqs"), TEXT("Url"));
+	for (const FEntry& Entry : Entries)
+	{
+		const FChromiumWebBrowserWindowStats& Stats = Entry.Stats;
+		const FChromiumWebBrowserCallbackStats* Busiest = nullptr;
+		for (const FChromiumWebBrowserCallbackStats& Callback : Stats.Callbacks)
+		{
+			if (Busiest == nullptr || Callback.MillisecondsPerSecond > Busiest->MillisecondsPerSecond)
 			{
-				// Test if we've ticked recently. If not assume the browser window has become hidden.
-				BrowserWindow->CheckTickActivity();
+				Busiest = &Callback;
 			}
 		}
-	}
 
-#endif
-	return true;
+		const FIntPoint Size = Entry.Window->GetViewportSize();
+		const TCHAR* State = Entry.Window->IsDiscarded() ? TEXT("Discarded") : (Entry.Window->IsTickActive() ? TEXT("Visible") : TEXT("Hidden"));
+		Ar.Logf(TEXT("%-9s %4dx%-4d %-12s %7.2f %7.1f %9.1f %7.1f %8u %8.1f %6.1f %6.1f %5d  %s"),
+			State, Size.X, Size.Y, Busiest != nullptr ? *Busiest->Callback.ToString() : TEXT("-"), Stats.GameThreadMillisecondsPerSecond,
+			Stats.PaintsPerSecond, Stats.UploadedBytesPerSecond / 1024.0f, Stats.TextureMemoryBytes / (1024.0f * 1024.0f),
+			Stats.RenderProcessId, Stats.RenderProcessMemoryBytes / (1024.0f * 1024.0f), Stats.RenderProcessCpuPercent,
+			Stats.JSMessagesPerSecond, Stats.ResourceRequestsInFlight, *Entry.Window->GetUrl());
+	}
 }
+#endif
 
 FString FChromiumWebBrowserSingleton::GetCurrentLocaleCode()
 {
@@ -795,6 +1281,9 @@ FString FChromiumWebBrowserSingleton::GetCurrentLocaleCode()
 PRAGMA_DISABLE_DEPRECATION_WARNINGS
 void FChromiumWebBrowserSingleton::DeleteBrowserCookies(FString URL, FString CookieName, TFunction<void(int)> Completed)
 {
+#if WITH_CEF3
+	EnsureCEFInitialized();
+#endif
 	if (DefaultCookieManager.IsValid())
 	{
 		DefaultCookieManager->DeleteCookies(URL, CookieName, Completed);
@@ -883,6 +1372,11 @@ void FChromiumWebBrowserSingleton::ClearOldCacheFolders(const FString &CachePath
 bool FChromiumWebBrowserSingleton::RegisterContext(const FChromiumBrowserContextSettings& Settings)
 {
 #if WITH_CEF3
+	if (!EnsureCEFInitialized())
+	{
+		return false;
+	}
+
 	const CefRefPtr<CefRequestContext>* ExistingContext = RequestContexts.Find(Settings.Id);
 
 	if (ExistingContext != nullptr)
@@ -892,21 +1386,109 @@ bool FChromiumWebBrowserSingleton::RegisterContext(const FChromiumBrowserContext
 		return false;
 	}
 
-	CefRequestContextSettings RequestContextSettings;
-	CefString(&RequestContextSettings.accept_language_list) = Settings.AcceptLanguageList.IsEmpty() ? TCHAR_TO_WCHAR(*GetCurrentLocaleCode()) : TCHAR_TO_WCHAR(*Settings.AcceptLanguageList);
-	CefString(&RequestContextSettings.cache_path) = TCHAR_TO_WCHAR(*GenerateWebCacheFolderName(Settings.CookieStorageLocation));
-	RequestContextSettings.persist_session_cookies = Settings.bPersistSessionCookies;
-	RequestContextSettings.ignore_certificate_errors = Settings.bIgnoreCertificateErrors;
-
 	//Create a new one
+	CreateRequestContext(Settings);
+	return true;
+#else
+	return false;
+#endif
+}
+
+#if WITH_CEF3
+CefRefPtr<CefRequestContext> FChromiumWebBrowserSingleton::CreateRequestContext(const FChromiumBrowserContextSettings& Settings)
+{
 	CefRefPtr<FChromiumCEFResourceContextHandler> ResourceContextHandler = new FChromiumCEFResourceContextHandler();
 	ResourceContextHandler->OnBeforeLoad() = Settings.OnBeforeContextResourceLoad;
+	if (Settings.RequestRules.Num() > 0)
+	{
+		// Accept-Language is left to the global rules
+		ResourceContextHandler->SetRequestRules(MakeShared<FChromiumCEFRequestRules, ESPMode::ThreadSafe>(FString(), Settings.RequestRules));
+	}
+	ResourceContextHandler->GetRequestFilter()->SetRules(Settings.RequestFilter);
 	RequestResourceHandlers.Add(Settings.Id, ResourceContextHandler);
-	CefRefPtr<CefRequestContext> RequestContext = CefRequestContext::CreateContext(RequestContextSettings, ResourceContextHandler);
+
+	CefRefPtr<CefRequestContext> RequestContext;
+	if (Settings.bShareRenderProcesses)
+	{
+		// Sharing the global context's storage lets CEF place this context's sites in the same render processes as the default one
+		RequestContext = CefRequestContext::CreateContext(CefRequestContext::GetGlobalContext(), ResourceContextHandler);
+	}
+	else
+	{
+		CefRequestContextSettings RequestContextSettings;
+		CefString(&RequestContextSettings.accept_language_list) = Settings.AcceptLanguageList.IsEmpty() ? TCHAR_TO_WCHAR(*GetCurrentLocaleCode()) : TCHAR_TO_WCHAR(*Settings.AcceptLanguageList);
+		CefString(&RequestContextSettings.cache_path) = TCHAR_TO_WCHAR(*GenerateWebCacheFolderName(Settings.CookieStorageLocation));
+		RequestContextSettings.persist_session_cookies = Settings.bPersistSessionCookies;
+		RequestContextSettings.ignore_certificate_errors = Settings.bIgnoreCertificateErrors;
+		RequestContext = CefRequestContext::CreateContext(RequestContextSettings, ResourceContextHandler);
+	}
+
 	RequestContexts.Add(Settings.Id, RequestContext);
-	return true;
-#else
+	return RequestContext;
+}
+#endif
+
+void FChromiumWebBrowserSingleton::SetResourceRequestRules(const TArray<FChromiumResourceRequestRule>& Rules)
+{
+#if WITH_CEF3
+	ResourceRequestRules = Rules;
+	if (bCEFInitialized)
+	{
+		UpdateGlobalRequestRules();
+	}
+#endif
+}
+
+bool FChromiumWebBrowserSingleton::SetRequestFilter(const TOptional<FString>& ContextId, const TArray<FChromiumRequestFilterRule>& Rules)
+{
+#if WITH_CEF3
+	if (TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> Filter = FindRequestFilter(ContextId))
+	{
+		Filter->SetRules(Rules);
+		return true;
+	}
+#endif
+	return false;
+}
+
+bool FChromiumWebBrowserSingleton::GetRequestFilterHits(const TOptional<FString>& ContextId, TArray<uint64>& OutHits) const
+{
+	OutHits.Reset();
+#if WITH_CEF3
+	if (TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> Filter = FindRequestFilter(ContextId))
+	{
+		Filter->GetHits(OutHits);
+		return true;
+	}
+#endif
 	return false;
+}
+
+#if WITH_CEF3
+TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> FChromiumWebBrowserSingleton::FindRequestFilter(const TOptional<FString>& ContextId) const
+{
+	if (!ContextId.IsSet())
+	{
+		return DefaultRequestFilter;
+	}
+	const CefRefPtr<FChromiumCEFResourceContextHandler>* ContextHandler = RequestResourceHandlers.Find(ContextId.GetValue());
+	return ContextHandler != nullptr ? TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe>((*ContextHandler)->GetRequestFilter()) : nullptr;
+}
+
+void FChromiumWebBrowserSingleton::UpdateGlobalRequestRules()
+{
+	FChromiumCEFRequestRules::SetGlobal(MakeShared<FChromiumCEFRequestRules, ESPMode::ThreadSafe>(GetCurrentLocaleCode(), ResourceRequestRules));
+}
+#endif
+
+void FChromiumWebBrowserSingleton::GetProcessMemoryReport(TArray<FChromiumBrowserProcessMemory>& OutProcesses) const
+{
+	OutProcesses.Reset();
+#if WITH_CEF3
+	if (bCEFInitialized)
+	{
+		FChromiumCEFProcessMemory::Collect(SubProcessPath, OutProcesses);
+	}
 #endif
 }
 
@@ -955,6 +1537,24 @@ bool FChromiumWebBrowserSingleton::UnregisterSchemeHandlerFactory(IChromiumWebBr
 #endif
 }
 
+bool FChromiumWebBrowserSingleton::RegisterArchiveSchemeHandler(FString Scheme, FString Domain, const FString& ArchiveFilename)
+{
+#if WITH_CEF3
+	return SchemeHandlerFactories.AddArchiveSchemeHandlerFactory(MoveTemp(Scheme), MoveTemp(Domain), ArchiveFilename);
+#else
+	return false;
+#endif
+}
+
+bool FChromiumWebBrowserSingleton::UnregisterArchiveSchemeHandler(const FString& Scheme, const FString& Domain)
+{
+#if WITH_CEF3
+	return SchemeHandlerFactories.RemoveArchiveSchemeHandlerFactory(Scheme, Domain);
+#else
+	return false;
+#endif
+}
+
 // Cleanup macros to avoid having them leak outside this source file
 #undef CEF3_BIN_DIR
 #undef CEF3_FRAMEWORK_DIR
@@ -4,7 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "Containers/Ticker.h"
+#include "Async/Future.h"
 #include "IChromiumWebBrowserSingleton.h"
+#include "ChromiumWebBrowserModule.h"
+#include "ChromiumWebBrowserWindowRegistry.h"
 
 #if WITH_CEF3
 #if PLATFORM_WINDOWS
@@ -31,12 +34,16 @@ THIRD_PARTY_INCLUDES_END
 #endif
 #include "CEF/ChromiumCEFSchemeHandler.h"
 #include "CEF/ChromiumCEFResourceContextHandler.h"
+#include "CEF/ChromiumCEFRequestFilter.h"
+#include "CEF/ChromiumCEFBrowserPool.h"
+#include "CEF/ChromiumCEFMemoryGovernor.h"
 class CefListValue;
 class FChromiumCEFBrowserApp;
 class FChromiumCEFWebBrowserWindow;
 #endif
 
 class IChromiumWebBrowserCookieManager;
+class IConsoleObject;
 class IChromiumWebBrowserWindow;
 struct FChromiumWebBrowserWindowInfo;
 struct FChromiumWebBrowserInitSettings;
@@ -91,6 +98,18 @@ public:
 
 	TSharedPtr<IChromiumWebBrowserWindow> CreateBrowserWindow(const FChromiumCreateBrowserWindowSettings& Settings) override;
 
+	TSharedPtr<IChromiumWebBrowserWindow> CreateBrowserWindowAsync(const FChromiumCreateBrowserWindowSettings& Settings) override;
+
+	virtual void WarmUp() override;
+
+	virtual void GetProcessMemoryReport(TArray<FChromiumBrowserProcessMemory>& OutProcesses) const override;
+
+	virtual void SetResourceRequestRules(const TArray<FChromiumResourceRequestRule>& Rules) override;
+
+	virtual bool SetRequestFilter(const TOptional<FString>& ContextId, const TArray<FChromiumRequestFilterRule>& Rules) override;
+
+	virtual bool GetRequestFilterHits(const TOptional<FString>& ContextId, TArray<uint64>& OutHits) const override;
+
 #if	BUILD_EMBEDDED_APP
 	TSharedPtr<IChromiumWebBrowserWindow> CreateNativeBrowserProxy() override;
 #endif
@@ -112,6 +131,10 @@ public:
 
 	virtual bool UnregisterSchemeHandlerFactory(IChromiumWebBrowserSchemeHandlerFactory* WebBrowserSchemeHandlerFactory) override;
 
+	virtual bool RegisterArchiveSchemeHandler(FString Scheme, FString Domain, const FString& ArchiveFilename) override;
+
+	virtual bool UnregisterArchiveSchemeHandler(const FString& Scheme, const FString& Domain) override;
+
 	virtual bool IsDevToolsShortcutEnabled() override
 	{
 		return bDevToolsShortcutEnabled;
@@ -163,9 +186,62 @@ private:
 
 	TSharedPtr<IChromiumWebBrowserCookieManager> DefaultCookieManager;
 
+	/** Shared implementation of CreateBrowserWindow and CreateBrowserWindowAsync. */
+	TSharedPtr<IChromiumWebBrowserWindow> CreateBrowserWindowInternal(const FChromiumCreateBrowserWindowSettings& Settings, bool bAsync);
+
 #if WITH_CEF3
+	/** Locations of CEF's files, checked for existence before CefInitialize. */
+	struct FCEFStartupPaths
+	{
+		FString ResourcesPath;
+		FString LocalesPath;
+		FString FrameworkPath;
+		FString SubProcessPath;
+		/** Locale to start CEF with, falls back to the language on Mac when there is no pak for the region. */
+		FString LocaleCode;
+		/** Time spent looking for the files. */
+		double Seconds = 0.0;
+	};
+
+	/** Builds the paths CEF is started with and checks they exist. Only touches the file system, so it may run on any thread. */
+	static FCEFStartupPaths LocateCEFFiles(const FString& LocaleCode, const FString& LanguageCode);
+	/** Starts CEF unless it is already running, waiting for a pending WarmUp if there is one. @return Whether CEF is running. */
+	bool EnsureCEFInitialized();
+	/** Runs CefInitialize and sets up everything that depends on it. */
+	void InitializeCEF(const FCEFStartupPaths& Paths, bool bLocatedInBackground);
 	/** When new render processes are created, send all permanent variable bindings to them. */
 	void HandleRenderProcessCreated(CefRefPtr<CefListValue> ExtraInfo);
+	/** Adds the process info of every window to a list. Game thread only. */
+	void CollectProcessInfo(CefRefPtr<CefListValue> ProcessInfo);
+	/** Republishes the process info render processes are given off the game thread, if a window's has changed. */
+	void PublishProcessInfo();
+	/** Runs CEF work that came due during the frame instead of leaving it until the next tick. */
+	void HandleEndFrame();
+	/** Adds a window to WindowInterfaces and keeps its active state up to date. */
+	FChromiumWebBrowserWindowHandle RegisterWindow(const TSharedPtr<FChromiumCEFWebBrowserWindow>& Window);
+	/** Moves a window between the active and the dormant windows when it is shown or hidden. */
+	void HandleWindowTickActiveChanged(bool bActive, FChromiumWebBrowserWindowHandle Handle);
+	/** Creates the request context for a browser context and its resource handler, and adds both to the maps. */
+	CefRefPtr<CefRequestContext> CreateRequestContext(const FChromiumBrowserContextSettings& Settings);
+	/** Render and helper processes found by a background scan for the telemetry. */
+	struct FProcessScan
+	{
+		/** When the scan finished, in FPlatformTime::Seconds. */
+		double Time = 0.0;
+		TArray<FChromiumBrowserProcessMemory> Processes;
+		/** Process id of each render process, keyed by Chromium's id for it. */
+		TMap<int32, uint32> RenderProcessIds;
+	};
+	/** Samples the windows' telemetry once a second, updates the stats and schedules process scans. */
+	void UpdateTelemetry();
+	/** Hands each window the figures of its render process. */
+	void ApplyProcessScan(const FProcessScan& Scan, const TArray<TWeakPtr<FChromiumCEFWebBrowserWindow>>& Windows);
+	/** Handler of the ChromiumUI.ListBrowsers console command. */
+	void ListBrowsers(FOutputDevice& Ar);
+	/** @return The request filter of a context, or of the browsers without one if unset. Null if there is no such context. */
+	TSharedPtr<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> FindRequestFilter(const TOptional<FString>& ContextId) const;
+	/** Publishes the request rules with the Accept-Language of the current culture to CEF's IO thread. */
+	void UpdateGlobalRequestRules();
 	/** Helper function to generate the CEF build unique name for the cache_path */
 	FString GenerateWebCacheFolderName(const FString &InputPath);
 	/** Pointer to the CEF App implementation */
@@ -174,20 +250,52 @@ private:
 	TMap<FString, CefRefPtr<CefRequestContext>> RequestContexts;
 	TMap<FString, CefRefPtr<FChromiumCEFResourceContextHandler>> RequestResourceHandlers;
 	FChromiumCefSchemeHandlerFactories SchemeHandlerFactories;
+	/** Hidden browsers kept ready to be handed out by CreateBrowserWindow */
+	FChromiumCEFBrowserPool BrowserPool;
+	/** Discards hidden browsers to stay within the resident browser budget */
+	FChromiumCEFMemoryGovernor MemoryGovernor;
 	bool bAllowCEF;
 	bool bTaskFinished;
+	FDelegateHandle EndFrameHandle;
+	/** Whether CefInitialize has run, which [Browser] bLazyInitialize defers until CEF is first needed. */
+	bool bCEFInitialized;
+	/** Product version appended to the user agent, kept until CEF is started. */
+	FString ProductVersion;
+	/** Process model CEF is started with, kept until CEF is started. */
+	FChromiumBrowserProcessModelSettings ProcessModel;
+	/** Render and helper processes are instances of this executable, used to find them for the process memory report. */
+	FString SubProcessPath;
+	/** When the windows next sample their telemetry, and when the next process scan may start. */
+	double NextTelemetryTime = 0.0;
+	double NextProcessScanTime = 0.0;
+	/** Process scan running on a worker thread. */
+	TFuture<FProcessScan> PendingProcessScan;
+	/** Processor time of each helper process as of the last process scan, and when that scan finished. */
+	TMap<uint32, double> ProcessCpuSeconds;
+	double ProcessScanTime = 0.0;
+	/** The ChromiumUI.ListBrowsers console command. */
+	IConsoleObject* ListBrowsersCommand = nullptr;
+	/** Header rules applied to every browser's requests, see SetResourceRequestRules. */
+	TArray<FChromiumResourceRequestRule> ResourceRequestRules;
+	FDelegateHandle CultureChangedHandle;
+	/** Request filter of the browsers created without a context. */
+	TSharedRef<FChromiumCEFRequestFilter, ESPMode::ThreadSafe> DefaultRequestFilter = MakeShared<FChromiumCEFRequestFilter, ESPMode::ThreadSafe>();
+	/** Files being located by WarmUp on a worker thread. */
+	TFuture<FCEFStartupPaths> PendingStartupPaths;
+	/** Process info of every window as of the last tick, handed to render processes created off the game thread. */
+	CefRefPtr<CefListValue> PublishedProcessInfo;
+	FCriticalSection ProcessInfoLock;
+	/** FChromiumCEFWebBrowserWindow::GetProcessInfoSerial as of the last PublishProcessInfo. */
+	uint32 PublishedProcessInfoSerial = 0;
 #endif
 
-	/** List of currently existing browser windows */
+	/** Currently existing browser windows */
 #if WITH_CEF3
-	TArray<TWeakPtr<FChromiumCEFWebBrowserWindow>>	WindowInterfaces;
+	TChromiumWebBrowserWindowRegistry<FChromiumCEFWebBrowserWindow> WindowInterfaces;
 #elif PLATFORM_IOS || PLATFORM_PS4 || (PLATFORM_ANDROID && USE_ANDROID_JNI)
-	TArray<TWeakPtr<IChromiumWebBrowserWindow>>	WindowInterfaces;
+	TChromiumWebBrowserWindowRegistry<IChromiumWebBrowserWindow> WindowInterfaces;
 #endif
 
-	/** Critical section for thread safe modification of WindowInterfaces array. */
-	FCriticalSection WindowInterfacesCS;
-
 	TSharedRef<IChromiumWebBrowserWindowFactory> WebBrowserWindowFactory;
 
 	bool bDevToolsShortcutEnabled;
@@ -0,0 +1,246 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Stable reference to a window in a TChromiumWebBrowserWindowRegistry.
+ * Slots are reused once a window is gone, the generation keeps handles to the old window from matching the new one.
+ */
+struct FChromiumWebBrowserWindowHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+};
+
+/**
+ * The browser windows known to the singleton, kept in a generational slot array.
+ *
+ * Windows are either active, meaning they need the per-tick work done by the singleton, or dormant (hidden) and skipped by
+ * ForEachActive until they report being active again. Windows that were destroyed are dropped during ForEachActive: active ones
+ * when they are visited, dormant ones a slot per tick. Readers that need every window take the snapshot, an immutable list that
+ * is republished whenever a window is added or removed, so they never need a lock and may add or remove windows while iterating.
+ *
+ * Game thread only, the snapshot included: neither it nor its reference count is safe to touch from another thread. CEF callbacks
+ * arriving on other threads are either marshalled to the game thread or answered from state the game thread published for them.
+ */
+template<typename WindowType>
+class TChromiumWebBrowserWindowRegistry
+{
+public:
+	typedef TArray<TWeakPtr<WindowType>> FSnapshot;
+
+	TChromiumWebBrowserWindowRegistry()
+		: Snapshot(MakeShared<const FSnapshot>())
+		, SweepIndex(0)
+	{
+	}
+
+	/** Registers a window. @return The handle to refer to it by. */
+	FChromiumWebBrowserWindowHandle Add(const TSharedPtr<WindowType>& Window, bool bActive = true)
+	{
+		check(Window.IsValid());
+
+		int32 Index;
+		if (FreeSlots.Num() > 0)
+		{
+			Index = FreeSlots.Pop(false);
+		}
+		else
+		{
+			Index = Slots.AddDefaulted();
+		}
+
+		FSlot& Slot = Slots[Index];
+		Slot.Window = Window;
+		Slot.bOccupied = true;
+
+		FChromiumWebBrowserWindowHandle Handle;
+		Handle.Index = Index;
+		Handle.Generation = Slot.Generation;
+		SetActive(Handle, bActive);
+
+		PublishSnapshot();
+		return Handle;
+	}
+
+	/** Unregisters a window. Does nothing if the handle is stale. */
+	void Remove(FChromiumWebBrowserWindowHandle Handle)
+	{
+		if (IsCurrent(Handle))
+		{
+			FreeSlot(Handle.Index);
+			PublishSnapshot();
+		}
+	}
+
+	/** @return The window a handle refers to, or nullptr if it was removed or destroyed. */
+	TSharedPtr<WindowType> Find(FChromiumWebBrowserWindowHandle Handle) const
+	{
+		return IsCurrent(Handle) ? Slots[Handle.Index].Window.Pin() : nullptr;
+	}
+
+	/** Moves a window between the active and the dormant set. */
+	void SetActive(FChromiumWebBrowserWindowHandle Handle, bool bActive)
+	{
+		if (!IsCurrent(Handle))
+		{
+			return;
+		}
+
+		FSlot& Slot = Slots[Handle.Index];
+		if (bActive && Slot.ActiveIndex == INDEX_NONE)
+		{
+			Slot.ActiveIndex = ActiveSlots.Add(Handle.Index);
+		}
+		else if (!bActive && Slot.ActiveIndex != INDEX_NONE)
+		{
+			RemoveActive(Slot);
+		}
+	}
+
+	/** @return Number of registered windows. */
+	int32 Num() const { return Snapshot->Num(); }
+
+	/** @return Number of windows visited by ForEachActive. */
+	int32 NumActive() const { return ActiveSlots.Num(); }
+
+	/** @return Every registered window, as of the last time one was added or removed. */
+	TSharedRef<const FSnapshot> GetSnapshot() const { return Snapshot; }
+
+	/**
+	 * Calls Func for every active window that is still alive, in a single pass. The callback may add, remove or deactivate windows,
+	 * windows added during the pass are first visited on the next one: slots freed during a pass are only reused once it is over,
+	 * so a new window never takes the slot of one still due to be visited.
+	 */
+	template<typename FuncType>
+	void ForEachActive(FuncType&& Func)
+	{
+		bool bRemovedAny = false;
+		++PassDepth;
+
+		// A dormant window is never visited, so check one of them per pass for having been destroyed
+		if (Slots.Num() > 0)
+		{
+			SweepIndex = (SweepIndex + 1) % Slots.Num();
+			const FSlot& Slot = Slots[SweepIndex];
+			if (Slot.bOccupied && !Slot.Window.IsValid())
+			{
+				FreeSlot(SweepIndex);
+				bRemovedAny = true;
+			}
+		}
+
+		const TArray<int32, TInlineAllocator<32>> Visit(ActiveSlots);
+		for (const int32 Index : Visit)
+		{
+			const FSlot& Slot = Slots[Index];
+			if (Slot.ActiveIndex == INDEX_NONE)
+			{
+				// Deactivated or removed by an earlier callback
+				continue;
+			}
+
+			TSharedPtr<WindowType> Window = Slot.Window.Pin();
+			if (!Window.IsValid())
+			{
+				FreeSlot(Index);
+				bRemovedAny = true;
+				continue;
+			}
+
+			Func(*Window);
+		}
+
+		if (--PassDepth == 0)
+		{
+			FreeSlots.Append(DeferredFreeSlots);
+			DeferredFreeSlots.Reset();
+		}
+
+		if (bRemovedAny)
+		{
+			PublishSnapshot();
+		}
+	}
+
+	/** Unregisters every window. */
+	void Reset()
+	{
+		Slots.Reset();
+		FreeSlots.Reset();
+		DeferredFreeSlots.Reset();
+		ActiveSlots.Reset();
+		SweepIndex = 0;
+		PublishSnapshot();
+	}
+
+private:
+	struct FSlot
+	{
+		TWeakPtr<WindowType> Window;
+		uint32 Generation = 0;
+		/** Position in ActiveSlots, INDEX_NONE while dormant or free. */
+		int32 ActiveIndex = INDEX_NONE;
+		bool bOccupied = false;
+	};
+
+	bool IsCurrent(FChromiumWebBrowserWindowHandle Handle) const
+	{
+		return Slots.IsValidIndex(Handle.Index) && Slots[Handle.Index].bOccupied && Slots[Handle.Index].Generation == Handle.Generation;
+	}
+
+	void RemoveActive(FSlot& Slot)
+	{
+		const int32 ActiveIndex = Slot.ActiveIndex;
+		ActiveSlots.RemoveAtSwap(ActiveIndex, 1, false);
+		if (ActiveSlots.IsValidIndex(ActiveIndex))
+		{
+			Slots[ActiveSlots[ActiveIndex]].ActiveIndex = ActiveIndex;
+		}
+		Slot.ActiveIndex = INDEX_NONE;
+	}
+
+	void FreeSlot(int32 Index)
+	{
+		FSlot& Slot = Slots[Index];
+		if (Slot.ActiveIndex != INDEX_NONE)
+		{
+			RemoveActive(Slot);
+		}
+		Slot.Window.Reset();
+		Slot.bOccupied = false;
+		++Slot.Generation;
+		(PassDepth > 0 ? DeferredFreeSlots : FreeSlots).Add(Index);
+	}
+
+	/** Replaces the snapshot, readers still holding the previous one keep it alive until they are done. */
+	void PublishSnapshot()
+	{
+		TSharedRef<FSnapshot> NewSnapshot = MakeShared<FSnapshot>();
+		NewSnapshot->Reserve(Slots.Num() - FreeSlots.Num() - DeferredFreeSlots.Num());
+		for (const FSlot& Slot : Slots)
+		{
+			if (Slot.bOccupied)
+			{
+				NewSnapshot->Add(Slot.Window);
+			}
+		}
+		Snapshot = NewSnapshot;
+	}
+
+	TArray<FSlot> Slots;
+	TArray<int32> FreeSlots;
+	/** Slots freed during ForEachActive, reused once the pass is over. */
+	TArray<int32> DeferredFreeSlots;
+	/** Number of ForEachActive calls in progress. */
+	int32 PassDepth = 0;
+	/** Dense list of the slots visited by ForEachActive. */
+	TArray<int32> ActiveSlots;
+	TSharedRef<const FSnapshot> Snapshot;
+	/** Next dormant slot checked for a destroyed window. */
+	int32 SweepIndex;
+};
@@ -8,6 +8,7 @@
 #include "ChromiumWebBrowserModule.h"
 #include "IChromiumWebBrowserWindow.h"
 #include "IChromiumWebBrowserPopupFeatures.h"
+#include "ChromiumWebBrowserReadback.h"
 #define LOCTEXT_NAMESPACE "ChromiumWebBrowser"
 
 SChromiumWebBrowser::SChromiumWebBrowser()
@@ -81,14 +82,20 @@ void SChromiumWebBrowser::Construct(const FArguments& InArgs, const TSharedPtr<I
 		Settings.ContentsToLoad = InArgs._ContentsToLoad;
 		Settings.bShowErrorMessage = UE_BUILD_DEVELOPMENT || UE_BUILD_DEBUG;
 		Settings.bThumbMouseButtonNavigation = false;
+		Settings.BufferedVideoDepth = InArgs._BufferedVideoDepth;
+		Settings.MinBrowserFrameRate = InArgs._MinBrowserFrameRate;
 
 		IChromiumWebBrowserSingleton* Singleton = IChromiumWebBrowserModule::Get().GetSingleton();
 		if (Singleton)
 		{
-			BrowserWindow = Singleton->CreateBrowserWindow(Settings);
+			BrowserWindow = InArgs._AsyncCreation ? Singleton->CreateBrowserWindowAsync(Settings) : Singleton->CreateBrowserWindow(Settings);
 		}
 	}
 	
+	if (BrowserWindow.IsValid() && HasMouseTransparency())
+	{
+		BrowserWindow->SetHitTestAlphaEnabled(true);
+	}
 
 	IChromiumWebBrowserSingleton* Singleton = IChromiumWebBrowserModule::Get().GetSingleton();
 	if (Singleton)
@@ -124,6 +131,8 @@ void SChromiumWebBrowser::Construct(const FArguments& InArgs, const TSharedPtr<I
 		.OnSuppressContextMenu(InArgs._OnSuppressContextMenu)
 		.OnDragWindow(InArgs._OnDragWindow)
 		.BrowserFrameRate(InArgs._BrowserFrameRate)
+		.BufferedVideoDepth(InArgs._BufferedVideoDepth)
+		.MinBrowserFrameRate(InArgs._MinBrowserFrameRate)
 	];
 }
 
@@ -436,7 +445,14 @@ void SChromiumWebBrowser::Tick(const FGeometry& AllottedGeometry, const double I
 					int32 X = FMath::FloorToInt(LocalUV.X * GetTextureWidth());
 					int32 Y = FMath::FloorToInt(LocalUV.Y * GetTextureHeight());
 
-					FLinearColor Pixel = ReadTexturePixel(X, Y);
+					// Prefer the alpha the browser keeps from its software paints, only accelerated paints need a GPU readback.
+					FLinearColor Pixel = FLinearColor::Transparent;
+					uint8 Alpha = 0;
+					if (BrowserWindow.IsValid() && BrowserWindow->GetHitTestAlpha(FIntPoint(X, Y), Alpha))
+						Pixel.A = Alpha / 255.0f;
+					else
+						Pixel = ReadTexturePixel(X, Y);
+
 					if ((Pixel.A < TransparencyThreadshold && LastMousePixel.A >= TransparencyThreadshold)
 						|| (Pixel.A >= TransparencyThreadshold && LastMousePixel.A < TransparencyThreadshold))
 						LastMouseTime = 0.0f;
@@ -552,6 +568,14 @@ void SChromiumWebBrowser::SetParentWindow(TSharedPtr<SWindow> Window)
 	}
 }
 
+void SChromiumWebBrowser::SetRenderScale(float Scale, bool bAutomatic)
+{
+	if (BrowserWindow.IsValid())
+	{
+		BrowserWindow->SetRenderScale(Scale, bAutomatic);
+	}
+}
+
 bool SChromiumWebBrowser::HasMouseTransparency() const
 {
 	return bMouseTransparency && !bVirtualPointerTransparency;
@@ -665,6 +689,35 @@ TArray<FColor> SChromiumWebBrowser::ReadTexturePixels(int32 X, int32 Y, int32 Wi
 	return OutPixels;
 }
 
+void SChromiumWebBrowser::ReadTexturePixelsAsync(int32 X, int32 Y, int32 Width, int32 Height, FOnChromiumTexturePixelsRead Callback)
+{
+	FSlateShaderResource* Resource = BrowserWindow.IsValid() ? BrowserWindow->GetTexture() : nullptr;
+	FIntRect Rect;
+	if (Resource)
+	{
+		int32 ResourceWidth = (int32)Resource->GetWidth();
+		int32 ResourceHeight = (int32)Resource->GetHeight();
+
+		// Same clamping as ReadTexturePixels
+		X = FMath::Clamp(X, 0, ResourceWidth - 1);
+		Y = FMath::Clamp(Y, 0, ResourceHeight - 1);
+
+		Width = FMath::Clamp(Width, 1, ResourceWidth);
+		Width = Width - FMath::Max(X + Width - ResourceWidth, 0);
+
+		Height = FMath::Clamp(Height, 1, ResourceHeight);
+		Height = Height - FMath::Max(Y + Height - ResourceHeight, 0);
+
+		Rect = FIntRect(X, Y, X + Width, Y + Height);
+	}
+
+	if (!TextureReadback.IsValid())
+	{
+		TextureReadback = MakeUnique<FChromiumWebBrowserReadback>();
+	}
+	TextureReadback->Request(Resource, Rect, MoveTemp(Callback));
+}
+
 
 
 #undef LOCTEXT_NAMESPACE
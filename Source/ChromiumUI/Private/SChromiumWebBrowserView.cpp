@@ -8,6 +8,8 @@
 #include "Layout/WidgetPath.h"
 #include "Framework/Application/MenuStack.h"
 #include "Framework/Application/SlateApplication.h"
+#include "Widgets/SOverlay.h"
+#include "Widgets/Layout/SBox.h"
 #include "IChromiumWebBrowserDialog.h"
 #include "IChromiumWebBrowserWindow.h"
 #include "ChromiumWebBrowserViewport.h"
@@ -116,8 +118,11 @@ void SChromiumWebBrowserView::Construct(const FArguments& InArgs, const TSharedP
 			Settings.BrowserFrameRate = InArgs._BrowserFrameRate;
 			Settings.Context = InArgs._ContextSettings;
 			Settings.AltRetryDomains = InArgs._AltRetryDomains;
+			Settings.BufferedVideoDepth = InArgs._BufferedVideoDepth;
+			Settings.MinBrowserFrameRate = InArgs._MinBrowserFrameRate;
 
-			BrowserWindow = IChromiumWebBrowserModule::Get().GetSingleton()->CreateBrowserWindow(Settings);
+			IChromiumWebBrowserSingleton* Singleton = IChromiumWebBrowserModule::Get().GetSingleton();
+			BrowserWindow = InArgs._AsyncCreation ? Singleton->CreateBrowserWindowAsync(Settings) : Singleton->CreateBrowserWindow(Settings);
 		}
 	}
 
@@ -128,10 +133,32 @@ void SChromiumWebBrowserView::Construct(const FArguments& InArgs, const TSharedP
 #ifndef DUMMY_WEB_BROWSER
 		// The inner widget creation is handled by the WebBrowserWindow implementation.
 		const auto& BrowserWidgetRef = static_cast<FChromiumWebBrowserWindow*>(BrowserWindow.Get())->CreateWidget();
-		ChildSlot
-		[
-			BrowserWidgetRef
-		];
+		if (InArgs._Placeholder.Widget != SNullWidget::NullWidget)
+		{
+			ChildSlot
+			[
+				SNew(SOverlay)
+				+ SOverlay::Slot()
+				[
+					BrowserWidgetRef
+				]
+				+ SOverlay::Slot()
+				[
+					SNew(SBox)
+					.Visibility(this, &SChromiumWebBrowserView::GetPlaceholderVisibility)
+					[
+						InArgs._Placeholder.Widget
+					]
+				]
+			];
+		}
+		else
+		{
+			ChildSlot
+			[
+				BrowserWidgetRef
+			];
+		}
 		BrowserWidget = BrowserWidgetRef;
 #endif
 
@@ -163,7 +190,11 @@ void SChromiumWebBrowserView::Construct(const FArguments& InArgs, const TSharedP
 
 		if (!BrowserWindow->OnLoadUrl().IsBound())
 		{
-			BrowserWindow->OnLoadUrl().BindSP(this, &SChromiumWebBrowserView::HandleLoadUrl);
+			// Only bound when used: while it is, every resource request of the browser waits for the game thread
+			if (OnLoadUrl.IsBound())
+			{
+				BrowserWindow->OnLoadUrl().BindSP(this, &SChromiumWebBrowserView::HandleLoadUrl);
+			}
 		}
 		else
 		{
@@ -229,6 +260,23 @@ int32 SChromiumWebBrowserView::OnPaint(const FPaintArgs& Args, const FGeometry&
 	}
 
 	int32 Layer = SCompoundWidget::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+
+	if (BrowserWindow.IsValid())
+	{
+		// Let the browser know how much of it can actually be seen, so it can stop rendering when scrolled out of view or faded out.
+		// Widgets culled entirely are not painted at all, which the browser treats the same as no visible area.
+		bool bOverlapping = false;
+		const FSlateRect VisibleRect = AllottedGeometry.GetRenderBoundingRect().IntersectionWith(MyCullingRect, bOverlapping);
+		const bool bTransparent = InWidgetStyle.GetColorAndOpacityTint().A <= 0.0f;
+		BrowserWindow->ReportVisibleArea((bOverlapping && !bTransparent) ? VisibleRect.GetArea() : 0.0f);
+
+		const FVector2D LayoutSize = AllottedGeometry.GetLocalSize() * AllottedGeometry.Scale;
+		const float LayoutArea = LayoutSize.X * LayoutSize.Y;
+		if (LayoutArea > 0.0f)
+		{
+			BrowserWindow->ReportScreenCoverage(FMath::Sqrt(AllottedGeometry.GetRenderBoundingRect().GetArea() / LayoutArea));
+		}
+	}
 	
 	// Cache a reference to our parent window, if we didn't already reference it.
 	if (!SlateParentWindowPtr.IsValid())
@@ -385,6 +433,12 @@ bool SChromiumWebBrowserView::IsInitialized() const
 	return BrowserWindow.IsValid() &&  BrowserWindow->IsInitialized();
 }
 
+EVisibility SChromiumWebBrowserView::GetPlaceholderVisibility() const
+{
+	// Asynchronously created windows are only valid once CEF has created their browser
+	return BrowserWindow.IsValid() && BrowserWindow->IsValid() && BrowserWindow->IsInitialized() ? EVisibility::Collapsed : EVisibility::HitTestInvisible;
+}
+
 void SChromiumWebBrowserView::SetupParentWindowHandlers()
 {
 	if (!SlateParentWindowPtr.IsValid())
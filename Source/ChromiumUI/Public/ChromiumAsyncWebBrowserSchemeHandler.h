@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IChromiumWebBrowserSchemeHandler.h"
+
+class FChromiumAsyncSchemeState;
+
+/**
+ * The response of a FChromiumAsyncWebBrowserSchemeHandler, given to its task. Every method is safe to call from the task's thread.
+ */
+class CHROMIUMUI_API FChromiumAsyncSchemeResponse
+{
+public:
+	/** Sets the status code, 200 unless set. */
+	void SetStatusCode(int32 StatusCode);
+
+	void SetMimeType(const FString& MimeType);
+
+	/** Sets the size of the body in bytes, unknown unless set. */
+	void SetContentLength(int32 ContentLength);
+
+	/** Redirects the request to another url, no body should be written. */
+	void SetRedirect(const FString& Url);
+
+	void SetHeader(const FString& Key, const FString& Value);
+
+	/**
+	 * Makes the headers set so far available to the browser, which can then start on the response. The first Write, or the end
+	 * of the task, does so otherwise. Headers set afterwards are ignored.
+	 */
+	void SendHeaders();
+
+	/**
+	 * Queues part of the body. While the queue is full the task waits here until the browser has read from it, so a fast task
+	 * can not run far ahead of a slow page. If the browser reads nothing for the handler's stall timeout the request is canceled.
+	 *
+	 * @return false if the request has been canceled, in which case the task should return.
+	 */
+	bool Write(const uint8* Data, int32 Num);
+	bool Write(TArray<uint8>&& Chunk);
+
+	/** @return Whether the request has been canceled, long running tasks should check this and return if so. */
+	bool IsCanceled() const;
+
+private:
+	friend class FChromiumAsyncWebBrowserSchemeHandler;
+
+	explicit FChromiumAsyncSchemeResponse(const TSharedRef<FChromiumAsyncSchemeState, ESPMode::ThreadSafe>& InState);
+
+	TSharedRef<FChromiumAsyncSchemeState, ESPMode::ThreadSafe> State;
+};
+
+/**
+ * A scheme handler producing its response on the thread pool, for handlers that decode images, query game data or do anything
+ * else that must not hold up the browser's IO thread they are called on.
+ *
+ * Derived classes return the work to do for a request from CreateResponseTask. It runs on GThreadPool, setting the headers
+ * and writing the body through a FChromiumAsyncSchemeResponse. The body is handed to the browser through a bounded queue of
+ * chunks as it is written, and Cancel is passed on to the task through FChromiumAsyncSchemeResponse::IsCanceled and Write.
+ */
+class CHROMIUMUI_API FChromiumAsyncWebBrowserSchemeHandler
+	: public IChromiumWebBrowserSchemeHandler
+{
+public:
+	typedef TFunction<void(FChromiumAsyncSchemeResponse& Response)> FResponseTask;
+
+	/**
+	 * @param MaxQueuedBytes How much of the body may be written ahead of the browser reading it before Write waits.
+	 * @param StallTimeoutSeconds How long Write waits for the browser to read before canceling the request.
+	 */
+	explicit FChromiumAsyncWebBrowserSchemeHandler(int32 MaxQueuedBytes = 256 * 1024, float StallTimeoutSeconds = 30.0f);
+	virtual ~FChromiumAsyncWebBrowserSchemeHandler();
+
+	// IChromiumWebBrowserSchemeHandler interface
+	virtual bool ProcessRequest(const FString& Verb, const FString& Url, const FSimpleDelegate& OnHeadersReady) override;
+	virtual void GetResponseHeaders(IChromiumHeaders& OutHeaders) override;
+	virtual bool ReadResponse(uint8* OutBytes, int32 BytesToRead, int32& BytesRead, const FSimpleDelegate& OnMoreDataReady) override;
+	virtual void Cancel() override;
+
+protected:
+	/**
+	 * Creates the work producing the response to a request. Called on the browser's IO thread, so it should only gather what
+	 * the task needs. The task can outlive this handler once the request is canceled, so it must not capture this.
+	 *
+	 * @param Verb The verb used for the request (GET, PUT, POST, etc).
+	 * @param Url The full url of the request.
+	 * @return The task, or an empty function to turn the request down.
+	 */
+	virtual FResponseTask CreateResponseTask(const FString& Verb, const FString& Url) = 0;
+
+private:
+	TSharedRef<FChromiumAsyncSchemeState, ESPMode::ThreadSafe> State;
+};
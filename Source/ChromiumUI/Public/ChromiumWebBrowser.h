@@ -18,6 +18,7 @@ class CHROMIUMUI_API UChromiumWebBrowser : public UWidget
 public:
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUrlChanged, const FText&, Text);
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnBeforePopup, FString, URL, FString, Frame);
+	DECLARE_DYNAMIC_DELEGATE_OneParam(FOnTexturePixelsRead, const TArray<FColor>&, Pixels);
 
 	/**
 	 * Load the specified URL
@@ -95,6 +96,13 @@ public:
 	// Read an area of pixels from the browser texture.
 	UFUNCTION(BlueprintCallable, Category = "Web Browser|Textures")
 		TArray<FColor> ReadTexturePixels(int32 X, int32 Y, int32 Width, int32 Height);
+	// Read an area of pixels from the browser texture without stalling the game, OnRead is called a few frames later.
+	UFUNCTION(BlueprintCallable, Category = "Web Browser|Textures")
+		void ReadTexturePixelsAsync(int32 X, int32 Y, int32 Width, int32 Height, FOnTexturePixelsRead OnRead);
+
+	// Set the resolution the page is rendered at relative to the widget, lower values trade sharpness for rendering cost.
+	UFUNCTION(BlueprintCallable, Category = "Web Browser|Textures")
+	void SetRenderScale(float Scale, bool bAutomatic);
 
 	// Check if mouse transparency is enabled.
 	UFUNCTION(BlueprintPure, Category = "Web Browser|Transparency")
@@ -135,6 +143,18 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Behavior", meta = (UIMin = 1, UIMax = 60))
 	int32 FrameRate;
 
+	/** Resolution the page is rendered at relative to the widget's size. The texture is scaled back up when drawn. */
+	UPROPERTY(EditAnywhere, Category = "Behavior|Rendering", meta = (ClampMin = 0.1, ClampMax = 1))
+	float RenderScale;
+
+	/** Lower the render resolution further while the widget is shrunk on screen by a render transform. */
+	UPROPERTY(EditAnywhere, Category = "Behavior|Rendering")
+	bool bAutomaticRenderScale;
+
+	/** Create the browser without stalling the game thread. The page shows up a few frames later; calls made before then are replayed. */
+	UPROPERTY(EditAnywhere, Category = "Behavior")
+	bool bAsyncCreation;
+
 	UPROPERTY(EditAnywhere, meta = (DisplayName = "Enable Transparency"), Category = "Behavior|Mouse")
 	bool bEnableMouseTransparency;
 	UPROPERTY(EditAnywhere, meta = (DisplayName = "Transparency Threshold", UIMin = 0, UIMax = 1), Category = "Behavior|Mouse")
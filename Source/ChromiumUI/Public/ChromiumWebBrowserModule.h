@@ -8,6 +8,38 @@
 
 class IChromiumWebBrowserSingleton;
 
+/** Which pages Chromium keeps in render processes of their own. */
+enum class EChromiumSiteIsolation : uint8
+{
+	/** Chromium's default for the platform. */
+	Default,
+	/** Pages of different sites may share a render process, which saves memory when they are all trusted content. */
+	Disabled,
+	/** Every site gets render processes of its own. */
+	SitePerProcess,
+};
+
+/**
+ * How pages are assigned to render processes. These are process wide and are applied when CEF is started.
+ * The defaults are read from the [Browser] section of the engine ini: bProcessPerSite, RendererProcessLimit,
+ * SiteIsolation (Default, Disabled or SitePerProcess) and IsolatedOrigins.
+ */
+struct CHROMIUMUI_API FChromiumBrowserProcessModelSettings
+{
+	FChromiumBrowserProcessModelSettings();
+
+	/** Lets all browsers showing the same site share a single render process. */
+	bool bProcessPerSite;
+
+	/** Most render processes to start, 0 for Chromium's default. Past the limit new pages share existing processes. */
+	int32 RendererProcessLimit;
+
+	EChromiumSiteIsolation SiteIsolation;
+
+	/** Origins that always get render processes of their own, such as https://example.com. */
+	TArray<FString> IsolatedOrigins;
+};
+
 /**
  * WebBrowser initialization settings, can be used to override default init behaviors.
  */
@@ -21,6 +53,9 @@ public:
 
 	// The string which is appended to the browser's user-agent value.
 	FString ProductVersion;
+
+	// How pages are assigned to render processes.
+	FChromiumBrowserProcessModelSettings ProcessModel;
 };
 
 /**
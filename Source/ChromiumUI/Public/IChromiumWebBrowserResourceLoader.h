@@ -6,3 +6,63 @@
 
 typedef TMap<FString, FString> FChromiumContextRequestHeaders;
 DECLARE_DELEGATE_ThreeParams(FChromiumOnBeforeContextResourceLoadDelegate, FString /*Url*/, FString /*ResourceType*/, FChromiumContextRequestHeaders& /*AdditionalHeaders*/);
+
+/**
+ * Header changes applied to matching requests on the browser's IO thread, before the request goes out.
+ * Unlike the OnBeforeResourceLoad delegates, rules cost requests no round trip to the game thread.
+ */
+struct CHROMIUMUI_API FChromiumResourceRequestRule
+{
+	FChromiumResourceRequestRule()
+		: bRunDelegates(false)
+	{ }
+
+	/** Wildcard pattern, with * and ?, matched against the full request URL. Empty matches every request. */
+	FString UrlPattern;
+	/** Resource types the rule applies to, named as in FChromiumOnBeforeContextResourceLoadDelegate (e.g. XHR or MAIN_FRAME). Empty matches every type. */
+	TArray<FString> ResourceTypes;
+	/** Headers set on matching requests, replacing any value the request already has. */
+	FChromiumContextRequestHeaders SetHeaders;
+	/** Headers removed from matching requests. */
+	TArray<FString> RemoveHeaders;
+	/**
+	 * Whether matching requests are also passed to the OnBeforeResourceLoad delegates on the game thread.
+	 * Once any rule sets this, only requests matching such a rule reach the delegates. Without such a rule every request
+	 * does while a delegate is bound.
+	 */
+	bool bRunDelegates;
+};
+
+/** What a request filter rule does with the requests it matches. */
+enum class EChromiumRequestFilterAction : uint8
+{
+	/** Cancels the request. */
+	Block,
+	/** Sends the request to the rule's RedirectUrl instead. */
+	Redirect,
+	/** Exempts the request from every Block and Redirect rule. Together with a rule blocking everything, this allow-lists requests. */
+	Allow,
+};
+
+/**
+ * A request filter rule, see IChromiumWebBrowserSingleton::SetRequestFilter. A rule matches a request when every condition it
+ * sets holds. Matching ignores case. When no Allow rule matches, the first matching Block or Redirect rule decides.
+ */
+struct CHROMIUMUI_API FChromiumRequestFilterRule
+{
+	FChromiumRequestFilterRule()
+		: Action(EChromiumRequestFilterAction::Block)
+	{ }
+
+	EChromiumRequestFilterAction Action;
+	/** Domain the rule applies to, subdomains included: example.com matches cdn.example.com. A leading *. is ignored. Empty matches every host. */
+	FString Host;
+	/** Start of the path the rule applies to, such as /ads/. Empty matches every path. */
+	FString PathPrefix;
+	/** Text the path and query have to contain anywhere, such as /collect?. Empty to not require any. */
+	FString UrlContains;
+	/** Resource types the rule applies to, named as in FChromiumOnBeforeContextResourceLoadDelegate. Empty matches every type. */
+	TArray<FString> ResourceTypes;
+	/** Where a Redirect rule sends the requests it matches. */
+	FString RedirectUrl;
+};
@@ -6,6 +6,7 @@
 /**
  * This is the interface that needs to be implemented to handle a request made via a custom scheme.
  * It will be created by implementing an IWebBrowserSchemeHandlerFactory, given to the web browser singleton.
+ * Its methods are called on the browser's IO thread, handlers with slow work to do can derive from FChromiumAsyncWebBrowserSchemeHandler.
  */
 class CHROMIUMUI_API IChromiumWebBrowserSchemeHandler
 {
@@ -39,6 +39,7 @@ struct CHROMIUMUI_API FChromiumBrowserContextSettings
 		, bPersistSessionCookies(false)
 		, bIgnoreCertificateErrors(false)
 		, bEnableNetSecurityExpiration(true)
+		, bShareRenderProcesses(false)
 	{ }
 
 	FString Id;
@@ -47,7 +48,41 @@ struct CHROMIUMUI_API FChromiumBrowserContextSettings
 	bool bPersistSessionCookies;
 	bool bIgnoreCertificateErrors;
 	bool bEnableNetSecurityExpiration;
+	/**
+	 * Lets browsers in this context share render processes with browsers of the default context and of other sharing contexts,
+	 * so process-per-site and the renderer process limit apply across them. Chromium only shares processes within one storage
+	 * partition, so the context then uses the storage of the default context: AcceptLanguageList, CookieStorageLocation,
+	 * bPersistSessionCookies and bIgnoreCertificateErrors are ignored.
+	 */
+	bool bShareRenderProcesses;
 	FChromiumOnBeforeContextResourceLoadDelegate OnBeforeContextResourceLoad;
+	/** Header rules applied on the IO thread to requests of browsers in this context, after the global ones. */
+	TArray<FChromiumResourceRequestRule> RequestRules;
+	/** Requests of browsers in this context to block or redirect, see IChromiumWebBrowserSingleton::SetRequestFilter. */
+	TArray<FChromiumRequestFilterRule> RequestFilter;
+};
+
+/** Memory use of one of the processes the browser runtime started. */
+struct CHROMIUMUI_API FChromiumBrowserProcessMemory
+{
+	FChromiumBrowserProcessMemory()
+		: ProcessId(0)
+		, WorkingSetBytes(0)
+		, PrivateBytes(0)
+		, CpuSeconds(0.0)
+	{ }
+
+	uint32 ProcessId;
+	/** Executable name. */
+	FString Name;
+	/** Chromium process type, such as renderer or gpu-process. */
+	FString Type;
+	/** Physical memory currently mapped by the process. */
+	uint64 WorkingSetBytes;
+	/** Memory that belongs to the process alone. */
+	uint64 PrivateBytes;
+	/** Processor time the process has used since it started. */
+	double CpuSeconds;
 };
 
 
@@ -65,6 +100,8 @@ struct CHROMIUMUI_API FChromiumCreateBrowserWindowSettings
 		, BrowserFrameRate(24)
 		, Context()
 		, AltRetryDomains()
+		, BufferedVideoDepth(INDEX_NONE)
+		, MinBrowserFrameRate(INDEX_NONE)
 	{ }
 
 	void* OSWindowHandle;
@@ -77,6 +114,10 @@ struct CHROMIUMUI_API FChromiumCreateBrowserWindowSettings
 	int BrowserFrameRate;
 	TOptional<FChromiumBrowserContextSettings> Context;
 	TArray<FString> AltRetryDomains;
+	/** Number of frames buffered and uploaded at most once per engine tick, 0 to disable or INDEX_NONE to follow r.CEFBufferedVideoDepth. */
+	int32 BufferedVideoDepth;
+	/** Lowest frame rate the browser is throttled to while idle when r.CEFFrameRateGovernor is on, INDEX_NONE to follow r.CEFIdleFrameRate. BrowserFrameRate is the upper bound. */
+	int32 MinBrowserFrameRate;
 };
 
 /**
@@ -132,6 +173,26 @@ public:
 
 	virtual TSharedPtr<IChromiumWebBrowserWindow> CreateBrowserWindow(const FChromiumCreateBrowserWindowSettings& Settings) = 0;
 
+	/**
+	 * Create a new web browser window without waiting for the browser to be created.
+	 *
+	 * The window is returned straight away and can be handed to a widget, navigated and bound to. It only becomes
+	 * valid once the browser exists, which is when the navigations and bindings requested until then are replayed in order.
+	 * Platforms that cannot create browsers asynchronously fall back to CreateBrowserWindow.
+	 *
+	 * @param Settings Settings for setting up the new browser window
+	 * @return New Web Browser Window Interface (may be null if not supported)
+	 */
+	virtual TSharedPtr<IChromiumWebBrowserWindow> CreateBrowserWindowAsync(const FChromiumCreateBrowserWindowSettings& Settings) = 0;
+
+	/**
+	 * Starts the browser runtime ahead of the first browser, e.g. while a loading screen is up.
+	 *
+	 * Only needed when [Browser] bLazyInitialize defers startup until the first browser window or context is created.
+	 * CEF's files are located on a worker thread and CEF itself is started on a later tick. Does nothing if it is already running.
+	 */
+	virtual void WarmUp() = 0;
+
 #if	BUILD_EMBEDDED_APP
 	virtual TSharedPtr<IWebBrowserWindow> CreateNativeBrowserProxy() = 0;
 #endif
@@ -159,6 +220,43 @@ public:
 
 	// @return the application cache dir where the cookies are stored
 	virtual FString ApplicationCacheDir() const = 0;
+
+	/**
+	 * Reports the memory use of the render, GPU and utility processes of the browser runtime, to check the effect of the process model.
+	 * The browser process is the application itself and is not included.
+	 *
+	 * @param OutProcesses Receives one entry per process, empty if the runtime is not running.
+	 */
+	virtual void GetProcessMemoryReport(TArray<FChromiumBrowserProcessMemory>& OutProcesses) const = 0;
+
+	/**
+	 * Sets header rules applied to the requests of every browser, replacing those set before. Rules run on the browser's IO
+	 * thread, so requests they cover no longer wait for the game thread the way they do for the OnBeforeResourceLoad delegates.
+	 * The rules of a request's context, FChromiumBrowserContextSettings::RequestRules, are applied after these.
+	 *
+	 * @param Rules The rules, applied in order.
+	 */
+	virtual void SetResourceRequestRules(const TArray<FChromiumResourceRequestRule>& Rules) = 0;
+
+	/**
+	 * Replaces the request filter of a browser context. The rules are compiled once and checked on the browser's IO thread
+	 * before each request is made, so blocked and redirected requests never involve the game thread. Hit counts start over.
+	 *
+	 * @param ContextId The context, as registered with RegisterContext. Unset for browsers created without a context.
+	 * @param Rules The rules, an empty array removes the filter.
+	 * @return false if there is no context with that id.
+	 */
+	virtual bool SetRequestFilter(const TOptional<FString>& ContextId, const TArray<FChromiumRequestFilterRule>& Rules) = 0;
+
+	/**
+	 * Reports how many requests each rule of a request filter has decided since the rules were set.
+	 *
+	 * @param ContextId The context, unset for browsers created without a context.
+	 * @param OutHits Receives one count per rule, in the order the rules were given.
+	 * @return false if there is no context with that id.
+	 */
+	virtual bool GetRequestFilterHits(const TOptional<FString>& ContextId, TArray<uint64>& OutHits) const = 0;
+
 	/**
 	 * Registers a custom scheme handler factory, for a given scheme and domain. The domain is ignored if the scheme is not a browser built in scheme
 	 * and all requests will go through this factory.
@@ -174,6 +272,28 @@ public:
 	 */
 	virtual bool UnregisterSchemeHandlerFactory(IChromiumWebBrowserSchemeHandlerFactory* WebBrowserSchemeHandlerFactory) = 0;
 
+	/**
+	 * Serves a scheme and domain from a packed web UI archive, as written by the ChromiumUI.PackArchive console command.
+	 * The archive is memory mapped and its files are read straight into the browser's buffers, with their MIME types taken
+	 * from the archive's index and Range requests served by seeking. [Browser] UIArchive in the engine ini registers one at
+	 * startup, on UIArchiveScheme (ui by default) and UIArchiveDomain.
+	 *
+	 * Pages loaded from a custom scheme only resolve relative URLs if the scheme is registered as standard in every browser
+	 * process, otherwise serve the archive on a built in scheme such as https with a domain of its own.
+	 *
+	 * @param Scheme                            The scheme name to handle.
+	 * @param Domain                            The domain name to handle. Ignored if the scheme is not a browser built in scheme.
+	 * @param ArchiveFilename                   The archive, replacing any served on the same scheme and domain.
+	 * @return false if the archive could not be opened.
+	 */
+	virtual bool RegisterArchiveSchemeHandler(FString Scheme, FString Domain, const FString& ArchiveFilename) = 0;
+
+	/**
+	 * Stops serving a scheme and domain from an archive. Browsers of contexts registered before keep serving it.
+	 * @return false if no archive was served there.
+	 */
+	virtual bool UnregisterArchiveSchemeHandler(const FString& Scheme, const FString& Domain) = 0;
+
 	/**
 	 * Enable or disable CTRL/CMD-SHIFT-I shortcut to show the Chromium Dev tools window.
 	 * The value defaults to true on debug builds, otherwise false.
@@ -40,6 +40,65 @@ struct FChromiumWebNavigationRequest
 	bool bIsExplicitTransition;
 };
 
+/** Game thread time a browser spent in one kind of callback, see FChromiumWebBrowserWindowStats. */
+struct FChromiumWebBrowserCallbackStats
+{
+	FChromiumWebBrowserCallbackStats()
+		: CallsPerSecond(0.0f)
+		, MillisecondsPerSecond(0.0f)
+	{ }
+
+	/** Paint, Navigation, ResourceLoad, JSBridge, Console or Other. */
+	FName Callback;
+	float CallsPerSecond;
+	float MillisecondsPerSecond;
+};
+
+/**
+ * What a browser window currently costs. Rates are measured over the last second or so.
+ * The render process figures are refreshed in the background every r.CEFTelemetryProcessInterval seconds and are 0 until
+ * the process is known. Browsers in processes of their own report it alone, browsers sharing a process all report it whole.
+ */
+struct FChromiumWebBrowserWindowStats
+{
+	FChromiumWebBrowserWindowStats()
+		: PaintsPerSecond(0.0f)
+		, UploadedBytesPerSecond(0.0f)
+		, TextureMemoryBytes(0)
+		, RenderProcessId(0)
+		, RenderProcessMemoryBytes(0)
+		, RenderProcessCpuPercent(0.0f)
+		, JSMessagesPerSecond(0.0f)
+		, ResourceRequestsInFlight(0)
+		, ResourceHopsPerSecond(0.0f)
+		, ResourceHopMilliseconds(0.0f)
+		, GameThreadMillisecondsPerSecond(0.0f)
+	{ }
+
+	float PaintsPerSecond;
+	/** Pixel data submitted for texture upload. */
+	float UploadedBytesPerSecond;
+	/** Size of the textures the page and its popups are drawn into. */
+	uint64 TextureMemoryBytes;
+	/** Operating system id of the process rendering the main frame. */
+	uint32 RenderProcessId;
+	/** Physical memory used by the render process. */
+	uint64 RenderProcessMemoryBytes;
+	/** Processor time used by the render process, 100 for a full core. */
+	float RenderProcessCpuPercent;
+	/** Messages passed between the page scripts and bound objects, both ways. */
+	float JSMessagesPerSecond;
+	int32 ResourceRequestsInFlight;
+	/** Resource requests that waited for the game thread, for a delegate or a content override, instead of continuing on the IO thread. */
+	float ResourceHopsPerSecond;
+	/** Average time those requests waited for the game thread. */
+	float ResourceHopMilliseconds;
+	/** Time spent in all browser callbacks on the game thread. */
+	float GameThreadMillisecondsPerSecond;
+	/** The same time broken down by kind of callback. */
+	TArray<FChromiumWebBrowserCallbackStats> Callbacks;
+};
+
 /**
  * Interface for dealing with a Web Browser window
  */
@@ -234,11 +293,19 @@ public:
 	virtual void OnCaptureLost() = 0;
 
 	/**
-	 * Returns true if the browser can navigate backwards.
+	 * Returns true if the browser can navigate backwards. For a browser taken from the pool this leaves out the about:blank entry
+	 * it was created on, see GoBack.
 	 */
 	virtual bool CanGoBack() const = 0;
 
-	/** Navigate backwards. */
+	/**
+	 * Navigate backwards. Once the browser of a discarded window has been recreated, history older than its first page is
+	 * walked by replacing the page from script, which does nothing while the page is loading or if its script has stopped.
+	 *
+	 * A browser taken from the pool (BrowserPoolSize in the [Browser] section of the engine ini) keeps the about:blank entry it
+	 * was created on, as CEF can not clear a browser's history. CanGoBack and GoBack skip it, but the page's own history.back()
+	 * from its first entry still lands on about:blank.
+	 */
 	virtual void GoBack() = 0;
 
 	/**
@@ -246,7 +313,7 @@ public:
 	 */
 	virtual bool CanGoForward() const = 0;
 
-	/** Navigate forwards. */
+	/** Navigate forwards. The history of a discarded window is walked as described for GoBack. */
 	virtual void GoForward() = 0;
 
 	/**
@@ -319,6 +386,53 @@ public:
 	virtual void SetParentWindow(TSharedPtr<class SWindow> Window) = 0;
 
 	virtual void CheckTickActivity() {};
+
+	/**
+	 * Report how much of the browser was visible when its widget was painted.
+	 * Browsers whose widget stays clipped away or fully transparent for a while stop rendering until they are visible again.
+	 *
+	 * @param VisibleArea The area of the widget left after clipping, in Slate units, or 0 if it was painted fully transparent.
+	 */
+	virtual void ReportVisibleArea(float VisibleArea) {}
+
+	/**
+	 * Set the resolution the page is rendered at relative to the size it is displayed at. The texture is scaled back up when drawn.
+	 *
+	 * @param Scale Fraction of the displayed resolution to render at, from 0 to 1.
+	 * @param bAutomatic Whether to lower the resolution further when the widget is shrunk on screen by a render transform.
+	 */
+	virtual void SetRenderScale(float Scale, bool bAutomatic) {}
+
+	/**
+	 * Report how large the widget is drawn on screen relative to its layout size, used by automatic render scale.
+	 *
+	 * @param Coverage The on screen size divided by the layout size, 1 if the widget is not scaled by a render transform.
+	 */
+	virtual void ReportScreenCoverage(float Coverage) {}
+
+	/**
+	 * Enable or disable keeping a CPU side copy of the page alpha for hit testing transparent browsers.
+	 *
+	 * @param bEnable Whether GetHitTestAlpha should be kept up to date as the page paints.
+	 */
+	virtual void SetHitTestAlphaEnabled(bool bEnable) {}
+
+	/**
+	 * Get the alpha of the painted page around a texture pixel, without reading the texture back from the GPU.
+	 *
+	 * @param Pixel The pixel position in the browser texture.
+	 * @param OutAlpha The highest alpha of the small block of pixels containing Pixel.
+	 * @return false if no alpha is available, e.g. hit testing was not enabled or nothing has been painted yet.
+	 */
+	virtual bool GetHitTestAlpha(FIntPoint Pixel, uint8& OutAlpha) const { return false; }
+
+	/**
+	 * Get what the browser currently costs in paints, uploads, memory, render process use and game thread time.
+	 *
+	 * @param OutStats Receives the figures.
+	 * @return false if the platform does not measure them.
+	 */
+	virtual bool GetStats(FChromiumWebBrowserWindowStats& OutStats) const { return false; }
 public:
 
 	/** A delegate that is invoked when the loading state of a document changed. */
@@ -390,7 +504,10 @@ public:
 	DECLARE_DELEGATE(FOnDismissAllDialogs)
 	virtual FOnDismissAllDialogs& OnDismissAllDialogs() = 0;
 
-	/** Should return true if this dialog wants to suppress the context menu */
+	/**
+	 * Should return true if this dialog wants to suppress the context menu.
+	 * While CEF runs its own UI thread the answer is taken once per tick, a change shows from the next tick on.
+	 */
 	DECLARE_DELEGATE_RetVal(bool, FOnSuppressContextMenu);
 	virtual FOnSuppressContextMenu& OnSuppressContextMenu() = 0;
 
@@ -13,10 +13,12 @@ class IChromiumWebBrowserAdapter;
 class IChromiumWebBrowserDialog;
 class IChromiumWebBrowserWindow;
 class SEditableTextBox;
+class FChromiumWebBrowserReadback;
 struct FChromiumWebNavigationRequest;
 enum class EChromiumWebBrowserDialogEventResponse;
 
 DECLARE_DELEGATE_RetVal(bool, FOnSuppressContextMenu);
+DECLARE_DELEGATE_OneParam(FOnChromiumTexturePixelsRead, const TArray<FColor>& /*Pixels*/);
 
 class CHROMIUMUI_API SChromiumWebBrowser
 	: public SCompoundWidget
@@ -39,6 +41,9 @@ public:
 		, _BrowserFrameRate(24)
 		, _PopupMenuMethod(TOptional<EPopupMethod>())
 		, _ViewportSize(FVector2D::ZeroVector)
+		, _BufferedVideoDepth(INDEX_NONE)
+		, _MinBrowserFrameRate(INDEX_NONE)
+		, _AsyncCreation(false)
 	{ 
 		_Visibility = EVisibility::SelfHitTestInvisible;
 	}
@@ -88,6 +93,15 @@ public:
 		/** Desired size of the web browser viewport. */
 		SLATE_ATTRIBUTE(FVector2D, ViewportSize);
 
+		/** Number of browser frames buffered and uploaded at most once per engine tick. 0 disables buffering, INDEX_NONE uses the r.CEFBufferedVideoDepth default. */
+		SLATE_ARGUMENT(int32, BufferedVideoDepth)
+
+		/** Lowest frame rate the browser is throttled to while idle when r.CEFFrameRateGovernor is on. INDEX_NONE uses the r.CEFIdleFrameRate default. */
+		SLATE_ARGUMENT(int32, MinBrowserFrameRate)
+
+		/** Whether to create the browser without blocking the game thread. The initial throbber is shown until it exists. */
+		SLATE_ARGUMENT(bool, AsyncCreation)
+
 		/** Called when document loading completed. */
 		SLATE_EVENT(FSimpleDelegate, OnLoadCompleted)
 
@@ -248,6 +262,14 @@ public:
 	/** Set parent SWindow for this browser. */
 	void SetParentWindow(TSharedPtr<SWindow> Window);
 
+	/**
+	 * Set the resolution the page is rendered at relative to the size of this widget.
+	 *
+	 * @param Scale Fraction of the widget's resolution to render at, from 0 to 1.
+	 * @param bAutomatic Whether to lower the resolution further while the widget is shrunk by a render transform.
+	 */
+	void SetRenderScale(float Scale, bool bAutomatic);
+
 private:
 
 	/** Navigate backwards. */
@@ -345,4 +367,16 @@ public:
 
 	FColor ReadTexturePixel(int32 X, int32 Y) const;
 	TArray<FColor> ReadTexturePixels(int32 X, int32 Y, int32 Width, int32 Height) const;
+
+	/**
+	 * Reads an area of pixels from the browser texture without waiting for the rendering thread.
+	 * Reads made during the same frame share a single copy from the GPU.
+	 *
+	 * @param Callback Invoked on the game thread a few frames later with the pixels, or an empty array if they could not be read.
+	 */
+	void ReadTexturePixelsAsync(int32 X, int32 Y, int32 Width, int32 Height, FOnChromiumTexturePixelsRead Callback);
+
+private:
+	/** Pending asynchronous texture reads, created on first use. */
+	TUniquePtr<FChromiumWebBrowserReadback> TextureReadback;
 };
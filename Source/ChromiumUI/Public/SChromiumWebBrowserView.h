@@ -56,6 +56,9 @@ public:
 		, _ContextSettings()
 		, _AltRetryDomains(TArray<FString>())
 		, _ViewportSize(FVector2D::ZeroVector)
+		, _BufferedVideoDepth(INDEX_NONE)
+		, _MinBrowserFrameRate(INDEX_NONE)
+		, _AsyncCreation(false)
 	{ }
 
 		/** A reference to the parent window. */
@@ -94,6 +97,18 @@ public:
 		/** Desired size of the web browser viewport. */
 		SLATE_ATTRIBUTE(FVector2D, ViewportSize);
 
+		/** Number of browser frames buffered and uploaded at most once per engine tick. 0 disables buffering, INDEX_NONE uses the r.CEFBufferedVideoDepth default. */
+		SLATE_ARGUMENT(int32, BufferedVideoDepth)
+
+		/** Lowest frame rate the browser is throttled to while idle when r.CEFFrameRateGovernor is on. INDEX_NONE uses the r.CEFIdleFrameRate default. */
+		SLATE_ARGUMENT(int32, MinBrowserFrameRate)
+
+		/** Whether to create the browser without blocking the game thread. Navigations and bindings are queued until it exists. */
+		SLATE_ARGUMENT(bool, AsyncCreation)
+
+		/** Optional widget shown in place of the page until the browser has painted its first frame. */
+		SLATE_NAMED_SLOT(FArguments, Placeholder)
+
 		/** Called when document loading completed. */
 		SLATE_EVENT(FSimpleDelegate, OnLoadCompleted)
 
@@ -344,6 +359,9 @@ private:
 	bool HandleDrag(const FPointerEvent& MouseEvent);
 
 	TOptional<FSlateRenderTransform> GetPopupRenderTransform() const;
+
+	/** Keeps the placeholder up until the browser has been created and painted. */
+	EVisibility GetPlaceholderVisibility() const;
 private:
 
 	/** Interface for dealing with a web browser window. */